@@ -0,0 +1,352 @@
+#include "batchEval.h"
+#include "simd.h"
+
+namespace
+{
+	const CardMask DIAMONDS = FIRST_SUIT_MASK << 2;	//suitMask(Card::D)
+	const int SEVEN_OF_DIAMONDS = 26;
+	const int HALF_OF_CARDS = NUM_OF_CARDS / 2;
+	const int HALF_OF_DIAMONDS = NUM_OF_RANKS / 2;
+	const int HALF_OF_SEVENS = 2;
+
+	inline int32_t sign(int32_t x)
+	{
+		return (x > 0) - (x < 0);
+	}
+
+	// bit 4 * (rank - 1) for every rank the hand holds
+	inline uint64_t handRanks(CardMask hand)
+	{
+		uint64_t ranks = hand | (hand >> 1);
+		ranks |= ranks >> 2;
+		return ranks & FIRST_SUIT_MASK;
+	}
+
+	// the reachable sums 1..MAX_RANK moved to the same bits (bit s -> bit 4 * (s - 1))
+	inline uint64_t sumRanks(uint16_t sums)
+	{
+		uint64_t x = (sums >> 1) & 0x3FF;
+		x = (x | (x << 24)) & 0x000000FF000000FFULL;
+		x = (x | (x << 12)) & 0x000F000F000F000FULL;
+		x = (x | (x << 6)) & 0x0303030303030303ULL;
+		return (x | (x << 3)) & 0x1111111111111111ULL;
+	}
+}
+
+int32_t BatchEval::scoreDiff(CardMask p1Pile, int32_t sweepDiff)
+{
+	int32_t sevens = sign(countCards(p1Pile & rankMask(7)) - HALF_OF_SEVENS);
+	int32_t sixes = sign(countCards(p1Pile & rankMask(6)) - HALF_OF_SEVENS);
+	return sign(countCards(p1Pile) - HALF_OF_CARDS) + sign(countCards(p1Pile & DIAMONDS) - HALF_OF_DIAMONDS) +
+		(sevens != 0 ? sevens : sixes) + ((p1Pile >> SEVEN_OF_DIAMONDS) & 1 ? 1 : -1) + sweepDiff;
+}
+
+uint8_t BatchEval::hasCapture(CardMask hand, uint16_t boardSums)
+{
+	return (handRanks(hand) & sumRanks(boardSums)) != 0 ? 1 : 0;
+}
+
+#if defined(SHKUBA_SIMD_AVX2)
+
+namespace
+{
+	const int SCORE_STEP = 8;
+	const int CAPTURE_STEP = 4;
+
+	// popcount of every 64 bit lane: a nibble lookup per byte, then the bytes of a lane summed
+	inline __m256i popcount64(__m256i v)
+	{
+		const __m256i table = _mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4);
+		const __m256i low = _mm256_set1_epi8(0x0F);
+		__m256i counts = _mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, low)),
+			_mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), low)));
+		return _mm256_sad_epu8(counts, _mm256_setzero_si256());
+	}
+
+	// the low halves of the 64 bit lanes of a (states 0..3) and b (4..7) as 8 ints: 0 4 1 5 2 6 3 7
+	inline __m256i interleave(__m256i a, __m256i b)
+	{
+		return _mm256_or_si256(a, _mm256_slli_epi64(b, 32));
+	}
+
+	inline __m256i counts(__m256i a, __m256i b, __m256i mask)
+	{
+		return interleave(popcount64(_mm256_and_si256(a, mask)), popcount64(_mm256_and_si256(b, mask)));
+	}
+
+	inline __m256i signOf(__m256i x, int middle)
+	{
+		__m256i m = _mm256_set1_epi32(middle);
+		return _mm256_sub_epi32(_mm256_cmpgt_epi32(m, x), _mm256_cmpgt_epi32(x, m));
+	}
+}
+
+void BatchEval::scoreDiffs(const CardMask* p1Piles, const int32_t* sweepDiffs, int count, int32_t* out)
+{
+	const __m256i toInterleaved = _mm256_setr_epi32(0, 4, 1, 5, 2, 6, 3, 7);
+	const __m256i toOrder = _mm256_setr_epi32(0, 2, 4, 6, 1, 3, 5, 7);
+	const __m256i all = _mm256_set1_epi64x(static_cast<int64_t>(FULL_DECK_MASK));
+	const __m256i diamonds = _mm256_set1_epi64x(static_cast<int64_t>(DIAMONDS));
+	const __m256i sevens = _mm256_set1_epi64x(static_cast<int64_t>(rankMask(7)));
+	const __m256i sixes = _mm256_set1_epi64x(static_cast<int64_t>(rankMask(6)));
+	const __m256i one = _mm256_set1_epi32(1);
+	int i = 0;
+	for (; i + SCORE_STEP <= count; i += SCORE_STEP)
+	{
+		__m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p1Piles + i));
+		__m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(p1Piles + i + 4));
+		__m256i sevensSign = signOf(counts(a, b, sevens), HALF_OF_SEVENS);
+		__m256i sixesSign = signOf(counts(a, b, sixes), HALF_OF_SEVENS);
+		__m256i diff = _mm256_add_epi32(signOf(counts(a, b, all), HALF_OF_CARDS), signOf(counts(a, b, diamonds), HALF_OF_DIAMONDS));
+		diff = _mm256_add_epi32(diff, _mm256_add_epi32(sevensSign, _mm256_and_si256(_mm256_cmpeq_epi32(sevensSign, _mm256_setzero_si256()), sixesSign)));
+		__m256i sevenOfDiamonds = _mm256_and_si256(interleave(_mm256_srli_epi64(a, SEVEN_OF_DIAMONDS), _mm256_srli_epi64(b, SEVEN_OF_DIAMONDS)), one);
+		diff = _mm256_add_epi32(diff, _mm256_sub_epi32(_mm256_add_epi32(sevenOfDiamonds, sevenOfDiamonds), one));
+		__m256i sweeps = _mm256_permutevar8x32_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(sweepDiffs + i)), toInterleaved);
+		diff = _mm256_add_epi32(diff, sweeps);
+		_mm256_storeu_si256(reinterpret_cast<__m256i*>(out + i), _mm256_permutevar8x32_epi32(diff, toOrder));
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = scoreDiff(p1Piles[i], sweepDiffs[i]);
+	}
+}
+
+void BatchEval::hasCapture(const CardMask* hands, const uint16_t* boardSums, int count, uint8_t* out)
+{
+	const __m256i firstSuit = _mm256_set1_epi64x(static_cast<int64_t>(FIRST_SUIT_MASK));
+	const __m256i tenBits = _mm256_set1_epi64x(0x3FF);
+	int i = 0;
+	for (; i + CAPTURE_STEP <= count; i += CAPTURE_STEP)
+	{
+		__m256i hand = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(hands + i));
+		__m256i ranks = _mm256_or_si256(hand, _mm256_srli_epi64(hand, 1));
+		ranks = _mm256_and_si256(_mm256_or_si256(ranks, _mm256_srli_epi64(ranks, 2)), firstSuit);
+
+		__m256i x = _mm256_and_si256(_mm256_srli_epi64(_mm256_cvtepu16_epi64(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(boardSums + i))), 1), tenBits);
+		x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 24)), _mm256_set1_epi64x(0x000000FF000000FFLL));
+		x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 12)), _mm256_set1_epi64x(0x000F000F000F000FLL));
+		x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 6)), _mm256_set1_epi64x(0x0303030303030303LL));
+		x = _mm256_and_si256(_mm256_or_si256(x, _mm256_slli_epi64(x, 3)), _mm256_set1_epi64x(0x1111111111111111LL));
+
+		__m256i none = _mm256_cmpeq_epi64(_mm256_and_si256(ranks, x), _mm256_setzero_si256());
+		int noneBits = _mm256_movemask_pd(_mm256_castsi256_pd(none));
+		for (int lane = 0; lane < CAPTURE_STEP; ++lane)
+		{
+			out[i + lane] = ((noneBits >> lane) & 1) ? 0 : 1;
+		}
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = hasCapture(hands[i], boardSums[i]);
+	}
+}
+
+const char* BatchEval::getInstructionSet()
+{
+	return "avx2";
+}
+
+#elif defined(SHKUBA_SIMD_SSE2)
+
+namespace
+{
+	const int SCORE_STEP = 4;
+	const int CAPTURE_STEP = 2;
+
+	// popcount of both 64 bit lanes: bit slicing down to byte counts, then the bytes of a lane summed
+	inline __m128i popcount64(__m128i v)
+	{
+		v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi64(v, 1), _mm_set1_epi8(0x55)));
+		v = _mm_add_epi8(_mm_and_si128(v, _mm_set1_epi8(0x33)), _mm_and_si128(_mm_srli_epi64(v, 2), _mm_set1_epi8(0x33)));
+		v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi64(v, 4)), _mm_set1_epi8(0x0F));
+		return _mm_sad_epu8(v, _mm_setzero_si128());
+	}
+
+	// the low halves of the 64 bit lanes of a (states 0, 1) and b (2, 3) as 4 ints: 0 2 1 3
+	inline __m128i interleave(__m128i a, __m128i b)
+	{
+		return _mm_or_si128(a, _mm_slli_epi64(b, 32));
+	}
+
+	inline __m128i counts(__m128i a, __m128i b, __m128i mask)
+	{
+		return interleave(popcount64(_mm_and_si128(a, mask)), popcount64(_mm_and_si128(b, mask)));
+	}
+
+	inline __m128i signOf(__m128i x, int middle)
+	{
+		__m128i m = _mm_set1_epi32(middle);
+		return _mm_sub_epi32(_mm_cmpgt_epi32(m, x), _mm_cmpgt_epi32(x, m));
+	}
+
+	inline __m128i set64(uint64_t value)
+	{
+		return _mm_set1_epi64x(static_cast<int64_t>(value));
+	}
+}
+
+void BatchEval::scoreDiffs(const CardMask* p1Piles, const int32_t* sweepDiffs, int count, int32_t* out)
+{
+	const __m128i all = set64(FULL_DECK_MASK);
+	const __m128i diamonds = set64(DIAMONDS);
+	const __m128i sevens = set64(rankMask(7));
+	const __m128i sixes = set64(rankMask(6));
+	const __m128i one = _mm_set1_epi32(1);
+	int i = 0;
+	for (; i + SCORE_STEP <= count; i += SCORE_STEP)
+	{
+		__m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1Piles + i));
+		__m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p1Piles + i + 2));
+		__m128i sevensSign = signOf(counts(a, b, sevens), HALF_OF_SEVENS);
+		__m128i sixesSign = signOf(counts(a, b, sixes), HALF_OF_SEVENS);
+		__m128i diff = _mm_add_epi32(signOf(counts(a, b, all), HALF_OF_CARDS), signOf(counts(a, b, diamonds), HALF_OF_DIAMONDS));
+		diff = _mm_add_epi32(diff, _mm_add_epi32(sevensSign, _mm_and_si128(_mm_cmpeq_epi32(sevensSign, _mm_setzero_si128()), sixesSign)));
+		__m128i sevenOfDiamonds = _mm_and_si128(interleave(_mm_srli_epi64(a, SEVEN_OF_DIAMONDS), _mm_srli_epi64(b, SEVEN_OF_DIAMONDS)), one);
+		diff = _mm_add_epi32(diff, _mm_sub_epi32(_mm_add_epi32(sevenOfDiamonds, sevenOfDiamonds), one));
+		__m128i sweeps = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(sweepDiffs + i)), _MM_SHUFFLE(3, 1, 2, 0));
+		diff = _mm_add_epi32(diff, sweeps);
+		_mm_storeu_si128(reinterpret_cast<__m128i*>(out + i), _mm_shuffle_epi32(diff, _MM_SHUFFLE(3, 1, 2, 0)));
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = scoreDiff(p1Piles[i], sweepDiffs[i]);
+	}
+}
+
+void BatchEval::hasCapture(const CardMask* hands, const uint16_t* boardSums, int count, uint8_t* out)
+{
+	int i = 0;
+	for (; i + CAPTURE_STEP <= count; i += CAPTURE_STEP)
+	{
+		__m128i hand = _mm_loadu_si128(reinterpret_cast<const __m128i*>(hands + i));
+		__m128i ranks = _mm_or_si128(hand, _mm_srli_epi64(hand, 1));
+		ranks = _mm_and_si128(_mm_or_si128(ranks, _mm_srli_epi64(ranks, 2)), set64(FIRST_SUIT_MASK));
+
+		__m128i x = _mm_set_epi64x((boardSums[i + 1] >> 1) & 0x3FF, (boardSums[i] >> 1) & 0x3FF);
+		x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi64(x, 24)), set64(0x000000FF000000FFULL));
+		x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi64(x, 12)), set64(0x000F000F000F000FULL));
+		x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi64(x, 6)), set64(0x0303030303030303ULL));
+		x = _mm_and_si128(_mm_or_si128(x, _mm_slli_epi64(x, 3)), set64(0x1111111111111111ULL));
+
+		// a lane is empty when both its 32 bit halves are
+		int zeroHalves = _mm_movemask_ps(_mm_castsi128_ps(_mm_cmpeq_epi32(_mm_and_si128(ranks, x), _mm_setzero_si128())));
+		out[i] = (zeroHalves & 3) == 3 ? 0 : 1;
+		out[i + 1] = (zeroHalves & 12) == 12 ? 0 : 1;
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = hasCapture(hands[i], boardSums[i]);
+	}
+}
+
+const char* BatchEval::getInstructionSet()
+{
+	return "sse2";
+}
+
+#elif defined(SHKUBA_SIMD_NEON)
+
+namespace
+{
+	const int SCORE_STEP = 4;
+	const int CAPTURE_STEP = 2;
+
+	// the popcounts of the masks a (states 0, 1) and b (2, 3) as 4 ints, in order
+	inline int32x4_t counts(uint64x2_t a, uint64x2_t b, uint64x2_t mask)
+	{
+		uint64x2_t countsA = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(vandq_u64(a, mask))))));
+		uint64x2_t countsB = vpaddlq_u32(vpaddlq_u16(vpaddlq_u8(vcntq_u8(vreinterpretq_u8_u64(vandq_u64(b, mask))))));
+		return vreinterpretq_s32_u32(vcombine_u32(vmovn_u64(countsA), vmovn_u64(countsB)));
+	}
+
+	inline int32x4_t signOf(int32x4_t x, int middle)
+	{
+		int32x4_t m = vdupq_n_s32(middle);
+		return vsubq_s32(vreinterpretq_s32_u32(vcgtq_s32(m, x)), vreinterpretq_s32_u32(vcgtq_s32(x, m)));
+	}
+}
+
+void BatchEval::scoreDiffs(const CardMask* p1Piles, const int32_t* sweepDiffs, int count, int32_t* out)
+{
+	const uint64x2_t all = vdupq_n_u64(FULL_DECK_MASK);
+	const uint64x2_t diamonds = vdupq_n_u64(DIAMONDS);
+	const uint64x2_t sevens = vdupq_n_u64(rankMask(7));
+	const uint64x2_t sixes = vdupq_n_u64(rankMask(6));
+	const int32x4_t one = vdupq_n_s32(1);
+	int i = 0;
+	for (; i + SCORE_STEP <= count; i += SCORE_STEP)
+	{
+		uint64x2_t a = vld1q_u64(p1Piles + i);
+		uint64x2_t b = vld1q_u64(p1Piles + i + 2);
+		int32x4_t sevensSign = signOf(counts(a, b, sevens), HALF_OF_SEVENS);
+		int32x4_t sixesSign = signOf(counts(a, b, sixes), HALF_OF_SEVENS);
+		int32x4_t diff = vaddq_s32(signOf(counts(a, b, all), HALF_OF_CARDS), signOf(counts(a, b, diamonds), HALF_OF_DIAMONDS));
+		int32x4_t sevensOnly = vandq_s32(vreinterpretq_s32_u32(vceqq_s32(sevensSign, vdupq_n_s32(0))), sixesSign);
+		diff = vaddq_s32(diff, vaddq_s32(sevensSign, sevensOnly));
+		int32x4_t sevenOfDiamonds = vandq_s32(vreinterpretq_s32_u32(vcombine_u32(vmovn_u64(vshrq_n_u64(a, SEVEN_OF_DIAMONDS)),
+			vmovn_u64(vshrq_n_u64(b, SEVEN_OF_DIAMONDS)))), one);
+		diff = vaddq_s32(diff, vsubq_s32(vaddq_s32(sevenOfDiamonds, sevenOfDiamonds), one));
+		vst1q_s32(out + i, vaddq_s32(diff, vld1q_s32(sweepDiffs + i)));
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = scoreDiff(p1Piles[i], sweepDiffs[i]);
+	}
+}
+
+void BatchEval::hasCapture(const CardMask* hands, const uint16_t* boardSums, int count, uint8_t* out)
+{
+	int i = 0;
+	for (; i + CAPTURE_STEP <= count; i += CAPTURE_STEP)
+	{
+		uint64x2_t hand = vld1q_u64(hands + i);
+		uint64x2_t ranks = vorrq_u64(hand, vshrq_n_u64(hand, 1));
+		ranks = vandq_u64(vorrq_u64(ranks, vshrq_n_u64(ranks, 2)), vdupq_n_u64(FIRST_SUIT_MASK));
+
+		uint64x2_t x = vcombine_u64(vcreate_u64((boardSums[i] >> 1) & 0x3FF), vcreate_u64((boardSums[i + 1] >> 1) & 0x3FF));
+		x = vandq_u64(vorrq_u64(x, vshlq_n_u64(x, 24)), vdupq_n_u64(0x000000FF000000FFULL));
+		x = vandq_u64(vorrq_u64(x, vshlq_n_u64(x, 12)), vdupq_n_u64(0x000F000F000F000FULL));
+		x = vandq_u64(vorrq_u64(x, vshlq_n_u64(x, 6)), vdupq_n_u64(0x0303030303030303ULL));
+		x = vandq_u64(vorrq_u64(x, vshlq_n_u64(x, 3)), vdupq_n_u64(0x1111111111111111ULL));
+
+		// both 32 bit halves of a lane folded into one, nonzero if the lane is
+		uint64x2_t both = vandq_u64(ranks, x);
+		uint32x2_t folded = vorr_u32(vmovn_u64(both), vshrn_n_u64(both, 32));
+		out[i] = vget_lane_u32(folded, 0) != 0 ? 1 : 0;
+		out[i + 1] = vget_lane_u32(folded, 1) != 0 ? 1 : 0;
+	}
+	for (; i < count; ++i)
+	{
+		out[i] = hasCapture(hands[i], boardSums[i]);
+	}
+}
+
+const char* BatchEval::getInstructionSet()
+{
+	return "neon";
+}
+
+#else
+
+void BatchEval::scoreDiffs(const CardMask* p1Piles, const int32_t* sweepDiffs, int count, int32_t* out)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = scoreDiff(p1Piles[i], sweepDiffs[i]);
+	}
+}
+
+void BatchEval::hasCapture(const CardMask* hands, const uint16_t* boardSums, int count, uint8_t* out)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		out[i] = hasCapture(hands[i], boardSums[i]);
+	}
+}
+
+const char* BatchEval::getInstructionSet()
+{
+	return "scalar";
+}
+
+#endif
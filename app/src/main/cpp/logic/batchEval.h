@@ -0,0 +1,22 @@
+#pragma once
+#include <cstdint>
+#include "cardMask.h"
+
+// the same evaluation for many independent states per call, lane parallel: AVX2 (8 states a step),
+// SSE2 (4), NEON (4) or plain C++, whichever simd.h picks for the build (SHKUBA_NO_SIMD for plain C++).
+// inputs are arrays with one entry per state, any count; results match the one state functions exactly.
+class BatchEval
+{
+public:
+	static const char* getInstructionSet();	//"avx2", "sse2", "neon" or "scalar"
+
+	// the round point difference p1 - p2 once every card is in a pile (Round::scoreCategories rules):
+	// p2 holds every card p1 doesn't, sweepDiffs are p1 sweeps - p2 sweeps
+	static void scoreDiffs(const CardMask* p1Piles, const int32_t* sweepDiffs, int count, int32_t* out);
+	static int32_t scoreDiff(CardMask p1Pile, int32_t sweepDiff);
+
+	// 1 if the hand can capture: some card's rank is on the board or is the sum of some board cards.
+	// boardSums are Board::getReachableSums
+	static void hasCapture(const CardMask* hands, const uint16_t* boardSums, int count, uint8_t* out);
+	static uint8_t hasCapture(CardMask hand, uint16_t boardSums);
+};
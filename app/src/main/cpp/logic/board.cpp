@@ -1,36 +1,121 @@
 #include "board.h"
 
-Board::Board() : cardsOnBoard()
+const uint16_t SUMS_MASK = (1 << (MAX_RANK + 1)) - 1;
+
+Board::Board() : cardsOnBoard(EMPTY_MASK), m_rankCounts(0), m_reachableSums(0)
+{
+}
+
+Board::Board(CardMask cards) : cardsOnBoard(cards), m_rankCounts(rankCountsOf(cards)), m_reachableSums(sumsOf(m_rankCounts))
 {
 }
 
 void Board::addToBoard(Card card)
 {
-	cardsOnBoard.push_back(card);
+	cardsOnBoard |= card.getMask();
+	m_rankCounts += rankCountUnit(card.getRank());
+	m_reachableSums = addToSums(m_reachableSums, card.getRank());
 }
 
 void Board::removeCards(std::vector<int> cardsToTake)
 {
-	for (int i = 0; i < cardsToTake.size(); ++i)
+	CardMask toRemove = EMPTY_MASK;
+	for (int boardIndex : cardsToTake)
+	{
+		int cardIndex = nthCard(cardsOnBoard, boardIndex);
+		if (cardIndex != -1)
+		{
+			toRemove |= cardBit(cardIndex);
+		}
+	}
+	removeMask(toRemove);
+
+}
+
+void Board::removeMask(CardMask cardsToTake)
+{
+	cardsToTake &= cardsOnBoard;
+	cardsOnBoard &= ~cardsToTake;
+	m_rankCounts -= rankCountsOf(cardsToTake);
+	if (cardsToTake)
 	{
-		cardsOnBoard.erase(cardsOnBoard.begin() + cardsToTake[i]);
+		m_reachableSums = sumsOf(m_rankCounts);
 	}
+}
 
+void Board::addMask(CardMask cardsToAdd)
+{
+	cardsToAdd &= ~cardsOnBoard;
+	cardsOnBoard |= cardsToAdd;
+	m_rankCounts += rankCountsOf(cardsToAdd);
+	for (; cardsToAdd; cardsToAdd &= cardsToAdd - 1)
+	{
+		m_reachableSums = addToSums(m_reachableSums, rankOfIndex(lowestCard(cardsToAdd)));
+	}
 }
 
-int Board::getBoardSize()
+int Board::getBoardSize() const
 {
-	return cardsOnBoard.size();
+	return countCards(cardsOnBoard);
 }
 
-std::vector<Card> Board::getBoard()
+std::vector<Card> Board::getBoard() const
+{
+	std::vector<Card> cards;
+	cards.reserve(countCards(cardsOnBoard));
+	for (CardMask rest = cardsOnBoard; rest; rest &= rest - 1)
+	{
+		cards.push_back(Card(lowestCard(rest)));
+	}
+	return cards;
+}
+
+
+
+Card Board::getCardByIndex(int i) const
+{
+	return Card(nthCard(cardsOnBoard, i));
+}
+
+CardMask Board::getMask() const
 {
 	return cardsOnBoard;
 }
 
+uint64_t Board::getRankCounts() const
+{
+	return m_rankCounts;
+}
 
+int Board::countRank(int rank) const
+{
+	return rankCount(m_rankCounts, rank);
+}
 
-Card Board::getCardByIndex(int i)
+uint16_t Board::getReachableSums() const
 {
-	return cardsOnBoard[i];
+	return m_reachableSums;
+}
+
+bool Board::canSumTo(int sum) const
+{
+	return sum >= 0 && sum <= MAX_RANK && (m_reachableSums >> sum) & 1;
+}
+
+uint16_t Board::addToSums(uint16_t sums, int rank)
+{
+	return static_cast<uint16_t>((sums | (sums << rank) | (1 << rank)) & SUMS_MASK);
+}
+
+uint16_t Board::sumsOf(uint64_t rankCounts)
+{
+	uint16_t sums = 0;
+	for (int rank = MIN_RANK; rank <= MAX_RANK; ++rank)
+	{
+		for (int i = rankCount(rankCounts, rank); i > 0; --i)
+		{
+			sums = addToSums(sums, rank);
+		}
+	}
+	return sums;
 }
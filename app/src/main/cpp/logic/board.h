@@ -1,16 +1,30 @@
 #pragma once
+#include <vector>
 #include "deck.h"
 
 class Board {
 public:
 	Board();
+	explicit Board(CardMask cards);
 	void addToBoard(Card card);
 	void removeCards(std::vector<int> cardsToTake);
-	int getBoardSize();
-	std::vector<Card> getBoard();
-	Card getCardByIndex(int i);
+	void removeMask(CardMask cardsToTake);
+	void addMask(CardMask cardsToAdd);
+	int getBoardSize() const;
+	std::vector<Card> getBoard() const;
+	Card getCardByIndex(int i) const;	//cards are ordered by their card index
+	CardMask getMask() const;
+	uint64_t getRankCounts() const;	//nibble per rank, see cardMask.h
+	int countRank(int rank) const;
+	bool canSumTo(int sum) const;	//true if some subset of the board sums to it (sums up to MAX_RANK)
+	uint16_t getReachableSums() const;	//bit s is canSumTo(s)
 
 private:
 
-	std::vector<Card> cardsOnBoard;
+	CardMask cardsOnBoard;
+	uint64_t m_rankCounts;
+	uint16_t m_reachableSums;	//bit s is on if a subset of the board sums to s, kept up to date by add/remove
+
+	static uint16_t addToSums(uint16_t sums, int rank);
+	static uint16_t sumsOf(uint64_t rankCounts);
 };
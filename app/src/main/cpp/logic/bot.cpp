@@ -0,0 +1,15 @@
+#include "bot.h"
+#include "startCardPolicy.h"
+
+Bot::~Bot()
+{
+}
+
+bool Bot::takeStartCard(const Round& round)
+{
+	return StartCardPolicy::shouldTake(round.getStartCard());
+}
+
+void Bot::setSeed(uint64_t /*seed*/)
+{
+}
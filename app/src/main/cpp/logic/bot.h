@@ -0,0 +1,12 @@
+#pragma once
+#include "round.h"
+
+// a player the engine can drive without the UI: the simulator plays matches between bots.
+class Bot
+{
+public:
+	virtual ~Bot();
+	virtual Move chooseMove(const Round& round) = 0;	//for the player whose turn it is
+	virtual bool takeStartCard(const Round& round);	//the first player's choice for Round::firstMiniRound, StartCardPolicy by default
+	virtual void setSeed(uint64_t seed);	//bots that use randomness must play the same after the same seed
+};
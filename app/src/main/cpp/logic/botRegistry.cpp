@@ -0,0 +1,101 @@
+#include "botRegistry.h"
+#include <climits>
+#include <cstdlib>
+#include <mutex>
+#include "gameBot.h"
+#include "ismctsBot.h"
+#include "randomBot.h"
+
+namespace
+{
+	const int DEFAULT_SIMULATION_ITERATIONS = 1000;
+
+	std::mutex registryMutex;
+}
+
+std::vector<BotRegistry::Entry>& BotRegistry::entries()
+{
+	static std::vector<Entry> registered = {
+		{ "greedy", "greedy[:cached]", [](const std::string& argument)	//"greedy:cached" shares one decision cache between all such bots
+			{
+				static DecisionCache sharedCache;
+				return argument.empty() || argument == "cached" ? std::unique_ptr<Bot>(new GameBot(argument.empty() ? nullptr : &sharedCache)) : nullptr;
+			} },
+		{ "weighted", "weighted:FILE", [](const std::string& argument)	//"weighted:FILE", a greedy bot with the weights of a parameter file
+			{
+				EvalWeights weights = EvalWeights::defaults();
+				return weights.load(argument) ? std::unique_ptr<Bot>(new GameBot(nullptr, weights)) : nullptr;
+			} },
+		{ "learned", "learned:FILE", [](const std::string& argument)	//"learned:FILE", a greedy bot rating positions with a shkuba_train model
+			{
+				std::shared_ptr<LearnedEval> model = std::make_shared<LearnedEval>();
+				return model->load(argument) ? std::unique_ptr<Bot>(new GameBot(nullptr, EvalWeights::defaults(), model)) : nullptr;
+			} },
+		{ "random", "random", [](const std::string&) { return std::unique_ptr<Bot>(new RandomBot()); } },
+		{ "ismcts", "ismcts[:ITERATIONS]", [](const std::string& argument)	//one thread and no clock, tools run many bots in parallel and want repeatable games
+			{
+				char* end = nullptr;
+				long long iterations = argument.empty() ? DEFAULT_SIMULATION_ITERATIONS : std::strtoll(argument.c_str(), &end, 10);
+				bool valid = (argument.empty() || *end == '\0') && iterations > 0 && iterations <= INT_MAX;	//0 would be a bot with no limit at all
+				return valid ? std::unique_ptr<Bot>(new IsmctsBot(1, static_cast<int>(iterations), 0)) : nullptr;
+			} },
+	};
+	return registered;
+}
+
+void BotRegistry::add(const std::string& name, factory create, const std::string& usage)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	entries().push_back({ name, usage.empty() ? name : usage, create });
+}
+
+bool BotRegistry::find(const std::string& name, Entry& found)
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	bool isFound = false;
+	for (const Entry& entry : entries())	//the last one added wins
+	{
+		if (entry.name == name)
+		{
+			found = entry;
+			isFound = true;
+		}
+	}
+	return isFound;
+}
+
+std::unique_ptr<Bot> BotRegistry::create(const std::string& spec)
+{
+	std::string name = spec.substr(0, spec.find(':'));
+	std::string argument = name.size() < spec.size() ? spec.substr(name.size() + 1) : "";
+	Entry entry;
+	return find(name, entry) ? entry.create(argument) : nullptr;
+}
+
+std::string BotRegistry::getError(const std::string& spec)
+{
+	std::string name = spec.substr(0, spec.find(':'));
+	Entry entry;
+	if (!find(name, entry))
+	{
+		return "unknown bot: " + spec;
+	}
+	std::size_t colon = entry.usage.find(':');
+	bool needsArgument = colon != std::string::npos && entry.usage.find('[') > colon;
+	if (needsArgument && name.size() + 1 >= spec.size())
+	{
+		return name + " needs an argument: " + entry.usage;
+	}
+	return "can't create " + spec + " (" + entry.usage + ")";
+}
+
+std::vector<std::string> BotRegistry::getUsages()
+{
+	std::lock_guard<std::mutex> lock(registryMutex);
+	std::vector<std::string> usages;
+	for (const Entry& entry : entries())
+	{
+		usages.push_back(entry.usage);
+	}
+	return usages;
+}
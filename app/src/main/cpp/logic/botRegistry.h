@@ -0,0 +1,30 @@
+#pragma once
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+#include "bot.h"
+
+// creates bots by name so tools can pick them from the command line.
+// a spec is "name" or "name:argument", e.g. "ismcts:5000" for 5000 iterations per move.
+// usage shows the argument: "name" takes none, "name[:ARG]" may take one, "name:ARG" needs one.
+class BotRegistry
+{
+public:
+	typedef std::function<std::unique_ptr<Bot>(const std::string& argument)> factory;
+
+	static void add(const std::string& name, factory create, const std::string& usage = "");	//usage defaults to the name
+	static std::unique_ptr<Bot> create(const std::string& spec);	//nullptr if the name is unknown or the argument is bad
+	static std::string getError(const std::string& spec);	//why create(spec) gave nullptr, for the tools to print
+	static std::vector<std::string> getUsages();
+
+private:
+	struct Entry
+	{
+		std::string name;
+		std::string usage;
+		factory create;
+	};
+	static bool find(const std::string& name, Entry& found);	//a copy, entries() may grow meanwhile
+	static std::vector<Entry>& entries();
+};
@@ -0,0 +1,113 @@
+#include "botThinker.h"
+#include "trace.h"
+
+BotThinker::BotThinker(int numOfThreads) : m_search(numOfThreads), m_fallback(), m_stop(false), m_cancelled(false), m_hasMove(false), m_done(false)
+{
+	m_search.setStopFlag(&m_stop);
+}
+
+BotThinker::~BotThinker()
+{
+	cancel();
+}
+
+bool BotThinker::start(const Round& round, int timeMs, int iterations, callback onDone)
+{
+	cancel();
+	if (round.isRoundOver() || round.getHand(round.getTurn()).getHandSize() == 0)
+	{
+		return false;
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_hasMove = false;
+		m_done = false;
+	}
+	m_stop = false;
+	m_cancelled = false;
+	m_search.setBudget(iterations, timeMs);
+	m_thread = std::thread(&BotThinker::think, this, round, onDone);
+	return true;
+}
+
+bool BotThinker::takeStartCard(const Round& round)
+{
+	return m_search.takeStartCard(round);
+}
+
+void BotThinker::think(Round round, callback onDone)
+{
+	TRACE_SCOPE("BotThinker::think");
+	Move move = m_fallback.chooseMove(round);
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_best = move;
+		m_hasMove = true;
+	}
+	if (!EndgameSolver::canSolve(round) && !m_stop)	//the endgame move is already exact
+	{
+		Move searched = m_search.chooseMove(round);
+		if (m_search.getLastIterations() > 0)	//stopped before the first iteration, keep the greedy move
+		{
+			move = searched;
+		}
+	}
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_best = move;
+		m_done = true;
+	}
+	if (onDone)
+	{
+		onDone(move, m_cancelled);
+	}
+}
+
+bool BotThinker::poll(Move& move) const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_done && !m_cancelled)
+	{
+		move = m_best;
+	}
+	return m_done && !m_cancelled;
+}
+
+bool BotThinker::bestMoveNow(Move& move)
+{
+	if (!m_thread.joinable() || m_cancelled)
+	{
+		return false;
+	}
+	stopAndJoin();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	move = m_best;
+	return m_hasMove;
+}
+
+void BotThinker::cancel()
+{
+	m_cancelled = true;
+	stopAndJoin();
+}
+
+bool BotThinker::isThinking() const
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	return m_thread.joinable() && !m_done;
+}
+
+void BotThinker::stopAndJoin()
+{
+	m_stop = true;
+	if (!m_thread.joinable())
+	{
+		return;
+	}
+	if (m_thread.get_id() == std::this_thread::get_id())	//called from the callback, the thread ends right after it
+	{
+		m_thread.detach();
+		return;
+	}
+	m_thread.join();
+}
@@ -0,0 +1,45 @@
+#pragma once
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include "gameBot.h"
+#include "ismctsBot.h"
+
+// runs the bot on its own thread so the caller (the UI) never waits for it.
+// start() copies the round and returns at once. a greedy move (exact once the deck is empty) is
+// ready almost immediately and is replaced by the search result when the search ends, so there is
+// always an answer: poll() once it is final, bestMoveNow() to stop the search early and take what it
+// has, cancel() to throw it away (leaving the screen, the round changed).
+class BotThinker
+{
+public:
+	// called once per start() on the thinking thread, with cancelled set if the result was thrown away
+	typedef std::function<void(Move move, bool cancelled)> callback;
+
+	explicit BotThinker(int numOfThreads = 0);	//search threads, 0 = one per core
+	~BotThinker();
+	BotThinker(const BotThinker&) = delete;
+	BotThinker& operator=(const BotThinker&) = delete;
+
+	bool start(const Round& round, int timeMs, int iterations, callback onDone = callback());	//false if there is no move to make
+	bool takeStartCard(const Round& round);	//the bot's Round::firstMiniRound choice, answered at once
+	bool poll(Move& move) const;	//true and the move once the thinking is over
+	bool bestMoveNow(Move& move);	//stops the search, waits for it and gives its move. false if nothing was started
+	void cancel();
+	bool isThinking() const;
+
+private:
+	void think(Round round, callback onDone);
+	void stopAndJoin();
+
+	IsmctsBot m_search;
+	GameBot m_fallback;
+	std::thread m_thread;
+	std::atomic<bool> m_stop;
+	std::atomic<bool> m_cancelled;
+	mutable std::mutex m_mutex;
+	Move m_best;
+	bool m_hasMove;
+	bool m_done;
+};
@@ -0,0 +1,121 @@
+#pragma once
+#include <atomic>
+#include <cstddef>
+#include <memory>
+
+// fixed capacity multi producer / multi consumer queue (Vyukov's bounded queue). every slot carries a
+// sequence number telling whose turn it is, push and pop claim a position with one compare-exchange
+// and never wait for each other or allocate. capacity is rounded up to a power of two.
+template <typename T>
+class BoundedQueue
+{
+public:
+	explicit BoundedQueue(std::size_t capacity);
+	BoundedQueue(const BoundedQueue&) = delete;
+	BoundedQueue& operator=(const BoundedQueue&) = delete;
+
+	bool push(const T& value);	//false if the queue is full
+	bool pop(T& value);	//false if the queue is empty
+	std::size_t getCapacity() const;
+	std::size_t getSize() const;	//exact only while nobody pushes or pops
+
+private:
+	struct Slot
+	{
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+
+	std::unique_ptr<Slot[]> m_slots;
+	std::size_t m_mask;
+	alignas(64) std::atomic<std::size_t> m_pushPosition;	//own cache lines, producers and consumers don't share them
+	alignas(64) std::atomic<std::size_t> m_popPosition;
+};
+
+template <typename T>
+BoundedQueue<T>::BoundedQueue(std::size_t capacity) : m_pushPosition(0), m_popPosition(0)
+{
+	std::size_t size = 2;
+	while (size < capacity)
+	{
+		size *= 2;
+	}
+	m_slots.reset(new Slot[size]);
+	m_mask = size - 1;
+	for (std::size_t i = 0; i < size; ++i)
+	{
+		m_slots[i].sequence.store(i, std::memory_order_relaxed);
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::push(const T& value)
+{
+	std::size_t position = m_pushPosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Slot& slot = m_slots[position & m_mask];
+		std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - position);
+		if (diff == 0)
+		{
+			if (m_pushPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				slot.value = value;
+				slot.sequence.store(position + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;	//the slot still holds a value from the last lap
+		}
+		else
+		{
+			position = m_pushPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+bool BoundedQueue<T>::pop(T& value)
+{
+	std::size_t position = m_popPosition.load(std::memory_order_relaxed);
+	while (true)
+	{
+		Slot& slot = m_slots[position & m_mask];
+		std::size_t sequence = slot.sequence.load(std::memory_order_acquire);
+		std::ptrdiff_t diff = static_cast<std::ptrdiff_t>(sequence - (position + 1));
+		if (diff == 0)
+		{
+			if (m_popPosition.compare_exchange_weak(position, position + 1, std::memory_order_relaxed))
+			{
+				value = slot.value;
+				slot.sequence.store(position + m_mask + 1, std::memory_order_release);
+				return true;
+			}
+		}
+		else if (diff < 0)
+		{
+			return false;
+		}
+		else
+		{
+			position = m_popPosition.load(std::memory_order_relaxed);
+		}
+	}
+}
+
+template <typename T>
+std::size_t BoundedQueue<T>::getCapacity() const
+{
+	return m_mask + 1;
+}
+
+template <typename T>
+std::size_t BoundedQueue<T>::getSize() const
+{
+	std::size_t popPosition = m_popPosition.load(std::memory_order_acquire);
+	std::size_t pushPosition = m_pushPosition.load(std::memory_order_acquire);
+	return pushPosition > popPosition ? pushPosition - popPosition : 0;
+}
@@ -0,0 +1,157 @@
+#include "captureTable.h"
+
+namespace
+{
+	const int MAX_COMBOS_PER_RANK = 40; //33 ways to build a 10
+	const uint64_t NIBBLE_HIGH_BITS = 0x8888888888ULL;
+
+	struct Tables
+	{
+		uint64_t combos[MAX_RANK + 1][MAX_COMBOS_PER_RANK];
+		int numOfCombos[MAX_RANK + 1];
+		uint8_t suitChoices[16][NUM_OF_SUITS + 1][6];	//[cards of a rank on board][amount to take] -> nibbles to take
+		int numOfSuitChoices[16][NUM_OF_SUITS + 1];
+
+		Tables()
+		{
+			for (int rank = 0; rank <= MAX_RANK; ++rank)
+			{
+				numOfCombos[rank] = 0;
+			}
+			for (int rank = MIN_RANK + 1; rank <= MAX_RANK; ++rank)
+			{
+				addCombos(rank, rank, rank - 1, 0, 0);
+			}
+
+			for (int nibble = 0; nibble < 16; ++nibble)
+			{
+				for (int amount = 0; amount <= NUM_OF_SUITS; ++amount)
+				{
+					numOfSuitChoices[nibble][amount] = 0;
+				}
+				for (int sub = nibble; ; sub = (sub - 1) & nibble)
+				{
+					int amount = countCards(sub);
+					suitChoices[nibble][amount][numOfSuitChoices[nibble][amount]++] = static_cast<uint8_t>(sub);
+					if (sub == 0)
+					{
+						break;
+					}
+				}
+			}
+		}
+
+		void addCombos(int target, int left, int maxPart, uint64_t combo, int parts)
+		{
+			if (left == 0)
+			{
+				if (parts > 1)
+				{
+					combos[target][numOfCombos[target]++] = combo;
+				}
+				return;
+			}
+			for (int part = left < maxPart ? left : maxPart; part >= MIN_RANK; --part)
+			{
+				if (rankCount(combo, part) < NUM_OF_SUITS)
+				{
+					addCombos(target, left - part, part, combo + rankCountUnit(part), parts + 1);
+				}
+			}
+		}
+	};
+
+	const Tables& getTables()
+	{
+		static const Tables tables;
+		return tables;
+	}
+
+	bool comboFits(uint64_t boardCounts, uint64_t combo)	//counts are at most 4 so the high bit of every nibble is free
+	{
+		return (((boardCounts | NIBBLE_HIGH_BITS) - combo) & NIBBLE_HIGH_BITS) == NIBBLE_HIGH_BITS;
+	}
+}
+
+int CaptureTable::getCaptures(const Board& board, int rank, CardMask* out, int capacity)
+{
+	CardMask boardMask = board.getMask();
+	CardMask singles = boardMask & rankMask(rank);
+	int written = 0;
+	if (singles)
+	{
+		while (singles && written < capacity)
+		{
+			out[written++] = popLowestCard(singles);
+		}
+		return written;
+	}
+	if (!board.canSumTo(rank))
+	{
+		return 0;
+	}
+
+	const Tables& tables = getTables();
+	uint64_t boardCounts = board.getRankCounts();
+	for (int i = 0; i < tables.numOfCombos[rank] && written < capacity; ++i)
+	{
+		uint64_t combo = tables.combos[rank][i];
+		if (comboFits(boardCounts, combo))
+		{
+			written += expandCombo(boardMask, combo, out + written, capacity - written);
+		}
+	}
+	return written;
+}
+
+bool CaptureTable::canCapture(const Board& board, int rank)
+{
+	return board.countRank(rank) > 0 || board.canSumTo(rank);
+}
+
+int CaptureTable::expandCombo(CardMask boardMask, uint64_t combo, CardMask* out, int capacity)
+{
+	const Tables& tables = getTables();
+	int shifts[NUM_OF_RANKS];
+	const uint8_t* choices[NUM_OF_RANKS];
+	int numOfChoices[NUM_OF_RANKS];
+	int picked[NUM_OF_RANKS];
+	int ranks = 0;
+	for (int rank = MIN_RANK; rank <= MAX_RANK; ++rank)
+	{
+		int amount = rankCount(combo, rank);
+		if (amount > 0)
+		{
+			int shift = (rank - MIN_RANK) * NUM_OF_SUITS;
+			int nibble = static_cast<int>((boardMask >> shift) & 0xF);
+			shifts[ranks] = shift;
+			choices[ranks] = tables.suitChoices[nibble][amount];
+			numOfChoices[ranks] = tables.numOfSuitChoices[nibble][amount];
+			picked[ranks] = 0;
+			++ranks;
+		}
+	}
+
+	int written = 0;
+	while (written < capacity)	//odometer over the suit choices of every rank in the combo
+	{
+		CardMask capture = EMPTY_MASK;
+		for (int i = 0; i < ranks; ++i)
+		{
+			capture |= CardMask(choices[i][picked[i]]) << shifts[i];
+		}
+		out[written++] = capture;
+
+		int i = 0;
+		while (i < ranks && ++picked[i] == numOfChoices[i])
+		{
+			picked[i] = 0;
+			++i;
+		}
+		if (i == ranks)
+		{
+			break;
+		}
+	}
+	return written;
+}
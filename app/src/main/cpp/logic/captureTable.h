@@ -0,0 +1,20 @@
+#pragma once
+#include "board.h"
+
+const int MAX_CAPTURES = 2048; //more than the number of subsets of a full board that sum to a single rank
+
+// precomputed subset-sum capture tables.
+// for every rank the table keeps all the multisets of at least 2 smaller ranks (at most 4 of each)
+// that sum to it, as rank count words. a board can take a multiset iff every nibble fits in the
+// board rank counts, so "which subsets capture rank r" is a lookup plus picking the suits.
+class CaptureTable
+{
+public:
+	// writes every board subset that a card of this rank may take (a single matching card if the
+	// board has one, otherwise every combo of 2+ cards that sums to the rank). returns the amount written.
+	static int getCaptures(const Board& board, int rank, CardMask* out, int capacity);
+	static bool canCapture(const Board& board, int rank);
+
+private:
+	static int expandCombo(CardMask boardMask, uint64_t combo, CardMask* out, int capacity);
+};
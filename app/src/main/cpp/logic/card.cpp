@@ -1,18 +1,62 @@
 #include "card.h"
+#include <array>
+#include <cstddef>
+#include <utility>
+
+namespace
+{
+    template <std::size_t... indices>
+    std::array<Card, sizeof...(indices)> makeCardTable(std::index_sequence<indices...>)
+    {
+        return { { Card(static_cast<int>(indices))... } };
+    }
+
+    const std::array<Card, NUM_OF_CARDS> CARD_TABLE = makeCardTable(std::make_index_sequence<NUM_OF_CARDS>());
+}
 
 Card::Card(suit mySuit, int myRank):
-    m_suit(mySuit),m_rank(myRank)
+    m_index(static_cast<uint8_t>(cardIndexOf(mySuit, myRank)))
 {
 }
 
+Card::Card(int cardIndex):
+    m_index(static_cast<uint8_t>(cardIndex))
+{
+}
+
+const Card& Card::fromIndex(int cardIndex)
+{
+    return CARD_TABLE[cardIndex];
+}
+
 Card::suit Card::getSuit() const
 {
-    return m_suit;
+    return static_cast<suit>(suitOfIndex(m_index));
 }
 
 int Card::getRank() const
 {
-    return m_rank;
+    return rankOfIndex(m_index);
+}
+
+int Card::getIndex() const
+{
+    return m_index;
+}
+
+CardMask Card::getMask() const
+{
+    return cardBit(m_index);
+}
+
+bool Card::operator==(const Card& other) const
+{
+    return m_index == other.m_index;
+}
+
+bool Card::operator!=(const Card& other) const
+{
+    return m_index != other.m_index;
 }
 
 
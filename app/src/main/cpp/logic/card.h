@@ -1,4 +1,5 @@
 #pragma once
+#include "cardMask.h"
 
 
 
@@ -9,17 +10,23 @@ public:
 	enum suit{S,H,D,C}; //S = spades , H = hearts , D = diamonds , C = clubs
 
 	Card(suit mySuit,int myRank);
+	explicit Card(int cardIndex);	//index as described in cardMask.h
+	static const Card& fromIndex(int cardIndex);	//the shared immutable instance, there are only NUM_OF_CARDS of them
 	suit getSuit() const;
 	int getRank() const;
+	int getIndex() const;
+	CardMask getMask() const;
+
+	bool operator==(const Card& other) const;
+	bool operator!=(const Card& other) const;
 
 
 
 private:
 
-	suit m_suit;
-	int m_rank;
+	uint8_t m_index; //suit and rank are packed in the index, see cardMask.h
 
 
 
 	
-};
\ No newline at end of file
+};
@@ -0,0 +1,114 @@
+#include "cardKnowledge.h"
+
+namespace
+{
+	// binomial coefficients up to NUM_OF_CARDS, as doubles (C(40,20) doesn't fit 32 bits)
+	struct Binomials
+	{
+		double values[NUM_OF_CARDS + 1][NUM_OF_CARDS + 1];
+
+		Binomials() : values()
+		{
+			for (int n = 0; n <= NUM_OF_CARDS; ++n)
+			{
+				values[n][0] = 1.0;
+				for (int k = 1; k <= n; ++k)
+				{
+					values[n][k] = values[n - 1][k - 1] + (k < n ? values[n - 1][k] : 0.0);
+				}
+			}
+		}
+	};
+
+	const Binomials binomials;
+}
+
+CardKnowledge::CardKnowledge(CardMask seen, CardMask knownInOpponentHand, int opponentHandSize, int deckSize) :
+	m_seen(seen), m_knownInOpponentHand(knownInOpponentHand), m_opponentHandSize(opponentHandSize), m_deckSize(deckSize),
+	m_numOfUnknown(countCards(FULL_DECK_MASK & ~seen & ~knownInOpponentHand)),
+	m_unknownInOpponentHand(opponentHandSize - countCards(knownInOpponentHand))
+{
+}
+
+CardMask CardKnowledge::getSeen() const
+{
+	return m_seen;
+}
+
+CardMask CardKnowledge::getUnseen() const
+{
+	return FULL_DECK_MASK & ~m_seen;
+}
+
+CardMask CardKnowledge::getKnownInOpponentHand() const
+{
+	return m_knownInOpponentHand;
+}
+
+CardMask CardKnowledge::getUnknown() const
+{
+	return FULL_DECK_MASK & ~m_seen & ~m_knownInOpponentHand;
+}
+
+int CardKnowledge::getOpponentHandSize() const
+{
+	return m_opponentHandSize;
+}
+
+int CardKnowledge::getDeckSize() const
+{
+	return m_deckSize;
+}
+
+double CardKnowledge::opponentHoldsCard(int cardIndex) const
+{
+	if (m_knownInOpponentHand & cardBit(cardIndex))
+	{
+		return 1.0;
+	}
+	if (!(getUnknown() & cardBit(cardIndex)))
+	{
+		return 0.0;
+	}
+	return double(m_unknownInOpponentHand) / m_numOfUnknown;
+}
+
+double CardKnowledge::deckHoldsCard(int cardIndex) const
+{
+	if (!(getUnknown() & cardBit(cardIndex)))
+	{
+		return 0.0;
+	}
+	return double(m_deckSize) / m_numOfUnknown;
+}
+
+int CardKnowledge::unseenOfRank(int rank) const
+{
+	return countCards(getUnseen() & rankMask(rank));
+}
+
+double CardKnowledge::expectedOpponentRankCount(int rank) const
+{
+	int known = countCards(m_knownInOpponentHand & rankMask(rank));
+	int unknown = countCards(getUnknown() & rankMask(rank));
+	return m_numOfUnknown == 0 ? known : known + double(unknown) * m_unknownInOpponentHand / m_numOfUnknown;
+}
+
+double CardKnowledge::opponentHasRank(int rank) const
+{
+	if (m_knownInOpponentHand & rankMask(rank))
+	{
+		return 1.0;
+	}
+	// hypergeometric: the unknown part of the other hand is a uniform draw from the unknown cards
+	int unknown = countCards(getUnknown() & rankMask(rank));
+	if (unknown == 0 || m_unknownInOpponentHand <= 0)
+	{
+		return 0.0;
+	}
+	if (m_numOfUnknown - unknown < m_unknownInOpponentHand)
+	{
+		return 1.0;
+	}
+	return 1.0 - binomials.values[m_numOfUnknown - unknown][m_unknownInOpponentHand] / binomials.values[m_numOfUnknown][m_unknownInOpponentHand];
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "cardMask.h"
+
+// what one player can know about the cards at a moment of the round, see Round::getKnowledge.
+// seen: every card the player has held or seen on the board / in a pile (and the start card).
+// the unseen cards are in the other hand or in the deck, and except for a card known to be in the
+// other hand (the start card the other player took) every arrangement of them is equally likely.
+// every query is O(1).
+class CardKnowledge
+{
+public:
+	CardKnowledge(CardMask seen, CardMask knownInOpponentHand, int opponentHandSize, int deckSize);
+
+	CardMask getSeen() const;
+	CardMask getUnseen() const;
+	CardMask getKnownInOpponentHand() const;
+	CardMask getUnknown() const;	//unseen and not known to be in the other hand
+	int getOpponentHandSize() const;
+	int getDeckSize() const;
+
+	double opponentHoldsCard(int cardIndex) const;	//probability the card is in the other hand
+	double deckHoldsCard(int cardIndex) const;	//probability the card is still in the deck
+	int unseenOfRank(int rank) const;
+	double expectedOpponentRankCount(int rank) const;
+	double opponentHasRank(int rank) const;	//probability of at least one card of the rank in the other hand
+
+private:
+	CardMask m_seen;
+	CardMask m_knownInOpponentHand;
+	int m_opponentHandSize;
+	int m_deckSize;
+	int m_numOfUnknown;
+	int m_unknownInOpponentHand;
+};
@@ -0,0 +1,105 @@
+#pragma once
+#include <cstdint>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif
+
+// bitboard representation of the engine state.
+// every card is an index 0..39: (rank - MIN_RANK) * NUM_OF_SUITS + suit, so the 4 cards of a rank
+// share one nibble. a set of cards (hand, board, pile) is a 40 bit mask, and a "rank counts" word
+// keeps the number of cards of every rank in that nibble (rank 1 in the lowest nibble).
+
+typedef uint64_t CardMask;
+
+const int NUM_OF_SUITS = 4;
+const int NUM_OF_RANKS = 10;
+const int MIN_RANK = 1;
+const int MAX_RANK = 10;
+const int NUM_OF_CARDS = NUM_OF_SUITS * NUM_OF_RANKS;
+
+const CardMask EMPTY_MASK = 0;
+const CardMask FULL_DECK_MASK = (CardMask(1) << NUM_OF_CARDS) - 1;
+const CardMask FIRST_SUIT_MASK = 0x1111111111ULL; // one bit in every rank nibble
+
+inline CardMask cardBit(int cardIndex)
+{
+	return CardMask(1) << cardIndex;
+}
+
+inline int cardIndexOf(int suit, int rank)
+{
+	return (rank - MIN_RANK) * NUM_OF_SUITS + suit;
+}
+
+inline int suitOfIndex(int cardIndex)
+{
+	return cardIndex & (NUM_OF_SUITS - 1);
+}
+
+inline int rankOfIndex(int cardIndex)
+{
+	return (cardIndex >> 2) + MIN_RANK;
+}
+
+inline CardMask suitMask(int suit)
+{
+	return FIRST_SUIT_MASK << suit;
+}
+
+inline CardMask rankMask(int rank)
+{
+	return CardMask(0xF) << ((rank - MIN_RANK) * NUM_OF_SUITS);
+}
+
+inline int countCards(CardMask mask)
+{
+#if defined(_MSC_VER)
+	return static_cast<int>(__popcnt64(mask));
+#else
+	return __builtin_popcountll(mask);
+#endif
+}
+
+inline int lowestCard(CardMask mask) //mask must not be empty
+{
+#if defined(_MSC_VER)
+	unsigned long index;
+	_BitScanForward64(&index, mask);
+	return static_cast<int>(index);
+#else
+	return __builtin_ctzll(mask);
+#endif
+}
+
+inline CardMask popLowestCard(CardMask& mask) //returns the bit of the lowest card and removes it from mask
+{
+	CardMask lowest = mask & (~mask + 1);
+	mask &= mask - 1;
+	return lowest;
+}
+
+inline int nthCard(CardMask mask, int n) //index of the n-th card (0 based) in ascending index order, -1 if there is none
+{
+	for (int i = 0; i < n && mask; ++i)
+	{
+		mask &= mask - 1;
+	}
+	return mask ? lowestCard(mask) : -1;
+}
+
+// rank counts: every nibble of the result holds the popcount of the same nibble of the mask.
+inline uint64_t rankCountsOf(CardMask mask)
+{
+	uint64_t x = mask - ((mask >> 1) & 0x5555555555ULL);
+	return (x & 0x3333333333ULL) + ((x >> 2) & 0x3333333333ULL);
+}
+
+inline uint64_t rankCountUnit(int rank)
+{
+	return uint64_t(1) << ((rank - MIN_RANK) * NUM_OF_SUITS);
+}
+
+inline int rankCount(uint64_t rankCounts, int rank)
+{
+	return static_cast<int>((rankCounts >> ((rank - MIN_RANK) * NUM_OF_SUITS)) & 0xF);
+}
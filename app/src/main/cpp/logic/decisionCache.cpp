@@ -0,0 +1,49 @@
+#include "decisionCache.h"
+#include "rng.h"
+
+DecisionCache::DecisionCache(int sizeBits) : m_entries(new Entry[std::size_t(1) << sizeBits]), m_indexMask((uint64_t(1) << sizeBits) - 1)
+{
+	clear();
+}
+
+DecisionCache::Key DecisionCache::keyOf(const CardMask* canonicalMasks, int count, uint64_t context)
+{
+	// two independent hash chains, one word each
+	Key key = { mixSeed(context), mixSeed(~context) };
+	for (int i = 0; i < count; ++i)
+	{
+		key.low = mixSeed(key.low ^ canonicalMasks[i]);
+		key.high = mixSeed(key.high + canonicalMasks[i] * 0x9E3779B97F4A7C15ULL);
+	}
+	return key;
+}
+
+bool DecisionCache::find(Key key, Move& move) const
+{
+	const Entry& entry = m_entries[key.low & m_indexMask];
+	uint64_t data = entry.move.load(std::memory_order_relaxed);
+	uint64_t check = entry.check.load(std::memory_order_relaxed);
+	if ((check ^ data) != key.high)
+	{
+		return false;
+	}
+	move = Move::fromKey(data);
+	return true;
+}
+
+void DecisionCache::store(Key key, Move move)
+{
+	Entry& entry = m_entries[key.low & m_indexMask];
+	entry.move.store(move.getKey(), std::memory_order_relaxed);
+	entry.check.store(key.high ^ move.getKey(), std::memory_order_relaxed);
+}
+
+void DecisionCache::clear()
+{
+	for (uint64_t i = 0; i <= m_indexMask; ++i)
+	{
+		// a check no real key is expected to produce with this move, so an empty slot reads as a miss
+		m_entries[i].move.store(0, std::memory_order_relaxed);
+		m_entries[i].check.store(~uint64_t(0), std::memory_order_relaxed);
+	}
+}
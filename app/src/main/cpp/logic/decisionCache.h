@@ -0,0 +1,38 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include "move.h"
+
+// decisions already made, keyed on the canonical form of a position (see SuitSymmetry) so every
+// suit renaming of a position shares one entry. fixed size and direct mapped: a new decision
+// replaces whatever was in its slot.
+// safe to share between threads without locks: a slot keeps the move and the move xor the key check
+// word, so a slot torn by a concurrent store just fails the check and reads as a miss.
+class DecisionCache
+{
+public:
+	struct Key	//128 bit fingerprint, low picks the slot and high is checked
+	{
+		uint64_t low;
+		uint64_t high;
+	};
+
+	explicit DecisionCache(int sizeBits = 16);
+	// context is anything else the move depends on (the kind of decision, a search budget...)
+	static Key keyOf(const CardMask* canonicalMasks, int count, uint64_t context);
+
+	bool find(Key key, Move& move) const;	//the move in the canonical position
+	void store(Key key, Move move);
+	void clear();	//not while other threads use the cache
+
+private:
+	struct Entry
+	{
+		std::atomic<uint64_t> check;	//key.high ^ move
+		std::atomic<uint64_t> move;
+	};
+
+	std::unique_ptr<Entry[]> m_entries;
+	uint64_t m_indexMask;
+};
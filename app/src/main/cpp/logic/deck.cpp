@@ -1,33 +1,118 @@
 #include "deck.h"
+#include <atomic>
+#include <random>
+#include "trace.h"
 
-const int CARDS_RANGE = 10;
-const int CARD_RANKS = 4;
+Deck::Deck() : m_size(0), m_rng(deviceSeed())
+{
+	fillDeck();
+	shuffleDeck();
+}
 
-Deck::Deck()
+Deck::Deck(uint64_t seed, uint64_t stream) : m_size(0), m_rng(seed, stream)
 {
-	for (int i = 0; i < CARDS_RANGE; ++i)
+	fillDeck();
+	shuffleDeck();
+}
+
+uint64_t Deck::deviceSeed()
+{
+	static const uint64_t base = (uint64_t(std::random_device()()) << 32) ^ std::random_device()();
+	static std::atomic<uint64_t> decks(0);
+	return mixSeed(base + decks++);
+}
+
+void Deck::fillDeck()
+{
+	for (int i = MIN_RANK; i <= MAX_RANK; ++i)
 	{
-		for (int j = 0; j < CARD_RANKS; ++j)
+		for (int j = 0; j < NUM_OF_SUITS; ++j)
 		{
 			Card::suit mySuit = static_cast<Card::suit>(j);
-			cards.push_back(Card(mySuit, i));
+			m_cards[m_size++] = static_cast<uint8_t>(Card(mySuit, i).getIndex());
 		}
 	}
-	shuffleDeck();
 }
 
 void Deck::shuffleDeck()
 {
-	std::random_device rd;
-	std::mt19937 g(rd());
-	std::shuffle(cards.begin(), cards.end(), g);
+	TRACE_SCOPE("Deck::shuffle");
+	shuffleCards(m_cards, m_size, m_rng);
 }
 
 Card Deck::draw()
 {
-	Card drawCard = cards.back();
-	cards.pop_back();
-	return drawCard;
+	return Card::fromIndex(m_cards[--m_size]);
+}
 
+int Deck::getSize() const
+{
+	return m_size;
+}
+
+CardMask Deck::getMask() const
+{
+	CardMask mask = EMPTY_MASK;
+	for (int i = 0; i < m_size; ++i)
+	{
+		mask |= cardBit(m_cards[i]);
+	}
+	return mask;
 }
 
+void Deck::setCards(const uint8_t* cardIndices, int count)
+{
+	for (int i = 0; i < count; ++i)
+	{
+		m_cards[i] = cardIndices[i];
+	}
+	m_size = count;
+}
+
+int Deck::getCards(uint8_t* cardIndices) const
+{
+	for (int i = 0; i < m_size; ++i)
+	{
+		cardIndices[i] = m_cards[i];
+	}
+	return m_size;
+}
+
+void Deck::shuffleCards(uint8_t* cardIndices, int count, CounterRng& rng)
+{
+	// fisher-yates, two swaps per random word: each 32 bit half is scaled to its own range
+	int i = count - 1;
+	for (; i >= 2; i -= 2)
+	{
+		uint64_t random = rng();
+		uint32_t first = static_cast<uint32_t>(((random & 0xFFFFFFFF) * uint64_t(i + 1)) >> 32);
+		uint8_t temp = cardIndices[i];
+		cardIndices[i] = cardIndices[first];
+		cardIndices[first] = temp;
+		uint32_t second = static_cast<uint32_t>(((random >> 32) * uint64_t(i)) >> 32);
+		temp = cardIndices[i - 1];
+		cardIndices[i - 1] = cardIndices[second];
+		cardIndices[second] = temp;
+	}
+	if (i == 1)
+	{
+		uint32_t last = rng.below(2);
+		uint8_t temp = cardIndices[1];
+		cardIndices[1] = cardIndices[last];
+		cardIndices[last] = temp;
+	}
+}
+
+void Deck::generateDeals(uint64_t seed, uint64_t firstStream, int numOfDeals, uint8_t* out)
+{
+	for (int deal = 0; deal < numOfDeals; ++deal)
+	{
+		uint8_t* order = out + deal * NUM_OF_CARDS;
+		for (int i = 0; i < NUM_OF_CARDS; ++i)
+		{
+			order[i] = static_cast<uint8_t>(i);
+		}
+		CounterRng rng(seed, firstStream + deal);
+		shuffleCards(order, NUM_OF_CARDS, rng);
+	}
+}
@@ -1,17 +1,32 @@
 #pragma once
-#include <vector>
-#include <random>
 #include "card.h"
+#include "rng.h"
 
+// the cards are an inline array, so a Deck (and a Round) is trivially copyable
 class Deck {
 
 public:
-	Deck();		//constructor
+	Deck();		//constructor, every deck gets its own stream of a seed taken once from the device
+	explicit Deck(uint64_t seed, uint64_t stream = 0);	//same seed and stream, same order
 	void shuffleDeck();
 	Card draw();
+	int getSize() const;
+	CardMask getMask() const;
+	void setCards(const uint8_t* cardIndices, int count);	//the last card is drawn first
+	int getCards(uint8_t* cardIndices) const;	//same order as setCards, returns the count
+
+	static void shuffleCards(uint8_t* cardIndices, int count, CounterRng& rng);
+	// writes numOfDeals * NUM_OF_CARDS card indices. deal i is the order of Deck(seed, firstStream + i)
+	// (drawn from the end), so a batch and a single deck always agree.
+	static void generateDeals(uint64_t seed, uint64_t firstStream, int numOfDeals, uint8_t* out);
 
 
 private:
-	std::vector<Card> cards;
+	void fillDeck();
+	static uint64_t deviceSeed();
+
+	uint8_t m_cards[NUM_OF_CARDS];	//card indices, drawn from the end
+	int m_size;
+	CounterRng m_rng;
 
 };
\ No newline at end of file
@@ -0,0 +1,216 @@
+#include "endgameSolver.h"
+#include <cstddef>
+#include <utility>
+#include "trace.h"
+
+namespace
+{
+	const int MAX_PLIES = 2 * NUM_OF_HAND;
+	const int INFINITE_VALUE = 127;
+	const int SWEEP_KEYS = 64;	//sweep differences -32..31, more than a round ever has
+
+	enum location { LOCATION_P1_HAND, LOCATION_P2_HAND, LOCATION_BOARD, LOCATION_P1_PILE, LOCATION_P2_PILE, NUM_OF_LOCATIONS };
+
+	struct ZobristKeys
+	{
+		uint64_t cards[NUM_OF_LOCATIONS][NUM_OF_CARDS];
+		uint64_t p2Turn;
+		uint64_t lastCapturer[3];	//-1, P1, P2
+		uint64_t sweeps[SWEEP_KEYS];
+
+		ZobristKeys()
+		{
+			CounterRng rng(0x5A0B'2157ULL);
+			for (int i = 0; i < NUM_OF_LOCATIONS; ++i)
+			{
+				for (int card = 0; card < NUM_OF_CARDS; ++card)
+				{
+					cards[i][card] = rng();
+				}
+			}
+			p2Turn = rng();
+			for (int i = 0; i < 3; ++i)
+			{
+				lastCapturer[i] = rng();
+			}
+			for (int i = 0; i < SWEEP_KEYS; ++i)
+			{
+				sweeps[i] = rng();
+			}
+		}
+	};
+
+	const ZobristKeys keys;
+
+	uint64_t hashCards(CardMask cards, location where)
+	{
+		uint64_t hash = 0;
+		for (; cards; cards &= cards - 1)
+		{
+			hash ^= keys.cards[where][lowestCard(cards)];
+		}
+		return hash;
+	}
+}
+
+EndgameSolver::EndgameSolver(int tableBits) : m_table(std::size_t(1) << tableBits), m_tableMask((uint64_t(1) << tableBits) - 1), m_nodes(0),
+	m_tablebase(nullptr)
+{
+}
+
+bool EndgameSolver::canSolve(const Round& round)
+{
+	return round.getDeckSize() == 0 && !round.isRoundOver();
+}
+
+int EndgameSolver::getLastNodes() const
+{
+	return m_nodes;
+}
+
+void EndgameSolver::setTablebase(const EndgameTablebase* tablebase)
+{
+	m_tablebase = tablebase;
+}
+
+Move EndgameSolver::solve(const Round& round, int* value)
+{
+	TRACE_SCOPE("EndgameSolver::solve");
+	if (m_moves.empty())
+	{
+		m_moves.resize(std::size_t(MAX_PLIES + 1) * MAX_MOVES);
+	}
+	m_nodes = 1;
+	Round state = round;
+	uint64_t cardsHash = cardsHashOf(state);
+	players mover = state.getTurn();
+
+	// the root is searched here and not through search() so the best move can't be lost to a table collision
+	Move* moves = m_moves.data();
+	int numOfMoves = orderedMoves(state, moves, Move());
+	Move bestMove = numOfMoves > 0 ? moves[0] : Move();
+	int alpha = -INFINITE_VALUE;
+	for (int i = 0; i < numOfMoves; ++i)
+	{
+		MoveUndo undo = state.makeMove(moves[i]);
+		int moveValue = -search(state, cardsHash ^ moveHash(moves[i], mover), 1, -INFINITE_VALUE, -alpha);
+		state.unmakeMove(moves[i], undo);
+		if (moveValue > alpha)
+		{
+			alpha = moveValue;
+			bestMove = moves[i];
+		}
+	}
+	if (value)
+	{
+		*value = alpha;
+	}
+	TRACE_COUNTER("EndgameSolver.nodes", m_nodes);
+	return bestMove;
+}
+
+int EndgameSolver::search(Round& state, uint64_t cardsHash, int ply, int alpha, int beta)
+{
+	++m_nodes;
+	if (state.isRoundOver())
+	{
+		return finalValue(state);
+	}
+	if (m_tablebase && m_tablebase->covers(state))
+	{
+		return m_tablebase->probe(state);
+	}
+
+	uint64_t key = hashOf(state, cardsHash);
+	Entry& entry = m_table[key & m_tableMask];
+	Move tableMove;
+	if (entry.key == key)
+	{
+		tableMove = entry.best;
+		if (entry.type == BOUND_EXACT || (entry.type == BOUND_LOWER && entry.value >= beta) || (entry.type == BOUND_UPPER && entry.value <= alpha))
+		{
+			return entry.value;
+		}
+	}
+
+	Move* moves = m_moves.data() + std::size_t(ply) * MAX_MOVES;
+	int numOfMoves = orderedMoves(state, moves, tableMove);
+
+	players mover = state.getTurn();
+	int alphaAtStart = alpha;
+	int best = -INFINITE_VALUE;
+	Move bestMove = moves[0];
+	for (int i = 0; i < numOfMoves && alpha < beta; ++i)
+	{
+		MoveUndo undo = state.makeMove(moves[i]);
+		int moveValue = -search(state, cardsHash ^ moveHash(moves[i], mover), ply + 1, -beta, -alpha);
+		state.unmakeMove(moves[i], undo);
+		if (moveValue > best)
+		{
+			best = moveValue;
+			bestMove = moves[i];
+			alpha = best > alpha ? best : alpha;
+		}
+	}
+
+	// the search may have reused the slot, it is always replaced by the latest result
+	Entry& slot = m_table[key & m_tableMask];
+	slot.key = key;
+	slot.best = bestMove;
+	slot.value = static_cast<int8_t>(best);
+	slot.type = best <= alphaAtStart ? BOUND_UPPER : (best >= beta ? BOUND_LOWER : BOUND_EXACT);
+	return best;
+}
+
+int EndgameSolver::orderedMoves(const Round& state, Move* moves, Move first)
+{
+	int numOfMoves = MoveGen::generate(state, moves, MAX_MOVES);
+	for (int i = 1; i < numOfMoves; ++i)	//the best move of an earlier visit goes first
+	{
+		if (moves[i] == first)
+		{
+			std::swap(moves[0], moves[i]);
+			break;
+		}
+	}
+	return numOfMoves;
+}
+
+int EndgameSolver::finalValue(const Round& state)
+{
+	PileCounts p1Counts = state.getPileCounts(P1);
+	if (state.getLastCapturer() == P1)
+	{
+		p1Counts.add(state.getBoard().getMask(), 1);
+	}
+	RoundScore score = Round::scoreCategories(p1Counts, state.getSweeps(P2));
+	int diff = score.total(P1) - score.total(P2);
+	return state.getTurn() == P1 ? diff : -diff;
+}
+
+uint64_t EndgameSolver::hashOf(const Round& state, uint64_t cardsHash)
+{
+	int sweepDiff = state.getSweeps(P1) - state.getSweeps(P2) + SWEEP_KEYS / 2;
+	sweepDiff = sweepDiff < 0 ? 0 : (sweepDiff >= SWEEP_KEYS ? SWEEP_KEYS - 1 : sweepDiff);
+	uint64_t hash = cardsHash ^ keys.lastCapturer[state.getLastCapturer() + 1] ^ keys.sweeps[sweepDiff];
+	return state.getTurn() == P2 ? hash ^ keys.p2Turn : hash;
+}
+
+uint64_t EndgameSolver::cardsHashOf(const Round& state)
+{
+	return hashCards(state.getHand(P1).getMask(), LOCATION_P1_HAND) ^ hashCards(state.getHand(P2).getMask(), LOCATION_P2_HAND) ^
+		hashCards(state.getBoard().getMask(), LOCATION_BOARD) ^ hashCards(state.getP1Pile(), LOCATION_P1_PILE) ^
+		hashCards(state.getP2Pile(), LOCATION_P2_PILE);
+}
+
+uint64_t EndgameSolver::moveHash(Move move, players mover)
+{
+	int card = move.getCard();
+	location pile = mover == P1 ? LOCATION_P1_PILE : LOCATION_P2_PILE;
+	uint64_t hash = keys.cards[mover == P1 ? LOCATION_P1_HAND : LOCATION_P2_HAND][card];
+	if (move.isDrop())
+	{
+		return hash ^ keys.cards[LOCATION_BOARD][card];
+	}
+	return hash ^ keys.cards[pile][card] ^ hashCards(move.getCaptured(), LOCATION_BOARD) ^ hashCards(move.getCaptured(), pile);
+}
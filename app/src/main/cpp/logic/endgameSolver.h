@@ -0,0 +1,45 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "endgameTablebase.h"
+#include "moveGen.h"
+
+// exact solver for the last mini-round. once the deck is empty every card the player to move can't see
+// is in the other hand, so the position has perfect information. negamax alpha-beta over Round::makeMove /
+// unmakeMove, with zobrist hashed positions in a transposition table. the value is the round point
+// difference (Round::countPiles rules, board leftovers to the last capturer) for the player to move.
+// at most 2 * NUM_OF_HAND plies: tens of microseconds for usual boards, a few milliseconds for a board of ~20 cards.
+// with an EndgameTablebase the last tricks are looked up instead of searched.
+class EndgameSolver
+{
+public:
+	explicit EndgameSolver(int tableBits = 12);
+	static bool canSolve(const Round& round);	//deck empty and cards left to play
+	Move solve(const Round& round, int* value = nullptr);	//round must pass canSolve
+	int getLastNodes() const;	//positions the last solve visited
+	void setTablebase(const EndgameTablebase* tablebase);	//answers the positions it covers without searching them, nullptr for none
+
+private:
+	enum bound { BOUND_EXACT, BOUND_LOWER, BOUND_UPPER };
+
+	struct Entry
+	{
+		uint64_t key;
+		Move best;
+		int8_t value;
+		uint8_t type;
+	};
+
+	int search(Round& state, uint64_t cardsHash, int ply, int alpha, int beta);
+	static int orderedMoves(const Round& state, Move* moves, Move first);
+	static int finalValue(const Round& state);	//for the player to move, the round is over
+	static uint64_t hashOf(const Round& state, uint64_t cardsHash);
+	static uint64_t cardsHashOf(const Round& state);
+	static uint64_t moveHash(Move move, players mover);
+
+	std::vector<Entry> m_table;
+	uint64_t m_tableMask;
+	std::vector<Move> m_moves;	//MAX_MOVES per ply
+	int m_nodes;
+	const EndgameTablebase* m_tablebase;
+};
@@ -0,0 +1,675 @@
+#include "endgameTablebase.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "moveGen.h"
+#include "threadPool.h"
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	const char TABLEBASE_MAGIC[4] = { 'S', 'H', 'K', 'T' };
+	const uint16_t TABLEBASE_VERSION = 1;
+	const std::size_t TABLEBASE_HEADER_SIZE = 24;
+	const std::size_t SLOT_SIZE = 12;
+	const int MIN_VALUE = -8;	//4 bit values
+	const int MAX_VALUE = 7;
+
+	const int CARDS_TO_WIN = NUM_OF_CARDS / 2 + 1;
+	const int DIAMONDS_TO_WIN = NUM_OF_RANKS / 2 + 1;
+	const int SEVENS_TO_WIN = NUM_OF_SUITS / 2 + 1;	//sixes too, they break a 2-2 tie on sevens
+	const int OTHER_SUITS[NUM_OF_SUITS - 1] = { Card::S, Card::H, Card::C };	//the canonical suits of the cards that aren't diamonds
+	const int TRIPLES = 20;	//(cards that aren't diamonds in the mover hand, other hand, board) summing to 3 at most
+	const int RANK_STATES = TRIPLES * 4;	//times where the diamond is
+
+	// the player to move's view of a position, all a stored value depends on. sweeps so far are left out, they only add
+	struct Position
+	{
+		CardMask moverHand;
+		CardMask otherHand;
+		CardMask board;
+		PileCounts mover;
+		bool moverCapturedLast;	//nobody yet counts as P2, Round::collectBoard then leaves the board to P2's side of the tally
+	};
+
+	// the cards in play decide how many values a position has
+	struct InPlay
+	{
+		int cards;
+		int diamonds;
+		int sevens;
+		int sixes;
+		bool sevenOfDiamonds;
+
+		explicit InPlay(CardMask inPlay) : cards(countCards(inPlay)), diamonds(countCards(inPlay & suitMask(Card::D))),
+			sevens(countCards(inPlay & rankMask(7))), sixes(countCards(inPlay & rankMask(6))),
+			sevenOfDiamonds((inPlay & cardBit(cardIndexOf(Card::D, 7))) != 0)
+		{
+		}
+
+		// every open category has a bucket per margin that can still go either way, and bucket 0 for "decided"
+		int cardsBuckets() const { return cards + 2; }
+		int diamondsBuckets() const { return diamonds > 0 ? diamonds + 2 : 1; }
+		int sevensBuckets() const { return sevens + sixes > 0 ? (sevens + 1) * (sixes + 3) + 1 : 1; }
+		int numOfValues() const { return cardsBuckets() * diamondsBuckets() * sevensBuckets() * 2; }
+	};
+
+	struct Buckets
+	{
+		int cards;
+		int diamonds;
+		int sevens;
+	};
+
+	struct TripleIndex
+	{
+		int index[4][4][4];
+		int cards[TRIPLES];	//a + b + c of every index
+
+		TripleIndex()
+		{
+			int next = 0;
+			for (int a = 0; a < 4; ++a)
+			{
+				for (int b = 0; b < 4; ++b)
+				{
+					for (int c = 0; c < 4; ++c)
+					{
+						index[a][b][c] = a + b + c < 4 ? next : -1;
+						if (a + b + c < 4)
+						{
+							cards[next++] = a + b + c;
+						}
+					}
+				}
+			}
+		}
+	};
+
+	const TripleIndex triples;
+
+	// the position with every card that isn't a diamond renamed to the canonical suits, as a number in base RANK_STATES
+	uint64_t keyOf(const Position& position)
+	{
+		const CardMask otherSuits = FULL_DECK_MASK & ~suitMask(Card::D);
+		uint64_t key = 0;
+		for (int rank = MAX_RANK; rank >= MIN_RANK; --rank)
+		{
+			CardMask cards = rankMask(rank) & otherSuits;
+			CardMask diamond = cardBit(cardIndexOf(Card::D, rank));
+			int where = (position.moverHand & diamond) ? 1 : (position.otherHand & diamond) ? 2 : (position.board & diamond) ? 3 : 0;
+			int state = triples.index[countCards(position.moverHand & cards)][countCards(position.otherHand & cards)][countCards(position.board & cards)];
+			key = key * RANK_STATES + static_cast<uint64_t>(state * 4 + where);
+		}
+		return key;
+	}
+
+	// how many values the positions of a key have, 0 if no position has that key. a file isn't trusted, open checks
+	// every slot with it
+	uint64_t numOfValuesOf(uint64_t key)
+	{
+		CardMask inPlay = EMPTY_MASK;
+		for (int rank = MIN_RANK; rank <= MAX_RANK; ++rank)
+		{
+			int state = static_cast<int>(key % RANK_STATES);
+			key /= RANK_STATES;
+			inPlay |= state % 4 != 0 ? cardBit(cardIndexOf(Card::D, rank)) : EMPTY_MASK;
+			for (int i = 0; i < triples.cards[state / 4]; ++i)
+			{
+				inPlay |= cardBit(cardIndexOf(OTHER_SUITS[i], rank));
+			}
+		}
+		return key == 0 && inPlay != EMPTY_MASK ? InPlay(inPlay).numOfValues() : 0;
+	}
+
+	// a category outcome for the player to move, +1 / 0 / -1, the tally of Round::scoreCategories
+	int categoryValue(const RoundScore& score, int category)
+	{
+		return score.points[P1][category] - score.points[P2][category];
+	}
+
+	RoundScore scoreOf(PileCounts mover)
+	{
+		mover.sweeps = 0;
+		return Round::scoreCategories(mover, 0);
+	}
+
+	Buckets bucketsOf(const PileCounts& mover, const InPlay& inPlay)
+	{
+		Buckets buckets;
+		int need = CARDS_TO_WIN - mover.cards;
+		buckets.cards = need >= 1 && need <= inPlay.cards + 1 ? need : 0;
+		need = DIAMONDS_TO_WIN - mover.diamonds;
+		buckets.diamonds = inPlay.diamonds > 0 && need >= 1 && need <= inPlay.diamonds + 1 ? need : 0;
+		need = SEVENS_TO_WIN - mover.sevens;
+		int needSixes = std::max(0, std::min(inPlay.sixes + 2, SEVENS_TO_WIN - mover.sixes));
+		buckets.sevens = inPlay.sevens + inPlay.sixes > 0 && need >= 1 && need <= inPlay.sevens + 1 ? 1 + (need - 1) * (inPlay.sixes + 3) + needSixes : 0;
+		return buckets;
+	}
+
+	int indexOf(const Buckets& buckets, const InPlay& inPlay, bool moverCapturedLast)
+	{
+		return ((buckets.cards * inPlay.diamondsBuckets() + buckets.diamonds) * inPlay.sevensBuckets() + buckets.sevens) * 2 + (moverCapturedLast ? 1 : 0);
+	}
+
+	// what the categories that can't change anymore add to every line of play
+	int decidedValue(const PileCounts& mover, const InPlay& inPlay, const Buckets& buckets)
+	{
+		RoundScore score = scoreOf(mover);
+		int value = 0;
+		value += buckets.cards == 0 ? categoryValue(score, SCORE_CARDS) : 0;
+		value += buckets.diamonds == 0 ? categoryValue(score, SCORE_DIAMONDS) : 0;
+		value += buckets.sevens == 0 ? categoryValue(score, SCORE_SEVENS) : 0;
+		value += !inPlay.sevenOfDiamonds ? categoryValue(score, SCORE_SEVEN_OF_DIAMONDS) : 0;
+		return value;
+	}
+
+	uint64_t readLittleEndian(const uint8_t* in, int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; ++i)
+		{
+			value |= uint64_t(in[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	void writeLittleEndian(uint8_t* out, uint64_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; ++i)
+		{
+			out[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	// the slots and values, of a mapped file or of a table being generated
+	struct Table
+	{
+		uint64_t slotMask;
+		const uint8_t* slots;
+		const uint8_t* values;
+
+		const uint8_t* findSlot(uint64_t key) const	//nullptr if the key isn't there
+		{
+			uint64_t slot = mixSeed(key) & slotMask;
+			for (uint64_t probes = 0; probes <= slotMask; ++probes, slot = (slot + 1) & slotMask)	//a full table has no empty slot to stop at
+			{
+				const uint8_t* entry = slots + slot * SLOT_SIZE;
+				uint64_t slotKey = readLittleEndian(entry, 8);
+				if (slotKey == key)
+				{
+					return entry;
+				}
+				if (slotKey == 0)
+				{
+					return nullptr;
+				}
+			}
+			return nullptr;
+		}
+
+		// the value for the player to move, sweeps so far left out
+		int value(const Position& position) const
+		{
+			if (position.moverHand == EMPTY_MASK && position.otherHand == EMPTY_MASK)
+			{
+				PileCounts last = position.mover;
+				if (position.moverCapturedLast)
+				{
+					last.add(position.board, 1);
+				}
+				RoundScore score = scoreOf(last);
+				return score.total(P1) - score.total(P2);
+			}
+			InPlay inPlay(position.moverHand | position.otherHand | position.board);
+			Buckets buckets = bucketsOf(position.mover, inPlay);
+			const uint8_t* slot = findSlot(keyOf(position));
+			if (!slot)
+			{
+				return 0;
+			}
+			uint64_t index = readLittleEndian(slot + 8, 4) + indexOf(buckets, inPlay, position.moverCapturedLast);
+			int nibble = (values[index / 2] >> (4 * (index % 2))) & 0xF;
+			return (nibble ^ 8) - 8 + decidedValue(position.mover, inPlay, buckets);
+		}
+	};
+
+	// the other player's pile counts: every card that isn't in play or in the mover's pile
+	PileCounts otherCounts(const PileCounts& mover, const InPlay& inPlay)
+	{
+		PileCounts other;
+		other.cards = NUM_OF_CARDS - inPlay.cards - mover.cards;
+		other.diamonds = NUM_OF_RANKS - inPlay.diamonds - mover.diamonds;
+		other.sevens = NUM_OF_SUITS - inPlay.sevens - mover.sevens;
+		other.sixes = NUM_OF_SUITS - inPlay.sixes - mover.sixes;
+		other.sevenOfDiamonds = 1 - (inPlay.sevenOfDiamonds ? 1 : 0) - mover.sevenOfDiamonds;
+		other.sweeps = 0;
+		return other;
+	}
+
+	// one move on: the other player's view, and whether the move swept the board
+	Position afterMove(const Position& position, Move move, bool& sweep)
+	{
+		CardMask played = cardBit(move.getCard());
+		PileCounts mover = position.mover;
+		Position next;
+		next.moverHand = position.otherHand;
+		next.otherHand = position.moverHand & ~played;
+		if (move.isDrop())
+		{
+			next.board = position.board | played;
+			next.moverCapturedLast = !position.moverCapturedLast;
+			sweep = false;
+		}
+		else
+		{
+			next.board = position.board & ~move.getCaptured();
+			mover.add(move.getCaptured() | played, 1);
+			next.moverCapturedLast = false;
+			sweep = next.board == EMPTY_MASK;
+		}
+		next.mover = otherCounts(mover, InPlay(next.moverHand | next.otherHand | next.board));
+		return next;
+	}
+
+	int searchOneMove(const Table& table, const Position& position)
+	{
+		Move moves[MAX_MOVES];
+		int numOfMoves = MoveGen::generate(Hand(position.moverHand), Board(position.board), moves, MAX_MOVES);
+		int best = -127;
+		for (int i = 0; i < numOfMoves; ++i)
+		{
+			bool sweep;
+			Position next = afterMove(position, moves[i], sweep);
+			best = std::max(best, (sweep ? 1 : 0) - table.value(next));
+		}
+		return best;
+	}
+
+	Position positionOf(const Round& round)
+	{
+		players mover = round.getTurn();
+		players other = mover == P1 ? P2 : P1;
+		int lastCapturer = round.getLastCapturer() == -1 ? P2 : round.getLastCapturer();
+		Position position;
+		position.moverHand = round.getHand(mover).getMask();
+		position.otherHand = round.getHand(other).getMask();
+		position.board = round.getBoard().getMask();
+		position.mover = round.getPileCounts(mover);
+		position.moverCapturedLast = lastCapturer == mover;
+		return position;
+	}
+
+	int sweepsDiff(const Round& round)
+	{
+		players mover = round.getTurn();
+		return round.getSweeps(mover) - round.getSweeps(mover == P1 ? P2 : P1);
+	}
+
+	// a canonical position of the generator, its values start at first
+	struct Layout
+	{
+		Position cards;	//the hands and board, pile counts are set per value
+		uint64_t key;
+		uint64_t first;
+		int handCards;
+	};
+
+	// every position of the given hand sizes and at most maxBoard board cards, ranks from rank up
+	void enumerate(int rank, int moverLeft, int otherLeft, int boardLeft, Position& position, std::vector<Layout>& out)
+	{
+		if (rank > MAX_RANK)
+		{
+			if (moverLeft == 0 && otherLeft == 0)
+			{
+				Layout layout;
+				layout.cards = position;
+				layout.key = keyOf(position);
+				layout.first = 0;
+				layout.handCards = countCards(position.moverHand | position.otherHand);
+				out.push_back(layout);
+			}
+			return;
+		}
+		Position saved = position;
+		for (int where = 0; where < 4; ++where)	//the diamond: out of play, mover, other, board
+		{
+			int moverWithDiamond = moverLeft - (where == 1 ? 1 : 0);
+			int otherWithDiamond = otherLeft - (where == 2 ? 1 : 0);
+			int boardWithDiamond = boardLeft - (where == 3 ? 1 : 0);
+			if (moverWithDiamond < 0 || otherWithDiamond < 0 || boardWithDiamond < 0)
+			{
+				continue;
+			}
+			CardMask diamond = cardBit(cardIndexOf(Card::D, rank));
+			for (int a = 0; a <= std::min(3, moverWithDiamond); ++a)
+			{
+				for (int b = 0; a + b <= 3 && b <= otherWithDiamond; ++b)
+				{
+					for (int c = 0; a + b + c <= 3 && c <= boardWithDiamond; ++c)
+					{
+						position = saved;
+						position.moverHand |= where == 1 ? diamond : EMPTY_MASK;
+						position.otherHand |= where == 2 ? diamond : EMPTY_MASK;
+						position.board |= where == 3 ? diamond : EMPTY_MASK;
+						int suit = 0;
+						for (int i = 0; i < a; ++i)
+						{
+							position.moverHand |= cardBit(cardIndexOf(OTHER_SUITS[suit++], rank));
+						}
+						for (int i = 0; i < b; ++i)
+						{
+							position.otherHand |= cardBit(cardIndexOf(OTHER_SUITS[suit++], rank));
+						}
+						for (int i = 0; i < c; ++i)
+						{
+							position.board |= cardBit(cardIndexOf(OTHER_SUITS[suit++], rank));
+						}
+						enumerate(rank + 1, moverWithDiamond - a, otherWithDiamond - b, boardWithDiamond - c, position, out);
+					}
+				}
+			}
+		}
+		position = saved;
+	}
+
+	// pile counts that fall into the given buckets
+	PileCounts countsOf(const InPlay& inPlay, const Buckets& buckets)
+	{
+		PileCounts mover = {};
+		mover.cards = CARDS_TO_WIN - buckets.cards;
+		mover.diamonds = DIAMONDS_TO_WIN - buckets.diamonds;
+		mover.sevens = SEVENS_TO_WIN;
+		mover.sixes = SEVENS_TO_WIN;
+		if (buckets.sevens > 0)
+		{
+			mover.sevens = SEVENS_TO_WIN - (1 + (buckets.sevens - 1) / (inPlay.sixes + 3));
+			mover.sixes = SEVENS_TO_WIN - (buckets.sevens - 1) % (inPlay.sixes + 3);
+		}
+		mover.sevenOfDiamonds = inPlay.sevenOfDiamonds ? 0 : 1;
+		return mover;
+	}
+
+	void solveLayout(const Table& table, const Layout& layout, uint8_t* values)
+	{
+		InPlay inPlay(layout.cards.moverHand | layout.cards.otherHand | layout.cards.board);
+		Position position = layout.cards;
+		Buckets buckets;
+		for (buckets.cards = 0; buckets.cards < inPlay.cardsBuckets(); ++buckets.cards)
+		{
+			for (buckets.diamonds = 0; buckets.diamonds < inPlay.diamondsBuckets(); ++buckets.diamonds)
+			{
+				for (buckets.sevens = 0; buckets.sevens < inPlay.sevensBuckets(); ++buckets.sevens)
+				{
+					position.mover = countsOf(inPlay, buckets);
+					for (int capturedLast = 0; capturedLast < 2; ++capturedLast)
+					{
+						position.moverCapturedLast = capturedLast != 0;
+						int value = searchOneMove(table, position) - decidedValue(position.mover, inPlay, buckets);
+						value = std::max(MIN_VALUE, std::min(MAX_VALUE, value));
+						uint64_t index = layout.first + indexOf(buckets, inPlay, position.moverCapturedLast);
+						values[index / 2] |= static_cast<uint8_t>((value & 0xF) << (4 * (index % 2)));
+					}
+				}
+			}
+		}
+	}
+}
+
+EndgameTablebase::EndgameTablebase() : m_data(nullptr), m_size(0), m_mapped(false), m_maxHandCards(0), m_maxCards(0), m_slotMask(0),
+	m_slots(nullptr), m_values(nullptr)
+{
+}
+
+EndgameTablebase::~EndgameTablebase()
+{
+	close();
+}
+
+bool EndgameTablebase::open(const std::string& path)
+{
+	close();
+#if !defined(_WIN32)
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped != MAP_FAILED)
+		{
+			madvise(mapped, info.st_size, MADV_RANDOM);
+			m_data = static_cast<const uint8_t*>(mapped);
+			m_size = info.st_size;
+			m_mapped = true;
+		}
+	}
+	::close(file);
+#else
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+	std::fseek(file, 0, SEEK_END);
+	long size = std::ftell(file);
+	std::fseek(file, 0, SEEK_SET);
+	if (size > 0)
+	{
+		uint8_t* data = new uint8_t[size];
+		m_size = std::fread(data, 1, size, file);
+		m_data = data;
+	}
+	std::fclose(file);
+#endif
+	if (!m_data || m_size < TABLEBASE_HEADER_SIZE || std::memcmp(m_data, TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC)) != 0 ||
+		readLittleEndian(m_data + 4, 2) != TABLEBASE_VERSION)
+	{
+		close();
+		return false;
+	}
+	uint64_t slots = readLittleEndian(m_data + 8, 4);
+	uint64_t valueBytes = readLittleEndian(m_data + 16, 8);
+	if (slots == 0 || (slots & (slots - 1)) != 0 || m_size != TABLEBASE_HEADER_SIZE + slots * SLOT_SIZE + valueBytes)
+	{
+		close();
+		return false;
+	}
+	for (uint64_t slot = 0; slot < slots; ++slot)	//every position's values inside the file
+	{
+		const uint8_t* entry = m_data + TABLEBASE_HEADER_SIZE + slot * SLOT_SIZE;
+		uint64_t key = readLittleEndian(entry, 8);
+		uint64_t numOfValues = numOfValuesOf(key);
+		if (key != 0 && (numOfValues == 0 || readLittleEndian(entry + 8, 4) + numOfValues > valueBytes * 2))
+		{
+			close();
+			return false;
+		}
+	}
+	m_maxHandCards = m_data[6];
+	m_maxCards = m_data[7];
+	m_slotMask = slots - 1;
+	m_slots = m_data + TABLEBASE_HEADER_SIZE;
+	m_values = m_slots + slots * SLOT_SIZE;
+	return true;
+}
+
+void EndgameTablebase::close()
+{
+	if (m_data)
+	{
+#if !defined(_WIN32)
+		if (m_mapped)
+		{
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+		}
+#else
+		delete[] m_data;
+#endif
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_mapped = false;
+	m_maxHandCards = 0;
+	m_maxCards = 0;
+	m_slots = nullptr;
+	m_values = nullptr;
+}
+
+bool EndgameTablebase::isOpen() const
+{
+	return m_data != nullptr;
+}
+
+int EndgameTablebase::getMaxHandCards() const
+{
+	return m_maxHandCards;
+}
+
+int EndgameTablebase::getMaxCards() const
+{
+	return m_maxCards;
+}
+
+std::size_t EndgameTablebase::getSize() const
+{
+	return m_size;
+}
+
+bool EndgameTablebase::covers(const Round& round) const
+{
+	if (!m_data || round.getDeckSize() != 0)
+	{
+		return false;
+	}
+	players mover = round.getTurn();
+	int moverCards = round.getHand(mover).getHandSize();
+	int otherCards = round.getHand(mover == P1 ? P2 : P1).getHandSize();
+	return moverCards > 0 && (moverCards == otherCards || moverCards == otherCards + 1) && moverCards + otherCards <= m_maxHandCards &&
+		moverCards + otherCards + round.getBoard().getBoardSize() <= m_maxCards;
+}
+
+int EndgameTablebase::probe(const Round& round) const
+{
+	Table table = { m_slotMask, m_slots, m_values };
+	return table.value(positionOf(round)) + sweepsDiff(round);
+}
+
+Move EndgameTablebase::bestMove(const Round& round, int* value) const
+{
+	Table table = { m_slotMask, m_slots, m_values };
+	Move moves[MAX_MOVES];
+	int numOfMoves = MoveGen::generate(round, moves, MAX_MOVES);
+	Move best = numOfMoves > 0 ? moves[0] : Move();
+	int bestValue = -127;
+	for (int i = 0; i < numOfMoves; ++i)
+	{
+		Round next = round;
+		next.makeMove(moves[i]);
+		int moveValue = -(table.value(positionOf(next)) + sweepsDiff(next));
+		if (moveValue > bestValue)
+		{
+			bestValue = moveValue;
+			best = moves[i];
+		}
+	}
+	if (value)
+	{
+		*value = bestValue;
+	}
+	return best;
+}
+
+bool EndgameTablebase::generate(const std::string& path, int maxHandCards, int maxCards, int numOfThreads)
+{
+	maxHandCards = std::max(1, std::min(2 * NUM_OF_HAND, maxHandCards));
+	maxCards = std::max(maxHandCards, std::min(NUM_OF_CARDS, maxCards));
+	std::vector<Layout> layouts;
+	for (int moverCards = 1; 2 * moverCards - 1 <= maxHandCards; ++moverCards)
+	{
+		for (int otherCards = moverCards - 1; otherCards <= moverCards && moverCards + otherCards <= maxHandCards; ++otherCards)
+		{
+			Position empty = {};
+			enumerate(MIN_RANK, moverCards, otherCards, maxCards - moverCards - otherCards, empty, layouts);
+		}
+	}
+	std::sort(layouts.begin(), layouts.end(), [](const Layout& a, const Layout& b) { return a.handCards < b.handCards; });
+
+	// values of a position start on a byte, so threads never share one
+	uint64_t numOfValues = 0;
+	for (Layout& layout : layouts)
+	{
+		layout.first = numOfValues;
+		InPlay inPlay(layout.cards.moverHand | layout.cards.otherHand | layout.cards.board);
+		numOfValues += (inPlay.numOfValues() + 1) & ~1;
+	}
+	if (numOfValues > UINT32_MAX)	//slots hold 32 bit offsets
+	{
+		return false;
+	}
+	uint64_t slots = 1;
+	while (slots < 2 * layouts.size())
+	{
+		slots *= 2;
+	}
+	std::vector<uint8_t> bytes(TABLEBASE_HEADER_SIZE + slots * SLOT_SIZE + numOfValues / 2, 0);
+	std::memcpy(bytes.data(), TABLEBASE_MAGIC, sizeof(TABLEBASE_MAGIC));
+	writeLittleEndian(bytes.data() + 4, TABLEBASE_VERSION, 2);
+	bytes[6] = static_cast<uint8_t>(maxHandCards);
+	bytes[7] = static_cast<uint8_t>(maxCards);
+	writeLittleEndian(bytes.data() + 8, slots, 4);
+	writeLittleEndian(bytes.data() + 12, layouts.size(), 4);
+	writeLittleEndian(bytes.data() + 16, numOfValues / 2, 8);
+	uint8_t* slotBytes = bytes.data() + TABLEBASE_HEADER_SIZE;
+	uint8_t* values = slotBytes + slots * SLOT_SIZE;
+	for (const Layout& layout : layouts)
+	{
+		uint64_t slot = mixSeed(layout.key) & (slots - 1);
+		while (readLittleEndian(slotBytes + slot * SLOT_SIZE, 8) != 0)
+		{
+			slot = (slot + 1) & (slots - 1);
+		}
+		writeLittleEndian(slotBytes + slot * SLOT_SIZE, layout.key, 8);
+		writeLittleEndian(slotBytes + slot * SLOT_SIZE + 8, layout.first, 4);
+	}
+
+	// retrograde: every move takes a card out of a hand, so a level only reads the levels before it
+	Table table = { slots - 1, slotBytes, values };
+	ThreadPool pool(numOfThreads);
+	for (std::size_t begin = 0; begin < layouts.size();)
+	{
+		std::size_t end = begin;
+		while (end < layouts.size() && layouts[end].handCards == layouts[begin].handCards)
+		{
+			++end;
+		}
+		std::atomic<std::size_t> next(begin);
+		pool.run(pool.getSize(), [&](int)
+		{
+			for (std::size_t i = next++; i < end; i = next++)
+			{
+				solveLayout(table, layouts[i], values);
+			}
+		});
+		begin = end;
+	}
+
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+	return std::fclose(file) == 0 && ok;
+}
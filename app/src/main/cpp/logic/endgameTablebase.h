@@ -0,0 +1,55 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "round.h"
+
+// exact values of the last tricks, precomputed: the deck is empty, the two hands hold at most maxHandCards cards
+// together and hands + board at most maxCards. the value is EndgameSolver's (round point difference for the player
+// to move), a probe costs a hash lookup instead of a search.
+//
+// what is stored: cards of the same rank that aren't diamonds play the same, so a position is, for every rank, how
+// many of them each hand and the board hold and where the diamond is. the piles only matter through the categories
+// still open: how many cards, diamonds, sevens (and sixes for a 2-2 tie) the player to move still needs, clamped to
+// what the cards in play can change, and who captured last. categories that are already decided and the sweeps so
+// far add the same to every line of play, the probe adds them. values are 4 bit, positions are found through an
+// open addressed hash of their key.
+//
+// built by retrograde analysis (generate): positions with one card in hand first, each further card solved from the
+// values of the positions one move later. shkuba_tablebase writes and checks the file.
+// file, little endian: "SHKT", uint16 version, uint8 maxHandCards, uint8 maxCards, uint32 slots, uint32 positions,
+// uint64 value bytes; slots of (uint64 key, uint32 first value), key 0 is empty; values, two per byte, low nibble first.
+class EndgameTablebase
+{
+public:
+	EndgameTablebase();
+	~EndgameTablebase();
+	EndgameTablebase(const EndgameTablebase&) = delete;
+	EndgameTablebase& operator=(const EndgameTablebase&) = delete;
+
+	// maps the file read only (read into memory where mapping isn't available). false if it isn't a tablebase file
+	// or a slot holds a key no position has or values past the end
+	bool open(const std::string& path);
+	void close();
+	bool isOpen() const;
+	int getMaxHandCards() const;
+	int getMaxCards() const;
+	std::size_t getSize() const;
+
+	bool covers(const Round& round) const;	//deck empty, round not over and small enough
+	int probe(const Round& round) const;	//round must pass covers
+	Move bestMove(const Round& round, int* value = nullptr) const;	//one probe per legal move, round must pass covers
+
+	// false if the file can't be written or would need more than 2^32 values. maxHandCards up to 2 * NUM_OF_HAND,
+	// maxCards up to NUM_OF_CARDS. the size grows fast: 2 and 4 take 14 MB, 3 and 5 260 MB
+	static bool generate(const std::string& path, int maxHandCards, int maxCards, int numOfThreads = 0);
+
+private:
+	const uint8_t* m_data;
+	std::size_t m_size;
+	bool m_mapped;
+	int m_maxHandCards;
+	int m_maxCards;
+	uint64_t m_slotMask;
+	const uint8_t* m_slots;
+	const uint8_t* m_values;
+};
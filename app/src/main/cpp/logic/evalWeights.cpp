@@ -0,0 +1,128 @@
+#include "evalWeights.h"
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include "moveGen.h"
+#include "rng.h"
+
+namespace
+{
+	const char* FEATURE_NAMES[NUM_OF_FEATURES] = { "cards", "diamonds", "sevens", "sixes", "seven_of_diamonds", "sweep",
+		"exposed_cards", "exposed_diamonds", "exposed_sevens", "sweep_risk", "drop_rank" };
+	const double DEFAULT_WEIGHTS[NUM_OF_FEATURES] = { 1, 3, 12, 4, 30, 200, 0, 0, 0, 0, -1 };
+	const int MAX_LINE = 256;
+}
+
+EvalWeights EvalWeights::defaults()
+{
+	EvalWeights weights;
+	for (int i = 0; i < NUM_OF_FEATURES; ++i)
+	{
+		weights.weights[i] = DEFAULT_WEIGHTS[i];
+	}
+	return weights;
+}
+
+const char* EvalWeights::featureName(int feature)
+{
+	return FEATURE_NAMES[feature];
+}
+
+void EvalWeights::features(Move move, CardMask boardMask, int* out)
+{
+	CardMask played = cardBit(move.getCard());
+	CardMask taken = move.isDrop() ? EMPTY_MASK : move.getCaptured() | played;
+	CardMask left = move.isDrop() ? boardMask | played : boardMask & ~move.getCaptured();
+	out[FEATURE_CARDS] = countCards(taken);
+	out[FEATURE_DIAMONDS] = countCards(taken & suitMask(Card::D));
+	out[FEATURE_SEVENS] = countCards(taken & rankMask(7));
+	out[FEATURE_SIXES] = countCards(taken & rankMask(6));
+	out[FEATURE_SEVEN_OF_DIAMONDS] = (taken & cardBit(cardIndexOf(Card::D, 7))) ? 1 : 0;
+	out[FEATURE_SWEEP] = !move.isDrop() && left == EMPTY_MASK ? 1 : 0;
+	out[FEATURE_EXPOSED_CARDS] = countCards(left);
+	out[FEATURE_EXPOSED_DIAMONDS] = countCards(left & suitMask(Card::D));
+	out[FEATURE_EXPOSED_SEVENS] = countCards(left & rankMask(7));
+	out[FEATURE_SWEEP_RISK] = left != EMPTY_MASK && MoveGen::sumOfRanks(left) <= MAX_RANK ? 1 : 0;
+	out[FEATURE_DROP_RANK] = move.isDrop() ? rankOfIndex(move.getCard()) : 0;
+}
+
+double EvalWeights::evaluate(Move move, CardMask boardMask) const
+{
+	int values[NUM_OF_FEATURES];
+	features(move, boardMask, values);
+	double value = 0;
+	for (int i = 0; i < NUM_OF_FEATURES; ++i)
+	{
+		value += weights[i] * values[i];
+	}
+	return value;
+}
+
+bool EvalWeights::load(const std::string& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "r");
+	if (!file)
+	{
+		return false;
+	}
+	EvalWeights loaded = *this;
+	char line[MAX_LINE];
+	bool ok = true;
+	while (ok && std::fgets(line, sizeof(line), file))
+	{
+		char* comment = std::strchr(line, '#');
+		if (comment)
+		{
+			*comment = '\0';
+		}
+		char name[MAX_LINE];
+		double value;
+		int fields = std::sscanf(line, "%255s %lf", name, &value);
+		if (fields <= 0)	//blank line
+		{
+			continue;
+		}
+		ok = false;
+		for (int i = 0; fields == 2 && i < NUM_OF_FEATURES; ++i)
+		{
+			if (std::strcmp(name, FEATURE_NAMES[i]) == 0)
+			{
+				loaded.weights[i] = value;
+				ok = true;
+			}
+		}
+	}
+	std::fclose(file);
+	if (ok)
+	{
+		*this = loaded;
+	}
+	return ok;
+}
+
+bool EvalWeights::save(const std::string& path) const
+{
+	std::FILE* file = std::fopen(path.c_str(), "w");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = std::fprintf(file, "# GameBot evaluation weights (logic/evalWeights.h)\n") > 0;
+	for (int i = 0; ok && i < NUM_OF_FEATURES; ++i)
+	{
+		ok = std::fprintf(file, "%s %.17g\n", FEATURE_NAMES[i], weights[i]) > 0;
+	}
+	return std::fclose(file) == 0 && ok;
+}
+
+uint64_t EvalWeights::hash() const
+{
+	uint64_t hash = 0;
+	for (int i = 0; i < NUM_OF_FEATURES; ++i)
+	{
+		uint64_t bits;
+		std::memcpy(&bits, &weights[i], sizeof(bits));
+		hash = mixSeed(hash ^ bits);
+	}
+	return hash;
+}
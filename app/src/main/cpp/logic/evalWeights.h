@@ -0,0 +1,38 @@
+#pragma once
+#include <string>
+#include "move.h"
+
+// what a move does, from the mover's side: the cards it takes into the pile by Round::countPiles category,
+// and what it leaves on the board for the other player
+enum evalFeature
+{
+	FEATURE_CARDS,	//cards into the pile, the played card included
+	FEATURE_DIAMONDS,
+	FEATURE_SEVENS,
+	FEATURE_SIXES,	//break a tie on sevens
+	FEATURE_SEVEN_OF_DIAMONDS,
+	FEATURE_SWEEP,	//takes the whole board
+	FEATURE_EXPOSED_CARDS,	//on the board afterwards
+	FEATURE_EXPOSED_DIAMONDS,
+	FEATURE_EXPOSED_SEVENS,
+	FEATURE_SWEEP_RISK,	//the board afterwards sums to a rank, one card can sweep it
+	FEATURE_DROP_RANK,	//the rank of a dropped card, 0 for a capture
+	NUM_OF_FEATURES
+};
+
+// GameBot's evaluation, a move is worth sum(weight * feature). the defaults roughly keep the old fixed priority
+// order (sweep, sevens, six of diamonds, diamonds, then the lowest drop) and are a starting point for shkuba_tune.
+// parameter file: a "name value" line per weight, # starts a comment, weights not in the file keep their value.
+struct EvalWeights
+{
+	double weights[NUM_OF_FEATURES];
+
+	static EvalWeights defaults();
+	static const char* featureName(int feature);
+	static void features(Move move, CardMask boardMask, int* out);	//NUM_OF_FEATURES values
+
+	double evaluate(Move move, CardMask boardMask) const;
+	bool load(const std::string& path);	//false, and nothing changed, if the file can't be read or has an unknown name
+	bool save(const std::string& path) const;
+	uint64_t hash() const;	//tells weight sets apart, e.g. in a shared DecisionCache
+};
@@ -1,5 +1,9 @@
 #include "game.h"
 
+Game::Game(players startingPlayer) : firstPlayer(startingPlayer), p1Points(0), p2Points(0)
+{
+}
+
 void Game::changeFirstPlayer()
 {
 	if (firstPlayer == P1)
@@ -20,4 +24,29 @@ void Game::addToP1Points(int points)
 void Game::addToP2Points(int points)
 {
 	p2Points += points;
-}
\ No newline at end of file
+}
+
+int Game::getP1Points() const
+{
+	return p1Points;
+}
+
+int Game::getP2Points() const
+{
+	return p2Points;
+}
+
+players Game::getFirstPlayer() const
+{
+	return firstPlayer;
+}
+
+bool Game::isOver(int targetPoints) const
+{
+	return (p1Points >= targetPoints || p2Points >= targetPoints) && p1Points != p2Points;
+}
+
+players Game::getWinner() const
+{
+	return p1Points > p2Points ? P1 : P2;
+}
@@ -1,11 +1,19 @@
 #pragma once
 #include "round.h"
 
+const int WINNING_POINTS = 21;
+
 class Game {
 public:
+	Game(players startingPlayer = P1);
 	void changeFirstPlayer();
 	void addToP1Points(int points);
 	void addToP2Points(int points);
+	int getP1Points() const;
+	int getP2Points() const;
+	players getFirstPlayer() const;
+	bool isOver(int targetPoints = WINNING_POINTS) const;	//someone reached the target and nobody is tied with him
+	players getWinner() const;
 
 private:
 
@@ -1,6 +1,15 @@
 #include "gameBot.h"
+#include <utility>
+#include "suitSymmetry.h"
+#include "trace.h"
 
-GameBot::GameBot()
+namespace
+{
+	const uint64_t CACHE_CONTEXT = 0x4752'4545'4459ULL;	//"GREEDY", keeps these decisions apart from other users of a shared cache
+}
+
+GameBot::GameBot(DecisionCache* cache, const EvalWeights& weights, std::shared_ptr<const LearnedEval> leafEval) :
+	m_endgame(), m_cache(cache), m_weights(weights), m_cacheContext(CACHE_CONTEXT ^ weights.hash()), m_leafEval(std::move(leafEval))
 {
 }
 
@@ -19,167 +28,91 @@ void GameBot::botDropCard(Hand& botHand, Board& board)	//will improve later
 
 void GameBot::playCard(Hand botHand, Board board)
 {
-	// Implement the logic for the bot to decide which cards to play
-	if (board.getBoardSize() == 0)
+	Move move = chooseMove(botHand, board);
+	Card played(move.getCard());
+	botHand.removeFromHand(played);
+	if (move.isDrop())
+	{
+		board.addToBoard(played); // If no matches found, drop the lowest card
+	}
+	else
+	{
+		board.removeMask(move.getCaptured());
+	}
+}
+
+Move GameBot::chooseMove(const Round& round)
+{
+	TRACE_SCOPE("GameBot::chooseMove");
+	if (EndgameSolver::canSolve(round))
 	{
-		botDropCard(botHand, board);
-		return; // If no cards on the board, drop the lowest card
+		return m_endgame.solve(round);
 	}
-	int sumBoard = 0;
-	int sevenInHandIndex = -1;
-	int sixInHandIndex = -1;
-	int sevenOnBoardIndex = -1;
-	int sixOnBoardIndex = -1;
-	int matchIndexBoardDiamond = -1;
-	int matchIndexHandDiamond = -1;
-	int matchIndexBoard = -1;
-	int matchIndexHand = -1;
-	int bestHandIdx = -1;
-	std::vector<int> bestCombo;
-	for (int i = 0; i < board.getBoardSize(); ++i)
+	if (m_leafEval)
 	{
-		sumBoard += board.getCardByIndex(i).getRank();
+		return bestLearnedMove(round);
+	}
+	return chooseMove(round.getHand(round.getTurn()), round.getBoard());
+}
 
-		for (int j = 0; j < botHand.getHandSize(); ++j)
+Move GameBot::bestLearnedMove(const Round& round)
+{
+	players mover = round.getTurn();
+	int numOfMoves = MoveGen::generate(round, m_moves, MAX_MOVES);
+	Round next = round;
+	Move bestMove = numOfMoves > 0 ? m_moves[0] : Move();
+	float bestValue = 0;
+	for (int i = 0; i < numOfMoves; ++i)
+	{
+		MoveUndo undo = next.makeMove(m_moves[i]);
+		float value = m_leafEval->evaluate(next, mover);
+		next.unmakeMove(m_moves[i], undo);
+		if (i == 0 || value > bestValue)
 		{
-			if (botHand.getCardByIndex(j).getRank() == board.getCardByIndex(i).getRank())
-			{
-				if (board.getCardByIndex(i).getRank() == 7)
-				{
-					if (board.getCardByIndex(i).getSuit() == Card::D||botHand.getCardByIndex(j).getSuit()==Card::D) // Prefer 7 of Diamonds if available
-					{
-						sevenInHandIndex = j;
-						sevenOnBoardIndex = i;
-					}
-					else if (sevenInHandIndex == -1) // If no 7 of Diamonds, just play any 7
-					{
-						sevenInHandIndex = j;
-						sevenOnBoardIndex = i;
-					}
-				}
-				else if (board.getCardByIndex(i).getRank() == 6)
-				{
-					if (board.getCardByIndex(i).getSuit() == Card::D|| botHand.getCardByIndex(j).getSuit()==Card::D) // Prefer 6 of Diamonds if available
-					{
-						sixOnBoardIndex = i;
-						sixInHandIndex = j;
-					}
-				}
-				else if (board.getCardByIndex(i).getSuit() == Card::D || botHand.getCardByIndex(j).getSuit() == Card::D)
-				{
-					matchIndexBoardDiamond = i; // Match found for Diamonds on board
-					matchIndexHandDiamond = j; // Match found for Diamonds in hand
-				}
-				else
-				{
-					matchIndexBoard = i; // Match found for other suits on board
-					matchIndexHand = j; // Match found for other suits in hand
-				}
-				
-				int maxComboSize = 0;
-				bool foundComboWith7InHand = false;
-				bool foundComboWith7OnBoard = false;
+			bestValue = value;
+			bestMove = m_moves[i];
+		}
+	}
+	return bestMove;
+}
 
-				for (int handIdx = 0; handIdx < botHand.getHandSize(); ++handIdx) {
-					Card handCard = botHand.getCardByIndex(handIdx);
-					int boardSize = board.getBoardSize();
-					int combos = 1 << boardSize;
+Move GameBot::chooseMove(const Hand& botHand, const Board& board)
+{
+	if (!m_cache)
+	{
+		return bestMove(botHand, board);
+	}
 
-					for (int mask = 1; mask < combos; ++mask) {
-						std::vector<int> combo;
-						int sum = 0;
-						bool comboHas7OnBoard = false;
-						for (int b = 0; b < boardSize; ++b) {
-							if (mask & (1 << b)) {
-								Card boardCard = board.getCardByIndex(b);
-								sum += boardCard.getRank();
-								combo.push_back(b);
-								if (boardCard.getRank() == 7) {
-									comboHas7OnBoard = true;
-								}
-							}
-						}
-						if (combo.size() <= 1) continue;
+	// with a cache the move is always worked out in the canonical position, so a hit and a miss give the same move
+	CardMask masks[2] = { botHand.getMask(), board.getMask() };
+	int permutation = SuitSymmetry::canonicalPermutation(masks, 2);
+	masks[0] = SuitSymmetry::apply(masks[0], permutation);
+	masks[1] = SuitSymmetry::apply(masks[1], permutation);
+	DecisionCache::Key key = DecisionCache::keyOf(masks, 2, m_cacheContext);
+	Move move;
+	if (!m_cache->find(key, move))
+	{
+		Board canonicalBoard;
+		canonicalBoard.addMask(masks[1]);
+		move = bestMove(Hand(masks[0]), canonicalBoard);
+		m_cache->store(key, move);
+	}
+	return SuitSymmetry::apply(move, SuitSymmetry::inverse(permutation));
+}
 
-						if (sum == handCard.getRank()) {
-							// 1priority: 7 in hand	
-							if (handCard.getRank() == 7) {
-								if (!foundComboWith7InHand || combo.size() > maxComboSize) {
-									bestHandIdx = handIdx;
-									bestCombo = combo;
-									maxComboSize = combo.size();
-									foundComboWith7InHand = true;
-								}
-							}
-							// 2priority: 7 on board 
-							else if (comboHas7OnBoard) {
-								if (!foundComboWith7InHand && (!foundComboWith7OnBoard || combo.size() > maxComboSize)) {
-									bestHandIdx = handIdx;
-									bestCombo = combo;
-									maxComboSize = combo.size();
-									foundComboWith7OnBoard = true;
-								}
-							}
-							// 3priority: other combos
-							else if (!foundComboWith7InHand && !foundComboWith7OnBoard) {
-								if (combo.size() > maxComboSize) {
-									bestHandIdx = handIdx;
-									bestCombo = combo;
-									maxComboSize = combo.size();
-								}
-							}
-							else if (!foundComboWith7InHand && !foundComboWith7OnBoard && combo.size() > maxComboSize) {
-								bestHandIdx = handIdx;
-								bestCombo = combo;
-								maxComboSize = combo.size();
-							}
-						}
-					}
-				}
-				for (int i = 0; i < botHand.getHandSize(); ++i) 
-				{
-					if (sumBoard == botHand.getCardByIndex(i).getRank()) 
-					{
-						std::vector<int> v(i);
-						std::iota(v.begin(), v.end(), 1);
-						botHand.playCard(j, v, board); // Play the card that matches the board
-						return; // Exit after playing a card
-					}
-				}
-				if (sevenInHandIndex != -1) 
-				{
-					botHand.playCard(sevenInHandIndex, { sevenOnBoardIndex }, board); // Play the 7 that matches the board
-					return;
-				}
-				else if (bestHandIdx != -1) {
-					botHand.playCard(bestHandIdx, bestCombo, board);
-					return;
-				}
-				else if (sixInHandIndex != -1)
-				{
-					botHand.playCard(sixInHandIndex, { sixOnBoardIndex }, board); // Play the 6 that matches the board
-					return;
-				}
-				else if(matchIndexBoardDiamond != -1) 
-				{
-					botHand.playCard(matchIndexHandDiamond, { matchIndexBoardDiamond }, board); // Play the card that matches Diamonds
-					return;
-				}
-				else if (matchIndexBoard != -1) 
-				{
-					botHand.playCard(matchIndexHand, { matchIndexBoard }, board); // Play the card that matches other suits
-					return;
-				}
-				else 
-				{
-					botDropCard(botHand, board); // If no matches found, drop the lowest card
-				}
-				
-				
-			}
+Move GameBot::bestMove(const Hand& botHand, const Board& board)
+{
+	int numOfMoves = MoveGen::generate(botHand, board, m_moves, MAX_MOVES);
+	Move bestMove = numOfMoves > 0 ? m_moves[0] : Move();
+	double bestValue = numOfMoves > 0 ? m_weights.evaluate(m_moves[0], board.getMask()) : 0;
+	for (int i = 1; i < numOfMoves; ++i)
+	{
+		double value = m_weights.evaluate(m_moves[i], board.getMask());
+		if (value > bestValue)
+		{
+			bestValue = value;
+			bestMove = m_moves[i];
 		}
-
-		
 	}
-	
+	return bestMove;
 }
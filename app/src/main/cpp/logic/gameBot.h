@@ -1,17 +1,36 @@
 #pragma once
+#include <memory>
 #include "card.h"
 #include "hand.h"
-#include <numeric> // For std::iota
+#include "moveGen.h"
+#include "bot.h"
+#include "endgameSolver.h"
+#include "decisionCache.h"
+#include "evalWeights.h"
+#include "learnedEval.h"
 
 
-class GameBot
+class GameBot : public Bot
 {
 
 public:
-	GameBot();
+	//the cache may be shared with other bots and threads. with a leaf evaluator chooseMove(round) plays every move
+	//and keeps the one whose position it rates best, the weights are only used without a round
+	explicit GameBot(DecisionCache* cache = nullptr, const EvalWeights& weights = EvalWeights::defaults(),
+		std::shared_ptr<const LearnedEval> leafEval = nullptr);
 	void botDropCard(Hand& botHand, Board& board);
 	void playCard(Hand botHand, Board board); //this will add to the playCard func in Hand class.
+	Move chooseMove(const Hand& botHand, const Board& board);
+	Move chooseMove(const Round& round) override;	//solved exactly once the deck is empty
 
 private:
-	
+	Move bestMove(const Hand& botHand, const Board& board);
+	Move bestLearnedMove(const Round& round);
+
+	Move m_moves[MAX_MOVES];
+	EndgameSolver m_endgame;
+	DecisionCache* m_cache;
+	EvalWeights m_weights;
+	uint64_t m_cacheContext;	//bots with other weights may share the cache
+	std::shared_ptr<const LearnedEval> m_leafEval;
 };
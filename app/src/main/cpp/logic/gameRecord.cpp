@@ -0,0 +1,130 @@
+#include "gameRecord.h"
+
+namespace
+{
+	const int CARD_BITS = 6;
+	const uint8_t CARD_MASK = (1 << CARD_BITS) - 1;
+	const int SUBSET_BYTES[4] = { 0, 1, 2, 5 };
+}
+
+RoundRecord::RoundRecord() : m_numOfMoves(0)
+{
+}
+
+void RoundRecord::begin(int flags)
+{
+	m_bytes.clear();
+	m_numOfMoves = 0;
+	m_bytes.push_back(static_cast<uint8_t>(flags));
+	writeLittleEndian(0, 3);	//moves and their size, filled in by addMove
+}
+
+void RoundRecord::beginSeeded(players firstPlayer, bool takeStartCard, uint64_t deckSeed, uint64_t deckStream)
+{
+	begin((firstPlayer == P2 ? RECORD_P2_FIRST : 0) | (takeStartCard ? RECORD_START_CARD_TAKEN : 0));
+	writeLittleEndian(deckSeed, 8);
+	writeLittleEndian(deckStream, 8);
+}
+
+void RoundRecord::beginDealt(const Round& round, bool takeStartCard)
+{
+	begin((round.getFirstPlayer() == P2 ? RECORD_P2_FIRST : 0) | (takeStartCard ? RECORD_START_CARD_TAKEN : 0) | RECORD_EXPLICIT_DEAL);
+	uint8_t drawOrder[NUM_OF_CARDS];
+	round.getDrawOrder(drawOrder);
+	m_bytes.insert(m_bytes.end(), drawOrder, drawOrder + NUM_OF_CARDS);
+}
+
+void RoundRecord::addMove(Move move, CardMask boardBefore)
+{
+	uint8_t encoded[MAX_ENCODED_MOVE];
+	int size = encodeMove(move, boardBefore, encoded);
+	m_bytes.insert(m_bytes.end(), encoded, encoded + size);
+	++m_numOfMoves;
+	int moveBytes = m_bytes.size() - RECORD_ROUND_HEADER_SIZE - ((m_bytes[0] & RECORD_EXPLICIT_DEAL) ? NUM_OF_CARDS : 16);
+	m_bytes[1] = static_cast<uint8_t>(m_numOfMoves);
+	m_bytes[2] = static_cast<uint8_t>(moveBytes);
+	m_bytes[3] = static_cast<uint8_t>(moveBytes >> 8);
+}
+
+const uint8_t* RoundRecord::getData() const
+{
+	return m_bytes.data();
+}
+
+int RoundRecord::getSize() const
+{
+	return m_bytes.size();
+}
+
+int RoundRecord::getNumOfMoves() const
+{
+	return m_numOfMoves;
+}
+
+int RoundRecord::encodeMove(Move move, CardMask board, uint8_t* out)
+{
+	// gather the taken cards into bits over the board cards
+	uint64_t subset = 0;
+	int position = 0;
+	for (CardMask rest = board, left = move.getCaptured(); left && rest; ++position)
+	{
+		CardMask lowest = popLowestCard(rest);
+		if (lowest & left)
+		{
+			subset |= uint64_t(1) << position;
+			left &= ~lowest;
+		}
+	}
+	int kind = subset == 0 ? 0 : (subset < (1u << 8) ? 1 : (subset < (1u << 16) ? 2 : 3));
+	out[0] = static_cast<uint8_t>(move.getCard() | (kind << CARD_BITS));
+	for (int i = 0; i < SUBSET_BYTES[kind]; ++i)
+	{
+		out[1 + i] = static_cast<uint8_t>(subset >> (8 * i));
+	}
+	return 1 + SUBSET_BYTES[kind];
+}
+
+bool RoundRecord::decodeMove(const uint8_t*& in, const uint8_t* end, CardMask board, Move& move)
+{
+	if (in >= end)
+	{
+		return false;
+	}
+	int card = in[0] & CARD_MASK;
+	int kind = in[0] >> CARD_BITS;
+	if (end - in < 1 + SUBSET_BYTES[kind])
+	{
+		return false;
+	}
+	uint64_t subset = 0;
+	for (int i = 0; i < SUBSET_BYTES[kind]; ++i)
+	{
+		subset |= uint64_t(in[1 + i]) << (8 * i);
+	}
+
+	// scatter the subset bits onto the board cards
+	CardMask captured = EMPTY_MASK;
+	for (CardMask rest = board; subset && rest; subset >>= 1)
+	{
+		CardMask lowest = popLowestCard(rest);
+		if (subset & 1)
+		{
+			captured |= lowest;
+		}
+	}
+	if (subset != 0 || card >= NUM_OF_CARDS)	//bits past the last board card, or no such card
+	{
+		return false;
+	}
+	in += 1 + SUBSET_BYTES[kind];
+	move = Move(card, captured);
+	return true;
+}
+
+void RoundRecord::writeLittleEndian(uint64_t value, int bytes)
+{
+	for (int i = 0; i < bytes; ++i)
+	{
+		m_bytes.push_back(static_cast<uint8_t>(value >> (8 * i)));
+	}
+}
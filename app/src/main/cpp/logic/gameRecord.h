@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <vector>
+#include "round.h"
+
+// binary game records. a file is a RECORD_HEADER_SIZE header ("SHKR", version) and then round blocks:
+//   uint8   flags: bit 0 first player, bit 1 start card taken, bit 2 explicit deal
+//   uint8   number of moves
+//   uint16  size of the moves in bytes
+//   deal:   uint64 seed + uint64 stream of Deck(seed, stream), or NUM_OF_CARDS card indices in deal order
+//   moves
+// a move is one byte for a drop: the card index, and one more byte for most captures: the taken
+// cards as a bit set over the board cards in index order (bit i = i-th board card). the top two bits of
+// the first byte say how many such bytes follow (0, 1, 2 or 5). numbers are little endian.
+// new hands are dealt whenever both hands are empty, so deals are not stored.
+
+const char RECORD_MAGIC[4] = { 'S', 'H', 'K', 'R' };
+const uint16_t RECORD_VERSION = 1;
+const int RECORD_HEADER_SIZE = 8;
+const int RECORD_ROUND_HEADER_SIZE = 4;
+const int MAX_ENCODED_MOVE = 6;
+
+enum recordFlags { RECORD_P2_FIRST = 1, RECORD_START_CARD_TAKEN = 2, RECORD_EXPLICIT_DEAL = 4 };
+
+// one round being recorded. begin, add every move before it is made, then hand it to a RecordWriter.
+class RoundRecord
+{
+public:
+	RoundRecord();
+	void beginSeeded(players firstPlayer, bool takeStartCard, uint64_t deckSeed, uint64_t deckStream);
+	void beginDealt(const Round& round, bool takeStartCard);	//round before firstMiniRound
+	void addMove(Move move, CardMask boardBefore);
+	const uint8_t* getData() const;	//the complete block
+	int getSize() const;
+	int getNumOfMoves() const;
+
+	static int encodeMove(Move move, CardMask board, uint8_t* out);	//returns the bytes written
+	static bool decodeMove(const uint8_t*& in, const uint8_t* end, CardMask board, Move& move);	//advances in past the move. false, in unchanged, if it would cross end or doesn't fit the board
+
+private:
+	void begin(int flags);
+	void writeLittleEndian(uint64_t value, int bytes);
+
+	std::vector<uint8_t> m_bytes;
+	int m_numOfMoves;
+};
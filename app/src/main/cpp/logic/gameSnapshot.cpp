@@ -0,0 +1,38 @@
+#include "gameSnapshot.h"
+
+GameSnapshot GameSnapshot::capture(const Game& game, const Round& round)
+{
+	GameSnapshot snapshot = {};
+	snapshot.version = SNAPSHOT_VERSION;
+	snapshot.turn = static_cast<uint8_t>(round.getTurn());
+	snapshot.firstPlayer = static_cast<uint8_t>(round.getFirstPlayer());
+	snapshot.deckSize = static_cast<uint8_t>(round.getDeckSize());
+	snapshot.hands[P1] = round.getHand(P1).getMask();
+	snapshot.hands[P2] = round.getHand(P2).getMask();
+	snapshot.board = round.getBoard().getMask();
+	snapshot.piles[P1] = round.getP1Pile();
+	snapshot.piles[P2] = round.getP2Pile();
+
+	CardMask startCard = round.getStartCard().getMask();
+	bool dealt = (snapshot.hands[P1] | snapshot.hands[P2] | snapshot.board | snapshot.piles[P1] | snapshot.piles[P2]) & startCard;
+	snapshot.startCard = dealt ? NO_CARD : static_cast<uint8_t>(round.getStartCard().getIndex());
+
+	snapshot.gamePoints[P1] = game.getP1Points();
+	snapshot.gamePoints[P2] = game.getP2Points();
+	RoundScore score = round.getLiveScore();
+	for (int player = P1; player <= P2; ++player)
+	{
+		for (int i = 0; i < NUM_OF_SCORE_CATEGORIES; ++i)
+		{
+			snapshot.roundPoints[player][i] = score.points[player][i];
+		}
+	}
+	return snapshot;
+}
+
+GameSnapshot GameSnapshot::viewedBy(players viewer) const
+{
+	GameSnapshot view = *this;
+	view.hands[viewer == P1 ? P2 : P1] = EMPTY_MASK;
+	return view;
+}
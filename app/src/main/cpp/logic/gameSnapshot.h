@@ -0,0 +1,26 @@
+#pragma once
+#include "game.h"
+
+const uint32_t SNAPSHOT_VERSION = 1;
+const uint8_t NO_CARD = 0xFF;
+
+// everything the UI shows, in one trivially copyable block with a fixed layout
+// (little endian on every target we ship), so it can cross JNI or the network as raw bytes.
+struct GameSnapshot
+{
+	uint32_t version;
+	uint8_t turn;
+	uint8_t firstPlayer;
+	uint8_t deckSize;
+	uint8_t startCard;	//NO_CARD once it is no longer on its own
+	CardMask hands[2];
+	CardMask board;
+	CardMask piles[2];
+	int32_t gamePoints[2];
+	int32_t roundPoints[2][NUM_OF_SCORE_CATEGORIES];	//live standing, see Round::getLiveScore
+
+	static GameSnapshot capture(const Game& game, const Round& round);
+	GameSnapshot viewedBy(players viewer) const;	//the other hand cleared: what may be sent to the viewer's device
+};
+
+static_assert(sizeof(GameSnapshot) == 96, "GameSnapshot layout is shared with NativeBridge.kt (EngineState.SIZE_BYTES)");
@@ -1,33 +1,32 @@
 #include "hand.h"
+#include "moveGen.h"
 
-Hand::Hand()
+Hand::Hand() : cardsInHand(EMPTY_MASK)
 {
 }
 
-Hand::status Hand::playCard(int cardIndex, std::vector<int> cardsToTake, Board& myBoard) //to implement in game: pile+=cards from hand and board
+Hand::Hand(CardMask cards) : cardsInHand(cards)
+{
+}
+
+Hand::status Hand::playCard(int cardIndex, const std::vector<int>& cardsToTake, Board& myBoard) //to implement in game: pile+=cards from hand and board
 {
 	//checks:
-	int sumCards = 0;
-	for (int i = 1; i < cardsToTake.size(); ++i)
+	Card played = getCardByIndex(cardIndex);
+	CardMask captured = EMPTY_MASK;
+	for (int boardIndex : cardsToTake)
 	{
-		sumCards += myBoard.getCardByIndex(cardsToTake[i]).getRank();
+		captured |= myBoard.getCardByIndex(boardIndex).getMask();
 	}
-	if (sumCards != cardsInHand[cardIndex].getRank())
+	if (countCards(captured) > 1 && myBoard.countRank(played.getRank()) > 0)
 	{
-		return STATUS_ERROR_NOT_FIT;
+		return STATUS_ERROR_CARD_EXIST;
 	}
-
-	for (int i = 0; i < myBoard.getBoardSize(); ++i)
+	if (captured == EMPTY_MASK || !MoveGen::isLegal(*this, myBoard, Move(played.getIndex(), captured)))
 	{
-		if (myBoard.getCardByIndex(i).getRank() == cardsInHand[cardIndex].getRank())
-		{
-			if (cardsToTake.size() > 1)
-			{
-				return STATUS_ERROR_CARD_EXIST;
-			}
-		}
+		return STATUS_ERROR_NOT_FIT;
 	}
-	cardsInHand.erase(cardsInHand.begin()+cardIndex);
+	removeFromHand(played);
 
 	return STATUS_OK;
 
@@ -36,24 +35,35 @@ Hand::status Hand::playCard(int cardIndex, std::vector<int> cardsToTake, Board&
 
 Hand::status Hand::dropCard(int cardIndex, Board& myBoard)
 {
-	myBoard.addToBoard(cardsInHand[cardIndex]);
-	cardsInHand.erase(cardsInHand.begin() + cardIndex);
+	Card dropped = getCardByIndex(cardIndex);
+	myBoard.addToBoard(dropped);
+	removeFromHand(dropped);
 	return STATUS_OK;
 }
 
 void Hand::addToHand(Card cardToAdd)
 {
-	cardsInHand.push_back(cardToAdd);
+	cardsInHand |= cardToAdd.getMask();
+}
+
+void Hand::removeFromHand(Card cardToRemove)
+{
+	cardsInHand &= ~cardToRemove.getMask();
 }
 
 Card Hand::getCardByIndex(int i) const
 {
-	return cardsInHand[i];
+	return Card(nthCard(cardsInHand, i));
 }
 
 int Hand::getHandSize() const
 {
-	return cardsInHand.size();
+	return countCards(cardsInHand);
+}
+
+CardMask Hand::getMask() const
+{
+	return cardsInHand;
 }
 
 
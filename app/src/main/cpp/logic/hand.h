@@ -10,15 +10,18 @@ public:
 	enum status{STATUS_OK,STATUS_ERROR_NOT_FIT, STATUS_ERROR_CARD_EXIST};
 	
 	Hand();
-	status playCard(int cardIndex, std::vector<int> cardsToTake, Board& myBoard);
+	explicit Hand(CardMask cards);
+	status playCard(int cardIndex, const std::vector<int>& cardsToTake, Board& myBoard);	//only checks the move, see MoveGen for the rules
 	status dropCard(int cardIndex,Board& myBoard);	//now only returns OK, in later versions we will check if possible.
 	void addToHand(Card cardToAdd);
-	Card getCardByIndex(int i) const;
+	void removeFromHand(Card cardToRemove);
+	Card getCardByIndex(int i) const;	//cards are ordered by their card index
 	int getHandSize() const;
+	CardMask getMask() const;
 	
 	
 
 private:
-	std::vector<Card> cardsInHand;
+	CardMask cardsInHand;
 
-};
\ No newline at end of file
+};
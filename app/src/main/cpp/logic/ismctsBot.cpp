@@ -0,0 +1,248 @@
+#include "ismctsBot.h"
+#include <chrono>
+#include <cmath>
+#include "trace.h"
+
+namespace
+{
+	const int NO_NODE = -1;
+	const double MAX_POINTS_DIFF = 8.0;	//round point difference that counts as a full win
+	const int CLOCK_CHECK_INTERVAL = 64;
+
+	int64_t nowNs()
+	{
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+	}
+
+	void dealIfNeeded(Round& state)
+	{
+		if (state.getHand(P1).getHandSize() == 0 && state.getHand(P2).getHandSize() == 0 && state.getDeckSize() > 0)
+		{
+			state.giveCardsToPlayers();
+		}
+	}
+}
+
+IsmctsBot::IsmctsBot(int numOfThreads, int iterations, int timeMs) :
+	m_pool(numOfThreads), m_endgame(), m_workers(m_pool.getSize()), m_iterations(iterations), m_timeMs(timeMs),
+	m_exploration(0.7), m_seed(0x5348'4B55'4241ULL), m_stopFlag(nullptr), m_searches(0), m_lastIterations(0)
+{
+	for (Worker& worker : m_workers)
+	{
+		worker.moves.resize(MAX_MOVES);
+	}
+}
+
+void IsmctsBot::setBudget(int iterations, int timeMs)
+{
+	m_iterations = iterations;
+	m_timeMs = timeMs;
+}
+
+void IsmctsBot::setSeed(uint64_t seed)
+{
+	m_seed = seed;
+	m_searches = 0;
+}
+
+void IsmctsBot::setExploration(double exploration)
+{
+	m_exploration = exploration;
+}
+
+void IsmctsBot::setStopFlag(const std::atomic<bool>* stop)
+{
+	m_stopFlag = stop;
+}
+
+int IsmctsBot::getLastIterations() const
+{
+	return m_lastIterations;
+}
+
+Move IsmctsBot::chooseMove(const Round& round)
+{
+	TRACE_SCOPE("IsmctsBot::chooseMove");
+	std::vector<Move>& rootMoves = m_workers[0].moves;
+	int numOfMoves = MoveGen::generate(round, rootMoves.data(), MAX_MOVES);
+	if (numOfMoves <= 1)
+	{
+		return numOfMoves == 1 ? rootMoves[0] : Move();
+	}
+	if (EndgameSolver::canSolve(round))
+	{
+		m_lastIterations = 0;
+		return m_endgame.solve(round);
+	}
+
+	int numOfWorkers = m_workers.size();
+	int iterationsPerWorker = m_iterations > 0 ? (m_iterations + numOfWorkers - 1) / numOfWorkers : 0;
+	int64_t deadline = m_timeMs > 0 ? nowNs() + int64_t(m_timeMs) * 1000000 : 0;
+	uint64_t searchSeed = mixSeed(m_seed + m_searches++);
+	m_pool.run(numOfWorkers, [&](int i)
+	{
+		search(m_workers[i], round, mixSeed(searchSeed + i), iterationsPerWorker, deadline);
+	});
+
+	// root parallel merge: sum the visits of the same move over all the trees
+	std::vector<Move> merged;
+	std::vector<uint64_t> visits;
+	std::vector<double> rewards;
+	m_lastIterations = 0;
+	int64_t rolloutMoves = 0;
+	for (int w = 0; w < numOfWorkers; ++w)
+	{
+		const std::vector<Node>& nodes = m_workers[w].nodes;
+		m_lastIterations += m_workers[w].iterations;
+		rolloutMoves += m_workers[w].rolloutMoves;
+		for (int child = nodes[0].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+		{
+			std::size_t i = 0;
+			while (i < merged.size() && merged[i] != nodes[child].move)
+			{
+				++i;
+			}
+			if (i == merged.size())
+			{
+				merged.push_back(nodes[child].move);
+				visits.push_back(0);
+				rewards.push_back(0);
+			}
+			visits[i] += nodes[child].visits;
+			rewards[i] += nodes[child].reward;
+		}
+	}
+
+	std::size_t best = 0;
+	for (std::size_t i = 1; i < merged.size(); ++i)
+	{
+		if (visits[i] > visits[best] || (visits[i] == visits[best] && rewards[i] > rewards[best]))
+		{
+			best = i;
+		}
+	}
+	TRACE_COUNTER("IsmctsBot.iterations", m_lastIterations);
+	TRACE_COUNTER("IsmctsBot.rolloutMoves", rolloutMoves);
+	return merged.empty() ? rootMoves[0] : merged[best];
+}
+
+void IsmctsBot::search(Worker& worker, const Round& root, uint64_t seed, int maxIterations, int64_t deadlineNs) const
+{
+	CounterRng rng(seed);
+	players me = root.getTurn();
+	std::vector<Node>& nodes = worker.nodes;
+	nodes.clear();
+	nodes.push_back({ Move(), NO_NODE, NO_NODE, NO_NODE, 0, 0, 0.0, me == P1 ? P2 : P1 });
+	worker.iterations = 0;
+	worker.rolloutMoves = 0;
+
+	while (maxIterations == 0 || worker.iterations < maxIterations)
+	{
+		if (deadlineNs != 0 && worker.iterations % CLOCK_CHECK_INTERVAL == 0 && nowNs() >= deadlineNs && worker.iterations > 0)
+		{
+			break;
+		}
+		if (m_stopFlag && m_stopFlag->load(std::memory_order_relaxed))
+		{
+			break;
+		}
+		Round state = root;
+		state.redealHiddenCards(me, rng);
+
+		// selection and expansion
+		int node = 0;
+		while (!state.isRoundOver())
+		{
+			dealIfNeeded(state);
+			int child = selectChild(worker, node, state, rng);
+			state.makeMove(nodes[child].move);
+			bool expanded = nodes[child].visits == 0;
+			node = child;
+			if (expanded)
+			{
+				break;
+			}
+		}
+
+		// random play to the end of the round
+		while (!state.isRoundOver())
+		{
+			dealIfNeeded(state);
+			int numOfMoves = MoveGen::generate(state, worker.moves.data(), MAX_MOVES);
+			state.makeMove(worker.moves[rng.below(numOfMoves)]);
+			++worker.rolloutMoves;
+		}
+		state.collectBoard();
+
+		double p1Reward = rewardFor(P1, state);
+		for (; node != NO_NODE; node = nodes[node].parent)
+		{
+			++nodes[node].visits;
+			nodes[node].reward += nodes[node].mover == P1 ? p1Reward : 1.0 - p1Reward;
+		}
+		++worker.iterations;
+	}
+}
+
+int IsmctsBot::selectChild(Worker& worker, int node, const Round& state, CounterRng& rng) const
+{
+	std::vector<Node>& nodes = worker.nodes;
+	Move* moves = worker.moves.data();
+	int numOfMoves = MoveGen::generate(state, moves, MAX_MOVES);
+
+	// every legal move that has no child yet is untried, move them to the front of the list
+	int numOfUntried = 0;
+	for (int i = 0; i < numOfMoves; ++i)
+	{
+		int child = nodes[node].firstChild;
+		while (child != NO_NODE && nodes[child].move != moves[i])
+		{
+			child = nodes[child].nextSibling;
+		}
+		if (child == NO_NODE)
+		{
+			std::swap(moves[i], moves[numOfUntried++]);
+		}
+	}
+
+	if (numOfUntried > 0)
+	{
+		Node added = { moves[rng.below(numOfUntried)], node, NO_NODE, nodes[node].firstChild, 0, 0, 0.0, state.getTurn() };
+		nodes.push_back(added);
+		int child = nodes.size() - 1;
+		nodes[node].firstChild = child;
+		++nodes[child].availability;
+		return child;
+	}
+
+	// UCB over the children that are legal in this deal
+	const Hand& hand = state.getHand(state.getTurn());
+	int best = NO_NODE;
+	double bestScore = -1.0;
+	for (int child = nodes[node].firstChild; child != NO_NODE; child = nodes[child].nextSibling)
+	{
+		if (!MoveGen::isLegal(hand, state.getBoard(), nodes[child].move))
+		{
+			continue;
+		}
+		Node& c = nodes[child];
+		++c.availability;
+		double score = c.reward / c.visits + m_exploration * std::sqrt(std::log(double(c.availability)) / c.visits);
+		if (score > bestScore)
+		{
+			bestScore = score;
+			best = child;
+		}
+	}
+	return best;
+}
+
+double IsmctsBot::rewardFor(players player, const Round& finished)
+{
+	int p1Points = 0;
+	int p2Points = 0;
+	finished.scorePiles(p1Points, p2Points);
+	double diff = player == P1 ? p1Points - p2Points : p2Points - p1Points;
+	double reward = 0.5 + diff / (2.0 * MAX_POINTS_DIFF);
+	return reward < 0.0 ? 0.0 : (reward > 1.0 ? 1.0 : reward);
+}
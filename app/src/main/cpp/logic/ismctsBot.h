@@ -0,0 +1,62 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <vector>
+#include "moveGen.h"
+#include "threadPool.h"
+#include "bot.h"
+#include "endgameSolver.h"
+
+// information set monte carlo tree search (single observer).
+// every iteration redeals the cards the bot can't see (Round::redealHiddenCards), walks the tree
+// only through moves that are legal in that deal and finishes the round with random play.
+// every thread grows its own tree and the root visit counts are summed at the end (root parallel).
+// once the deck is empty nothing is hidden any more and the move comes from EndgameSolver instead.
+class IsmctsBot : public Bot
+{
+public:
+	// iterations is the total over all threads, timeMs a wall clock limit. 0 means no limit, but not both.
+	IsmctsBot(int numOfThreads = 0, int iterations = 20000, int timeMs = 100);
+	Move chooseMove(const Round& round) override;
+	void setBudget(int iterations, int timeMs);
+	void setSeed(uint64_t seed) override;
+	void setExploration(double exploration);
+	void setStopFlag(const std::atomic<bool>* stop);	//the search ends early once *stop is set, nullptr for none
+	int getLastIterations() const;	//iterations the last search actually ran
+
+private:
+	struct Node
+	{
+		Move move;
+		int parent;
+		int firstChild;
+		int nextSibling;
+		uint32_t visits;
+		uint32_t availability;
+		double reward;	//sum of rewards, for the player who made the move
+		players mover;
+	};
+
+	struct Worker
+	{
+		std::vector<Node> nodes;
+		std::vector<Move> moves;
+		int iterations;
+		int rolloutMoves;	//moves generated in the random playouts
+	};
+
+	void search(Worker& worker, const Round& root, uint64_t seed, int maxIterations, int64_t deadlineNs) const;
+	int selectChild(Worker& worker, int node, const Round& state, CounterRng& rng) const;
+	static double rewardFor(players player, const Round& finished);
+
+	ThreadPool m_pool;
+	EndgameSolver m_endgame;
+	std::vector<Worker> m_workers;
+	int m_iterations;
+	int m_timeMs;
+	double m_exploration;
+	uint64_t m_seed;
+	const std::atomic<bool>* m_stopFlag;
+	uint64_t m_searches;
+	int m_lastIterations;
+};
@@ -0,0 +1,318 @@
+#include "learnedEval.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include "simd.h"
+
+namespace
+{
+	const char MODEL_MAGIC[4] = { 'S', 'H', 'K', 'N' };
+	const uint16_t MODEL_VERSION = 1;
+	const int MODEL_HEADER_SIZE = 16;
+
+	const int HAND_INPUTS = 0;
+	const int BOARD_INPUTS = NUM_OF_CARDS;
+	const int PILE_INPUTS = 2 * NUM_OF_CARDS;
+	const int OTHER_PILE_INPUTS = 3 * NUM_OF_CARDS;
+	const int KNOWN_INPUTS = 4 * NUM_OF_CARDS;
+	const int SWEEP_INPUTS = 5 * NUM_OF_CARDS;
+	const int MAX_SWEEP_DIFF = 3;
+	const int LAST_CAPTURE_INPUT = SWEEP_INPUTS + 2 * MAX_SWEEP_DIFF + 1;
+	const int DECK_INPUTS = LAST_CAPTURE_INPUT + 1;
+	const int DECK_BUCKET = 8;
+	const int DECK_BUCKETS = 4;
+
+	const int MAX_OUTPUT_WEIGHT = 127;
+	const float MAX_OUTPUT_SCALE = 256;	//output weights per 1.0, lower when a weight is bigger than 0.5
+
+	int addCards(CardMask cards, int first, uint16_t* active, int count)
+	{
+		for (; cards; cards &= cards - 1)
+		{
+			active[count++] = static_cast<uint16_t>(first + lowestCard(cards));
+		}
+		return count;
+	}
+
+	int16_t quantize(float value, float scale, int limit)
+	{
+		float scaled = std::round(value * scale);
+		return static_cast<int16_t>(std::max(-float(limit), std::min(float(limit), scaled)));
+	}
+
+	void writeLittleEndian(uint8_t* out, uint64_t value, int bytes)
+	{
+		for (int i = 0; i < bytes; ++i)
+		{
+			out[i] = static_cast<uint8_t>(value >> (8 * i));
+		}
+	}
+
+	uint64_t readLittleEndian(const uint8_t* in, int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; ++i)
+		{
+			value |= uint64_t(in[i]) << (8 * i);
+		}
+		return value;
+	}
+}
+
+LearnedEval::LearnedEval() : m_w1(LEARNED_INPUTS * LEARNED_HIDDEN, 0), m_b1(), m_w2(), m_b2(0), m_outputScale(1)
+{
+}
+
+int LearnedEval::encode(const Round& round, players viewer, uint16_t* active)
+{
+	players other = viewer == P1 ? P2 : P1;
+	int count = addCards(round.getHand(viewer).getMask(), HAND_INPUTS, active, 0);
+	count = addCards(round.getBoard().getMask(), BOARD_INPUTS, active, count);
+	count = addCards(viewer == P1 ? round.getP1Pile() : round.getP2Pile(), PILE_INPUTS, active, count);
+	count = addCards(viewer == P1 ? round.getP2Pile() : round.getP1Pile(), OTHER_PILE_INPUTS, active, count);
+	count = addCards(round.getKnowledge(viewer).getKnownInOpponentHand(), KNOWN_INPUTS, active, count);
+	int sweepDiff = std::max(-MAX_SWEEP_DIFF, std::min(MAX_SWEEP_DIFF, round.getSweeps(viewer) - round.getSweeps(other)));
+	active[count++] = static_cast<uint16_t>(SWEEP_INPUTS + MAX_SWEEP_DIFF + sweepDiff);
+	if (round.getLastCapturer() == viewer)
+	{
+		active[count++] = LAST_CAPTURE_INPUT;
+	}
+	active[count++] = static_cast<uint16_t>(DECK_INPUTS + std::min(round.getDeckSize() / DECK_BUCKET, DECK_BUCKETS - 1));
+	return count;
+}
+
+void LearnedEval::setWeights(const float* w1, const float* b1, const float* w2, float b2)
+{
+	for (int i = 0; i < LEARNED_INPUTS * LEARNED_HIDDEN; ++i)
+	{
+		m_w1[i] = quantize(w1[i], LEARNED_ACTIVATION_ONE, LEARNED_MAX_FIRST_LAYER);
+	}
+	float largest = 0;
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		m_b1[j] = quantize(b1[j], LEARNED_ACTIVATION_ONE, LEARNED_MAX_FIRST_LAYER);
+		largest = std::max(largest, std::fabs(w2[j]));
+	}
+	float outputWeightScale = largest > 0 ? std::min(MAX_OUTPUT_SCALE, MAX_OUTPUT_WEIGHT / largest) : MAX_OUTPUT_SCALE;
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		m_w2[j] = quantize(w2[j], outputWeightScale, MAX_OUTPUT_WEIGHT);
+	}
+	m_outputScale = 1 / (outputWeightScale * LEARNED_ACTIVATION_ONE);
+	m_b2 = static_cast<int32_t>(std::lround(b2 / m_outputScale));
+}
+
+bool LearnedEval::save(const std::string& path) const
+{
+	std::vector<uint8_t> bytes(MODEL_HEADER_SIZE + 4 + 2 * LEARNED_HIDDEN + LEARNED_HIDDEN + 2 * m_w1.size());
+	uint8_t* out = bytes.data();
+	std::memcpy(out, MODEL_MAGIC, sizeof(MODEL_MAGIC));
+	writeLittleEndian(out + 4, MODEL_VERSION, 2);
+	writeLittleEndian(out + 6, LEARNED_INPUTS, 2);
+	writeLittleEndian(out + 8, LEARNED_HIDDEN, 2);
+	writeLittleEndian(out + 10, 0, 2);
+	uint32_t scaleBits;
+	std::memcpy(&scaleBits, &m_outputScale, sizeof(scaleBits));
+	writeLittleEndian(out + 12, scaleBits, 4);
+	out += MODEL_HEADER_SIZE;
+	writeLittleEndian(out, static_cast<uint32_t>(m_b2), 4);
+	out += 4;
+	for (int j = 0; j < LEARNED_HIDDEN; ++j, out += 2)
+	{
+		writeLittleEndian(out, static_cast<uint16_t>(m_b1[j]), 2);
+	}
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		*out++ = static_cast<uint8_t>(static_cast<int8_t>(m_w2[j]));
+	}
+	for (std::size_t i = 0; i < m_w1.size(); ++i, out += 2)
+	{
+		writeLittleEndian(out, static_cast<uint16_t>(m_w1[i]), 2);
+	}
+
+	std::FILE* file = std::fopen(path.c_str(), "wb");
+	if (!file)
+	{
+		return false;
+	}
+	bool ok = std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+	return std::fclose(file) == 0 && ok;
+}
+
+bool LearnedEval::load(const std::string& path)
+{
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+	std::vector<uint8_t> bytes(MODEL_HEADER_SIZE + 4 + 2 * LEARNED_HIDDEN + LEARNED_HIDDEN + 2 * m_w1.size());
+	bool ok = std::fread(bytes.data(), 1, bytes.size(), file) == bytes.size() && std::fgetc(file) == EOF;
+	std::fclose(file);
+	const uint8_t* in = bytes.data();
+	if (!ok || std::memcmp(in, MODEL_MAGIC, sizeof(MODEL_MAGIC)) != 0 || readLittleEndian(in + 4, 2) != MODEL_VERSION ||
+		readLittleEndian(in + 6, 2) != LEARNED_INPUTS || readLittleEndian(in + 8, 2) != LEARNED_HIDDEN)
+	{
+		return false;
+	}
+	uint32_t scaleBits = static_cast<uint32_t>(readLittleEndian(in + 12, 4));
+	std::memcpy(&m_outputScale, &scaleBits, sizeof(m_outputScale));
+	in += MODEL_HEADER_SIZE;
+	m_b2 = static_cast<int32_t>(readLittleEndian(in, 4));
+	in += 4;
+	for (int j = 0; j < LEARNED_HIDDEN; ++j, in += 2)
+	{
+		m_b1[j] = static_cast<int16_t>(std::max<int>(-LEARNED_MAX_FIRST_LAYER, std::min<int>(LEARNED_MAX_FIRST_LAYER, static_cast<int16_t>(readLittleEndian(in, 2)))));
+	}
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		m_w2[j] = static_cast<int8_t>(*in++);
+	}
+	for (std::size_t i = 0; i < m_w1.size(); ++i, in += 2)
+	{
+		m_w1[i] = static_cast<int16_t>(std::max<int>(-LEARNED_MAX_FIRST_LAYER, std::min<int>(LEARNED_MAX_FIRST_LAYER, static_cast<int16_t>(readLittleEndian(in, 2)))));
+	}
+	return true;
+}
+
+float LearnedEval::evaluate(const Round& round, players viewer) const
+{
+	uint16_t active[LEARNED_MAX_ACTIVE];
+	int count = encode(round, viewer, active);
+	return evaluate(active, count);
+}
+
+#if defined(SHKUBA_SIMD_AVX2)
+
+float LearnedEval::evaluate(const uint16_t* active, int count) const
+{
+	__m256i low = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_b1));
+	__m256i high = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_b1 + 16));
+	for (int i = 0; i < count; ++i)
+	{
+		const int16_t* row = m_w1.data() + active[i] * LEARNED_HIDDEN;
+		low = _mm256_add_epi16(low, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row)));
+		high = _mm256_add_epi16(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + 16)));
+	}
+	const __m256i zero = _mm256_setzero_si256();
+	const __m256i one = _mm256_set1_epi16(LEARNED_ACTIVATION_ONE);
+	low = _mm256_max_epi16(_mm256_min_epi16(low, one), zero);
+	high = _mm256_max_epi16(_mm256_min_epi16(high, one), zero);
+	__m256i sums = _mm256_add_epi32(_mm256_madd_epi16(low, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_w2))),
+		_mm256_madd_epi16(high, _mm256_loadu_si256(reinterpret_cast<const __m256i*>(m_w2 + 16))));
+	__m128i sum = _mm_add_epi32(_mm256_castsi256_si128(sums), _mm256_extracti128_si256(sums, 1));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (m_b2 + _mm_cvtsi128_si32(sum)) * m_outputScale;
+}
+
+const char* LearnedEval::getInstructionSet()
+{
+	return "avx2";
+}
+
+#elif defined(SHKUBA_SIMD_SSE2)
+
+float LearnedEval::evaluate(const uint16_t* active, int count) const
+{
+	const int lanes = 8;
+	__m128i acc[LEARNED_HIDDEN / lanes];
+	for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+	{
+		acc[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_b1 + k * lanes));
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		const int16_t* row = m_w1.data() + active[i] * LEARNED_HIDDEN;
+		for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+		{
+			acc[k] = _mm_add_epi16(acc[k], _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + k * lanes)));
+		}
+	}
+	const __m128i zero = _mm_setzero_si128();
+	const __m128i one = _mm_set1_epi16(LEARNED_ACTIVATION_ONE);
+	__m128i sum = zero;
+	for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+	{
+		__m128i activation = _mm_max_epi16(_mm_min_epi16(acc[k], one), zero);
+		sum = _mm_add_epi32(sum, _mm_madd_epi16(activation, _mm_loadu_si128(reinterpret_cast<const __m128i*>(m_w2 + k * lanes))));
+	}
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(1, 0, 3, 2)));
+	sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, _MM_SHUFFLE(2, 3, 0, 1)));
+	return (m_b2 + _mm_cvtsi128_si32(sum)) * m_outputScale;
+}
+
+const char* LearnedEval::getInstructionSet()
+{
+	return "sse2";
+}
+
+#elif defined(SHKUBA_SIMD_NEON)
+
+float LearnedEval::evaluate(const uint16_t* active, int count) const
+{
+	const int lanes = 8;
+	int16x8_t acc[LEARNED_HIDDEN / lanes];
+	for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+	{
+		acc[k] = vld1q_s16(m_b1 + k * lanes);
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		const int16_t* row = m_w1.data() + active[i] * LEARNED_HIDDEN;
+		for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+		{
+			acc[k] = vaddq_s16(acc[k], vld1q_s16(row + k * lanes));
+		}
+	}
+	const int16x8_t zero = vdupq_n_s16(0);
+	const int16x8_t one = vdupq_n_s16(LEARNED_ACTIVATION_ONE);
+	int32x4_t sum = vdupq_n_s32(0);
+	for (int k = 0; k < LEARNED_HIDDEN / lanes; ++k)
+	{
+		int16x8_t activation = vmaxq_s16(vminq_s16(acc[k], one), zero);
+		int16x8_t weights = vld1q_s16(m_w2 + k * lanes);
+		sum = vmlal_s16(sum, vget_low_s16(activation), vget_low_s16(weights));
+		sum = vmlal_s16(sum, vget_high_s16(activation), vget_high_s16(weights));
+	}
+	int32x2_t pairs = vadd_s32(vget_low_s32(sum), vget_high_s32(sum));
+	return (m_b2 + vget_lane_s32(vpadd_s32(pairs, pairs), 0)) * m_outputScale;
+}
+
+const char* LearnedEval::getInstructionSet()
+{
+	return "neon";
+}
+
+#else
+
+float LearnedEval::evaluate(const uint16_t* active, int count) const
+{
+	int32_t acc[LEARNED_HIDDEN];
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		acc[j] = m_b1[j];
+	}
+	for (int i = 0; i < count; ++i)
+	{
+		const int16_t* row = m_w1.data() + active[i] * LEARNED_HIDDEN;
+		for (int j = 0; j < LEARNED_HIDDEN; ++j)
+		{
+			acc[j] += row[j];
+		}
+	}
+	int32_t sum = m_b2;
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		sum += std::max(0, std::min<int32_t>(LEARNED_ACTIVATION_ONE, acc[j])) * m_w2[j];
+	}
+	return sum * m_outputScale;
+}
+
+const char* LearnedEval::getInstructionSet()
+{
+	return "scalar";
+}
+
+#endif
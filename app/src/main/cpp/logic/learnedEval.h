@@ -0,0 +1,46 @@
+#pragma once
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "round.h"
+
+// the position as the viewer sees it, as indices of the inputs that are 1 (all others are 0):
+// own hand, board, own pile, other pile, cards known to be in the other hand (40 each, by card index),
+// sweeps own - other (one of 7, clamped to +-3), the viewer captured last, the deck size (one of 4, by 8 cards)
+const int LEARNED_INPUTS = 5 * NUM_OF_CARDS + 7 + 1 + 4;
+const int LEARNED_HIDDEN = 32;
+const int LEARNED_MAX_ACTIVE = NUM_OF_CARDS + 8;	//every card is in one place at most, plus the other inputs
+const int LEARNED_ACTIVATION_ONE = 64;	//1.0 of the hidden layer in the quantized model
+// largest quantized first layer weight or bias: no sum of LEARNED_MAX_ACTIVE of them and a bias can leave int16,
+// so plain adds are exact everywhere. the trainer clips the float model to it
+const int LEARNED_MAX_FIRST_LAYER = INT16_MAX / (LEARNED_MAX_ACTIVE + 1);
+
+// a small learned evaluator: the round point difference (viewer - other) expected at the end of the round.
+// inputs -> LEARNED_HIDDEN clipped ReLU units -> 1. quantized: first layer int16 in units of 1 / LEARNED_ACTIVATION_ONE,
+// summed only over the active inputs; output layer int8. inference uses AVX2, SSE2 or NEON, whichever the build
+// targets (plain C++ with SHKUBA_NO_SIMD), a few hundred nanoseconds a position. trained by shkuba_train from game records.
+// model file, little endian: "SHKN", uint16 version, uint16 inputs, uint16 hidden, uint16 0, float output scale,
+// int32 output bias, int16 hidden biases, int8 output weights, int16 first layer weights input by input.
+class LearnedEval
+{
+public:
+	LearnedEval();
+
+	static int encode(const Round& round, players viewer, uint16_t* active);	//returns the number of active inputs
+	static const char* getInstructionSet();
+
+	// rounds the float model. w1 is LEARNED_INPUTS rows of LEARNED_HIDDEN, b1 and w2 LEARNED_HIDDEN each
+	void setWeights(const float* w1, const float* b1, const float* w2, float b2);
+	bool load(const std::string& path);	//false, and nothing changed, if the file can't be read or doesn't fit
+	bool save(const std::string& path) const;
+
+	float evaluate(const uint16_t* active, int count) const;
+	float evaluate(const Round& round, players viewer) const;
+
+private:
+	std::vector<int16_t> m_w1;
+	int16_t m_b1[LEARNED_HIDDEN];
+	int16_t m_w2[LEARNED_HIDDEN];	//int8 values, kept wide for the multiply-add
+	int32_t m_b2;
+	float m_outputScale;
+};
@@ -0,0 +1,382 @@
+#include "matchHost.h"
+#include <chrono>
+#include "moveGen.h"
+#include "threadPool.h"
+#include "trace.h"
+
+namespace
+{
+	const int SLOT_BITS = 32;
+	const int COMMANDS_PER_VISIT = 256;	//a busy shard doesn't keep its thread from the others
+	const int MAX_EVENTS_PER_COMMAND = 2;	//the last move of a round: ROUND_OVER and NEW_ROUND
+	const int IDLE_SLEEP_US = 100;
+
+	uint32_t slotOf(SessionId id)
+	{
+		return static_cast<uint32_t>(id);
+	}
+}
+
+HostCommand HostCommand::open(uint64_t tag, uint64_t seed)
+{
+	HostCommand command = {};
+	command.type = COMMAND_OPEN;
+	command.session = NO_SESSION;
+	command.tag = tag;
+	command.seed = seed;
+	return command;
+}
+
+HostCommand HostCommand::startRound(SessionId session, players player, bool takeStartCard)
+{
+	HostCommand command = {};
+	command.type = COMMAND_START_ROUND;
+	command.player = static_cast<uint8_t>(player);
+	command.takeStartCard = takeStartCard ? 1 : 0;
+	command.session = session;
+	return command;
+}
+
+HostCommand HostCommand::play(SessionId session, players player, Move move)
+{
+	HostCommand command = {};
+	command.type = COMMAND_PLAY;
+	command.player = static_cast<uint8_t>(player);
+	command.session = session;
+	command.move = move;
+	return command;
+}
+
+HostCommand HostCommand::close(SessionId session)
+{
+	HostCommand command = {};
+	command.type = COMMAND_CLOSE;
+	command.session = session;
+	return command;
+}
+
+MatchHost::Session::Session() : game(P1), round(P1, uint64_t(0)), tag(0), seed(0), generation(1), roundNumber(0), phase(PHASE_FREE)
+{
+}
+
+MatchHost::Shard::Shard(int queueCapacity) : commands(queueCapacity), events(queueCapacity), vacancies(0)
+{
+}
+
+MatchHost::MatchHost(int capacity, int numOfShards, int queueCapacity) : m_sessions(capacity > 0 ? capacity : 1), m_running(false), m_openSessions(0), m_nextPoll(0), m_nextOpen(0)
+{
+	int size = static_cast<int>(m_sessions.size());
+	numOfShards = numOfShards > 0 ? numOfShards : ThreadPool::defaultSize();
+	numOfShards = numOfShards < size ? numOfShards : size;
+	for (int i = 0; i < numOfShards; ++i)
+	{
+		m_shards.emplace_back(new Shard(queueCapacity));
+		m_shards[i]->freeSlots.reserve(size / numOfShards + 1);
+	}
+	for (int slot = size - 1; slot >= 0; --slot)	//lowest slots are handed out first
+	{
+		m_shards[slot % numOfShards]->freeSlots.push_back(static_cast<uint32_t>(slot));
+	}
+	for (int i = 0; i < numOfShards; ++i)
+	{
+		m_shards[i]->vacancies = static_cast<int>(m_shards[i]->freeSlots.size());
+	}
+}
+
+MatchHost::~MatchHost()
+{
+	stop();
+}
+
+bool MatchHost::submit(const HostCommand& command)
+{
+	// a session's commands go to the shard that owns its slot, an id out of the arena goes to shard 0, which rejects it.
+	// an OPEN the host has no room for still goes through, to be answered with REJECT_HOST_FULL
+	if (command.type == COMMAND_OPEN)
+	{
+		HostCommand open = command;
+		int shard = promiseSlot();
+		open.slotPromised = shard >= 0 ? 1 : 0;
+		shard = shard >= 0 ? shard : 0;
+		if (!m_shards[shard]->commands.push(open))
+		{
+			if (open.slotPromised)
+			{
+				m_shards[shard]->vacancies.fetch_add(1);
+			}
+			return false;
+		}
+		return true;
+	}
+	std::size_t slot = slotOf(command.session);
+	return m_shards[slot < m_sessions.size() ? slot % m_shards.size() : 0]->commands.push(command);
+}
+
+int MatchHost::promiseSlot()
+{
+	int numOfShards = getNumOfShards();
+	int first = static_cast<int>(m_nextOpen.fetch_add(1, std::memory_order_relaxed) % numOfShards);
+	for (int i = 0; i < numOfShards; ++i)
+	{
+		int shard = (first + i) % numOfShards;
+		std::atomic<int>& vacancies = m_shards[shard]->vacancies;
+		int free = vacancies.load(std::memory_order_relaxed);
+		while (free > 0)
+		{
+			if (vacancies.compare_exchange_weak(free, free - 1))
+			{
+				return shard;
+			}
+		}
+	}
+	return -1;
+}
+
+bool MatchHost::pollEvent(HostEvent& event)
+{
+	std::size_t numOfShards = m_shards.size();
+	std::size_t first = m_nextPoll.fetch_add(1, std::memory_order_relaxed) % numOfShards;
+	for (std::size_t i = 0; i < numOfShards; ++i)
+	{
+		if (m_shards[(first + i) % numOfShards]->events.pop(event))
+		{
+			return true;
+		}
+	}
+	return false;
+}
+
+void MatchHost::start(int numOfThreads)
+{
+	if (m_running.exchange(true))
+	{
+		return;
+	}
+	int numOfShards = getNumOfShards();
+	numOfThreads = numOfThreads > 0 && numOfThreads < numOfShards ? numOfThreads : numOfShards;
+	for (int i = 0; i < numOfThreads; ++i)
+	{
+		m_threads.emplace_back(&MatchHost::workerLoop, this, i, numOfThreads);
+	}
+}
+
+void MatchHost::stop()
+{
+	m_running = false;
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+	m_threads.clear();
+}
+
+int MatchHost::process(int maxPerShard)
+{
+	int done = 0;
+	for (int shard = 0; shard < getNumOfShards(); ++shard)
+	{
+		done += processShard(shard, maxPerShard);
+	}
+	return done;
+}
+
+int MatchHost::getCapacity() const
+{
+	return static_cast<int>(m_sessions.size());
+}
+
+int MatchHost::getNumOfShards() const
+{
+	return static_cast<int>(m_shards.size());
+}
+
+int MatchHost::getOpenSessions() const
+{
+	return m_openSessions.load(std::memory_order_relaxed);
+}
+
+void MatchHost::workerLoop(int thread, int numOfThreads)
+{
+	while (m_running.load(std::memory_order_relaxed))
+	{
+		int done = 0;
+		for (int shard = thread; shard < getNumOfShards(); shard += numOfThreads)
+		{
+			done += processShard(shard, COMMANDS_PER_VISIT);
+		}
+		if (done == 0)
+		{
+			std::this_thread::sleep_for(std::chrono::microseconds(IDLE_SLEEP_US));
+		}
+	}
+}
+
+int MatchHost::processShard(int index, int maxCommands)
+{
+	Shard& shard = *m_shards[index];
+	int done = 0;
+	HostCommand command;
+	// a command is only taken when its events are sure to fit, nothing is ever dropped.
+	// this thread is the only one pushing the shard's events, so the room can only grow meanwhile
+	while (done < maxCommands && shard.events.getCapacity() - shard.events.getSize() >= MAX_EVENTS_PER_COMMAND && shard.commands.pop(command))
+	{
+		execute(shard, command);
+		++done;
+	}
+	return done;
+}
+
+void MatchHost::emit(Shard& shard, const HostEvent& event)
+{
+	while (!shard.events.push(event))	//only while a reader is still copying out the slot
+	{
+		std::this_thread::yield();
+	}
+}
+
+MatchHost::Session* MatchHost::find(SessionId id)
+{
+	uint32_t slot = slotOf(id);
+	if (slot >= m_sessions.size())
+	{
+		return nullptr;
+	}
+	Session& session = m_sessions[slot];
+	return session.phase != PHASE_FREE && session.generation == static_cast<uint32_t>(id >> SLOT_BITS) ? &session : nullptr;
+}
+
+bool MatchHost::openSession(Shard& shard, const HostCommand& command, HostEvent& event)
+{
+	if (!command.slotPromised)
+	{
+		event.reason = REJECT_HOST_FULL;
+		return false;
+	}
+	uint32_t slot = shard.freeSlots.back();
+	shard.freeSlots.pop_back();
+	Session& session = m_sessions[slot];
+	session.game = Game(P1);
+	session.seed = command.seed;
+	session.tag = command.tag;
+	session.roundNumber = 0;
+	session.round = Round(P1, session.seed, session.roundNumber);
+	session.phase = PHASE_START_CARD;
+	m_openSessions.fetch_add(1, std::memory_order_relaxed);
+
+	event.type = EVENT_OPENED;
+	event.session = (uint64_t(session.generation) << SLOT_BITS) | slot;
+	event.state = GameSnapshot::capture(session.game, session.round);
+	return true;
+}
+
+void MatchHost::execute(Shard& shard, const HostCommand& command)
+{
+	TRACE_SCOPE("MatchHost::execute");
+	HostEvent event = {};
+	event.type = EVENT_REJECTED;
+	event.player = command.player;
+	event.commandType = command.type;
+	event.session = command.session;
+	event.tag = command.tag;
+	event.move = command.move;
+	if (command.type == COMMAND_OPEN)
+	{
+		openSession(shard, command, event);
+		emit(shard, event);
+		return;
+	}
+
+	Session* session = find(command.session);
+	if (!session)
+	{
+		event.reason = REJECT_NO_SESSION;
+		emit(shard, event);
+		return;
+	}
+	event.tag = session->tag;
+	Game& game = session->game;
+	Round& round = session->round;
+	switch (command.type)
+	{
+	case COMMAND_START_ROUND:
+		if (session->phase != PHASE_START_CARD)
+		{
+			event.reason = REJECT_WRONG_PHASE;
+		}
+		else if (command.player != game.getFirstPlayer())
+		{
+			event.reason = REJECT_NOT_YOUR_TURN;
+		}
+		else
+		{
+			round.firstMiniRound(command.takeStartCard != 0);
+			session->phase = PHASE_PLAYING;
+			event.type = EVENT_ROUND_STARTED;
+		}
+		break;
+
+	case COMMAND_PLAY:
+		if (session->phase != PHASE_PLAYING)
+		{
+			event.reason = REJECT_WRONG_PHASE;
+		}
+		else if (command.player != round.getTurn())
+		{
+			event.reason = REJECT_NOT_YOUR_TURN;
+		}
+		else if (!MoveGen::isLegal(round.getHand(round.getTurn()), round.getBoard(), command.move))
+		{
+			event.reason = REJECT_ILLEGAL_MOVE;
+		}
+		else
+		{
+			event.type = EVENT_MOVE_PLAYED;
+			round.makeMove(command.move);
+			if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0)
+			{
+				if (round.getDeckSize() > 0)
+				{
+					round.giveCardsToPlayers();
+				}
+				else
+				{
+					round.collectBoard();
+					round.countPiles();
+					game.addToP1Points(round.getP1Points());
+					game.addToP2Points(round.getP2Points());
+					event.type = game.isOver() ? EVENT_MATCH_OVER : EVENT_ROUND_OVER;
+					session->phase = game.isOver() ? PHASE_OVER : PHASE_START_CARD;
+				}
+			}
+		}
+		break;
+
+	case COMMAND_CLOSE:
+		event.type = EVENT_CLOSED;
+		break;
+
+	default:
+		event.reason = REJECT_WRONG_PHASE;
+		break;
+	}
+
+	event.state = GameSnapshot::capture(game, round);
+	emit(shard, event);
+
+	if (event.type == EVENT_ROUND_OVER)
+	{
+		game.changeFirstPlayer();
+		round = Round(game.getFirstPlayer(), session->seed, ++session->roundNumber);
+		event.type = EVENT_NEW_ROUND;
+		event.state = GameSnapshot::capture(game, round);
+		emit(shard, event);
+	}
+	else if (event.type == EVENT_CLOSED)
+	{
+		session->phase = PHASE_FREE;
+		++session->generation;
+		shard.freeSlots.push_back(slotOf(command.session));
+		shard.vacancies.fetch_add(1);
+		m_openSessions.fetch_sub(1, std::memory_order_relaxed);
+	}
+}
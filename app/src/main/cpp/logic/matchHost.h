@@ -0,0 +1,118 @@
+#pragma once
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "boundedQueue.h"
+#include "gameSnapshot.h"
+
+// a session id is the arena slot in the low 32 bits and the slot's generation above it,
+// so commands for a closed session never reach the one that reuses its slot
+typedef uint64_t SessionId;
+const SessionId NO_SESSION = ~SessionId(0);
+
+enum hostCommandType { COMMAND_OPEN, COMMAND_START_ROUND, COMMAND_PLAY, COMMAND_CLOSE };
+enum hostEventType { EVENT_OPENED, EVENT_REJECTED, EVENT_ROUND_STARTED, EVENT_MOVE_PLAYED, EVENT_ROUND_OVER, EVENT_NEW_ROUND, EVENT_MATCH_OVER, EVENT_CLOSED };
+enum rejectReason { REJECT_NONE, REJECT_HOST_FULL, REJECT_NO_SESSION, REJECT_WRONG_PHASE, REJECT_NOT_YOUR_TURN, REJECT_ILLEGAL_MOVE };
+
+struct HostCommand
+{
+	uint8_t type;
+	uint8_t player;	//who sends it: the player to move for PLAY, the round's first player for START_ROUND
+	uint8_t takeStartCard;	//START_ROUND
+	uint8_t slotPromised;	//OPEN, set by MatchHost::submit
+	SessionId session;	//every command but OPEN
+	uint64_t tag;	//OPEN: the caller's id for the new session, given back with all its events
+	uint64_t seed;	//OPEN: the deals of the whole match come from it
+	Move move;	//PLAY
+
+	static HostCommand open(uint64_t tag, uint64_t seed);
+	static HostCommand startRound(SessionId session, players player, bool takeStartCard);
+	static HostCommand play(SessionId session, players player, Move move);
+	static HostCommand close(SessionId session);
+};
+
+struct HostEvent
+{
+	uint8_t type;
+	uint8_t reason;	//EVENT_REJECTED
+	uint8_t player;	//who sent the command
+	uint8_t commandType;	//the command it answers
+	SessionId session;
+	uint64_t tag;
+	Move move;	//the move played or rejected
+	GameSnapshot state;	//after the command. the whole truth, pass on GameSnapshot::viewedBy(player) to a player
+};
+
+// authoritative host for many matches in one process. the sessions live in an arena allocated once,
+// so opening and closing matches and dealing rounds never touch the heap. the arena is split into
+// shards (slot % shards), every shard has its own command and event queues and is only ever served by
+// one thread at a time, so sessions need no locks; submit() and pollEvent() can be called from any thread.
+//
+// an OPEN goes to a shard with a free slot, promised to it when it is submitted.
+// a match: OPEN -> EVENT_OPENED (first round dealt, the start card waiting) -> START_ROUND from the first
+// player -> EVENT_ROUND_STARTED -> PLAY from the player to move -> EVENT_MOVE_PLAYED ... the last move of a
+// round answers EVENT_ROUND_OVER followed by EVENT_NEW_ROUND (back to START_ROUND), or EVENT_MATCH_OVER.
+// CLOSE frees the slot at any point. every command is checked against the rules, a bad one gets
+// EVENT_REJECTED and changes nothing.
+class MatchHost
+{
+public:
+	MatchHost(int capacity, int numOfShards = 0, int queueCapacity = 4096);	//0 shards = one per core
+	~MatchHost();
+	MatchHost(const MatchHost&) = delete;
+	MatchHost& operator=(const MatchHost&) = delete;
+
+	bool submit(const HostCommand& command);	//false if the shard's queue is full, try again later
+	bool pollEvent(HostEvent& event);	//false if no shard has an event
+
+	void start(int numOfThreads = 0);	//serves the shards on its own threads until stop(), 0 = one per shard
+	void stop();
+	int process(int maxPerShard = 1 << 30);	//serves every shard once on the calling thread, only while not started. returns commands done
+
+	int getCapacity() const;
+	int getNumOfShards() const;
+	int getOpenSessions() const;
+
+private:
+	enum phase { PHASE_FREE, PHASE_START_CARD, PHASE_PLAYING, PHASE_OVER };
+
+	struct Session
+	{
+		Game game;
+		Round round;
+		uint64_t tag;
+		uint64_t seed;
+		uint32_t generation;
+		uint16_t roundNumber;
+		uint8_t phase;
+
+		Session();
+	};
+
+	struct Shard
+	{
+		BoundedQueue<HostCommand> commands;
+		BoundedQueue<HostEvent> events;
+		std::vector<uint32_t> freeSlots;	//reserved for all the shard's slots up front
+		std::atomic<int> vacancies;	//free slots not promised to a submitted OPEN yet
+
+		explicit Shard(int queueCapacity);
+	};
+
+	int promiseSlot();	//shard with a free slot, -1 if the host is full
+	int processShard(int shard, int maxCommands);
+	void execute(Shard& shard, const HostCommand& command);
+	bool openSession(Shard& shard, const HostCommand& command, HostEvent& event);
+	Session* find(SessionId id);
+	void emit(Shard& shard, const HostEvent& event);
+	void workerLoop(int thread, int numOfThreads);
+
+	std::vector<Session> m_sessions;
+	std::vector<std::unique_ptr<Shard>> m_shards;
+	std::vector<std::thread> m_threads;
+	std::atomic<bool> m_running;
+	std::atomic<int> m_openSessions;
+	std::atomic<unsigned> m_nextPoll;	//shard pollEvent starts from, so no shard starves
+	std::atomic<unsigned> m_nextOpen;	//same for the shard a new session goes to
+};
@@ -0,0 +1,67 @@
+#pragma once
+#include "cardMask.h"
+
+// a single turn: the card played from hand and the board cards it takes (none for a drop).
+// packed into one word so move lists stay small and moves can be compared and hashed directly.
+class Move
+{
+public:
+	Move();
+	Move(int cardIndex, CardMask captured);
+	int getCard() const;
+	CardMask getCaptured() const;
+	bool isDrop() const;
+	uint64_t getKey() const;
+	static Move fromKey(uint64_t key);	//the move getKey() came from
+
+	bool operator==(const Move& other) const;
+	bool operator!=(const Move& other) const;
+
+private:
+	uint64_t m_data; //bits 0..39 the captured cards, bits 40..45 the played card
+};
+
+inline Move::Move() : m_data(0)
+{
+}
+
+inline Move::Move(int cardIndex, CardMask captured) : m_data((uint64_t(cardIndex) << NUM_OF_CARDS) | captured)
+{
+}
+
+inline int Move::getCard() const
+{
+	return static_cast<int>(m_data >> NUM_OF_CARDS);
+}
+
+inline CardMask Move::getCaptured() const
+{
+	return m_data & FULL_DECK_MASK;
+}
+
+inline bool Move::isDrop() const
+{
+	return getCaptured() == EMPTY_MASK;
+}
+
+inline uint64_t Move::getKey() const
+{
+	return m_data;
+}
+
+inline Move Move::fromKey(uint64_t key)
+{
+	Move move;
+	move.m_data = key;
+	return move;
+}
+
+inline bool Move::operator==(const Move& other) const
+{
+	return m_data == other.m_data;
+}
+
+inline bool Move::operator!=(const Move& other) const
+{
+	return m_data != other.m_data;
+}
@@ -0,0 +1,74 @@
+#include "moveGen.h"
+
+int MoveGen::generate(const Round& round, Move* out, int capacity)
+{
+	return generate(round.getHand(round.getTurn()), round.getBoard(), out, capacity);
+}
+
+int MoveGen::generate(const Hand& hand, const Board& board, Move* out, int capacity)
+{
+	int written = generateCaptures(hand, board, out, capacity);
+	for (CardMask cards = hand.getMask(); cards && written < capacity; cards &= cards - 1)
+	{
+		out[written++] = Move(lowestCard(cards), EMPTY_MASK);
+	}
+	return written;
+}
+
+int MoveGen::generateCaptures(const Hand& hand, const Board& board, Move* out, int capacity)
+{
+	CardMask captures[MAX_CAPTURES];
+	int numOfCaptures = 0;
+	int lastRank = 0;
+	int written = 0;
+	for (CardMask cards = hand.getMask(); cards && written < capacity; cards &= cards - 1)
+	{
+		int cardIndex = lowestCard(cards);
+		int rank = rankOfIndex(cardIndex);
+		if (rank != lastRank) //cards come in index order, so cards of the same rank are next to each other and share the lookup
+		{
+			lastRank = rank;
+			numOfCaptures = CaptureTable::canCapture(board, rank) ? CaptureTable::getCaptures(board, rank, captures, MAX_CAPTURES) : 0;
+		}
+		for (int i = 0; i < numOfCaptures && written < capacity; ++i)
+		{
+			out[written++] = Move(cardIndex, captures[i]);
+		}
+	}
+	return written;
+}
+
+bool MoveGen::isLegal(const Hand& hand, const Board& board, Move move)
+{
+	int cardIndex = move.getCard();
+	CardMask captured = move.getCaptured();
+	if (cardIndex >= NUM_OF_CARDS || !(hand.getMask() & cardBit(cardIndex)))
+	{
+		return false;
+	}
+	if (move.isDrop())
+	{
+		return true;
+	}
+	if ((captured & board.getMask()) != captured)
+	{
+		return false;
+	}
+	int rank = rankOfIndex(cardIndex);
+	if (board.countRank(rank) > 0)
+	{
+		return countCards(captured) == 1 && (captured & rankMask(rank));
+	}
+	return countCards(captured) > 1 && sumOfRanks(captured) == rank;
+}
+
+int MoveGen::sumOfRanks(CardMask cards)
+{
+	uint64_t counts = rankCountsOf(cards);
+	int sum = 0;
+	for (int rank = MIN_RANK; rank <= MAX_RANK; ++rank)
+	{
+		sum += rankCount(counts, rank) * rank;
+	}
+	return sum;
+}
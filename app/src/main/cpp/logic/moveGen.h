@@ -0,0 +1,19 @@
+#pragma once
+#include "move.h"
+#include "round.h"
+#include "captureTable.h"
+
+const int MAX_MOVES = NUM_OF_HAND * (MAX_CAPTURES + 1); //every capture plus a drop for every card in hand
+
+// legal move generation. moves are written into a caller supplied buffer, nothing is allocated.
+// the rules: a card may always be dropped on the board. it may take a single board card of the
+// same rank, or - only if the board has no card of its rank - any 2+ board cards that sum to it.
+class MoveGen
+{
+public:
+	static int generate(const Round& round, Move* out, int capacity);	//moves of the player whose turn it is
+	static int generate(const Hand& hand, const Board& board, Move* out, int capacity);
+	static int generateCaptures(const Hand& hand, const Board& board, Move* out, int capacity);
+	static bool isLegal(const Hand& hand, const Board& board, Move move);
+	static int sumOfRanks(CardMask cards);
+};
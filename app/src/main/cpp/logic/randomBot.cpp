@@ -0,0 +1,21 @@
+#include "randomBot.h"
+
+RandomBot::RandomBot() : m_rng(0), m_moves(MAX_MOVES)
+{
+}
+
+Move RandomBot::chooseMove(const Round& round)
+{
+	int numOfMoves = MoveGen::generate(round, m_moves.data(), MAX_MOVES);
+	return numOfMoves > 0 ? m_moves[m_rng.below(numOfMoves)] : Move();
+}
+
+bool RandomBot::takeStartCard(const Round& /*round*/)
+{
+	return m_rng() & 1;
+}
+
+void RandomBot::setSeed(uint64_t seed)
+{
+	m_rng.seed(seed);
+}
@@ -0,0 +1,18 @@
+#pragma once
+#include <vector>
+#include "bot.h"
+#include "moveGen.h"
+
+// plays a uniformly random legal move. the baseline for simulations.
+class RandomBot : public Bot
+{
+public:
+	RandomBot();
+	Move chooseMove(const Round& round) override;
+	bool takeStartCard(const Round& round) override;
+	void setSeed(uint64_t seed) override;
+
+private:
+	CounterRng m_rng;
+	std::vector<Move> m_moves;
+};
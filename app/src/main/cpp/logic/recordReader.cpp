@@ -0,0 +1,168 @@
+#include "recordReader.h"
+#include <cstdio>
+#include <cstring>
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace
+{
+	uint64_t readLittleEndian(const uint8_t* in, int bytes)
+	{
+		uint64_t value = 0;
+		for (int i = 0; i < bytes; ++i)
+		{
+			value |= uint64_t(in[i]) << (8 * i);
+		}
+		return value;
+	}
+
+	// every card exactly once: Round deals straight from these indices
+	bool isPermutation(const uint8_t* drawOrder)
+	{
+		CardMask seen = EMPTY_MASK;
+		for (int i = 0; i < NUM_OF_CARDS; ++i)
+		{
+			if (drawOrder[i] >= NUM_OF_CARDS || (seen >> drawOrder[i]) & 1)
+			{
+				return false;
+			}
+			seen |= CardMask(1) << drawOrder[i];
+		}
+		return true;
+	}
+}
+
+players RecordedRound::getFirstPlayer() const
+{
+	return (flags & RECORD_P2_FIRST) ? P2 : P1;
+}
+
+bool RecordedRound::startCardTaken() const
+{
+	return (flags & RECORD_START_CARD_TAKEN) != 0;
+}
+
+Round RecordedRound::createRound() const
+{
+	return drawOrder ? Round(getFirstPlayer(), drawOrder) : Round(getFirstPlayer(), deckSeed, deckStream);
+}
+
+RecordReader::RecordReader() : m_data(nullptr), m_size(0), m_position(0), m_mapped(false)
+{
+}
+
+RecordReader::~RecordReader()
+{
+	close();
+}
+
+bool RecordReader::open(const std::string& path)
+{
+	close();
+#if !defined(_WIN32)
+	int file = ::open(path.c_str(), O_RDONLY);
+	if (file < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if (fstat(file, &info) == 0 && info.st_size > 0)
+	{
+		void* mapped = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, file, 0);
+		if (mapped != MAP_FAILED)
+		{
+			madvise(mapped, info.st_size, MADV_SEQUENTIAL);
+			m_data = static_cast<const uint8_t*>(mapped);
+			m_size = info.st_size;
+			m_mapped = true;
+		}
+	}
+	::close(file);
+#else
+	std::FILE* file = std::fopen(path.c_str(), "rb");
+	if (!file)
+	{
+		return false;
+	}
+	std::fseek(file, 0, SEEK_END);
+	long size = std::ftell(file);
+	std::fseek(file, 0, SEEK_SET);
+	if (size > 0)
+	{
+		uint8_t* data = new uint8_t[size];
+		m_size = std::fread(data, 1, size, file);
+		m_data = data;
+	}
+	std::fclose(file);
+#endif
+	if (!m_data || m_size < RECORD_HEADER_SIZE || std::memcmp(m_data, RECORD_MAGIC, sizeof(RECORD_MAGIC)) != 0 ||
+		readLittleEndian(m_data + sizeof(RECORD_MAGIC), 2) != RECORD_VERSION)
+	{
+		close();
+		return false;
+	}
+	m_position = RECORD_HEADER_SIZE;
+	return true;
+}
+
+void RecordReader::close()
+{
+	if (m_data)
+	{
+#if !defined(_WIN32)
+		if (m_mapped)
+		{
+			munmap(const_cast<uint8_t*>(m_data), m_size);
+		}
+#else
+		delete[] m_data;
+#endif
+	}
+	m_data = nullptr;
+	m_size = 0;
+	m_position = 0;
+	m_mapped = false;
+}
+
+bool RecordReader::next(RecordedRound& round)
+{
+	if (m_position + RECORD_ROUND_HEADER_SIZE > m_size)
+	{
+		return false;
+	}
+	const uint8_t* block = m_data + m_position;
+	round.flags = block[0];
+	round.numOfMoves = block[1];
+	round.moveBytes = static_cast<int>(readLittleEndian(block + 2, 2));
+	int dealSize = (round.flags & RECORD_EXPLICIT_DEAL) ? NUM_OF_CARDS : 16;
+	std::size_t blockSize = RECORD_ROUND_HEADER_SIZE + dealSize + round.moveBytes;
+	if (m_position + blockSize > m_size)
+	{
+		return false;
+	}
+	const uint8_t* deal = block + RECORD_ROUND_HEADER_SIZE;
+	if ((round.flags & RECORD_EXPLICIT_DEAL) && !isPermutation(deal))
+	{
+		return false;
+	}
+	round.drawOrder = (round.flags & RECORD_EXPLICIT_DEAL) ? deal : nullptr;
+	round.deckSeed = round.drawOrder ? 0 : readLittleEndian(deal, 8);
+	round.deckStream = round.drawOrder ? 0 : readLittleEndian(deal + 8, 8);
+	round.moves = deal + dealSize;
+	m_position += blockSize;
+	return true;
+}
+
+void RecordReader::rewind()
+{
+	m_position = m_data ? RECORD_HEADER_SIZE : 0;
+}
+
+std::size_t RecordReader::getSize() const
+{
+	return m_size;
+}
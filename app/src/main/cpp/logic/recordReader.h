@@ -0,0 +1,50 @@
+#pragma once
+#include <cstddef>
+#include <string>
+#include "gameRecord.h"
+
+// one round block of a record file, pointing into the mapped file
+struct RecordedRound
+{
+	int flags;	//recordFlags
+	int numOfMoves;
+	uint64_t deckSeed;
+	uint64_t deckStream;
+	const uint8_t* drawOrder;	//NUM_OF_CARDS cards if RECORD_EXPLICIT_DEAL, else nullptr
+	const uint8_t* moves;	//decode with RoundRecord::decodeMove, up to moves + moveBytes
+	int moveBytes;
+
+	players getFirstPlayer() const;
+	bool startCardTaken() const;
+	Round createRound() const;	//the round as dealt, before firstMiniRound
+};
+
+// reads a record file through a read only memory map (the whole file is read into memory where
+// mapping isn't available). rounds are walked in place, nothing is copied or allocated per round.
+// replaying a round:
+//   Round round = recorded.createRound();
+//   round.firstMiniRound(recorded.startCardTaken());
+//   const uint8_t* in = recorded.moves;
+//   for every move: deal when both hands are empty, then decode it with
+//     RoundRecord::decodeMove(in, recorded.moves + recorded.moveBytes, round.getBoard().getMask(), move)
+//   and make it. the file isn't trusted: a move that doesn't decode, or isn't legal, means the round is corrupt
+class RecordReader
+{
+public:
+	RecordReader();
+	~RecordReader();
+	RecordReader(const RecordReader&) = delete;
+	RecordReader& operator=(const RecordReader&) = delete;
+
+	bool open(const std::string& path);	//false if the file can't be read or isn't a record file
+	void close();
+	bool next(RecordedRound& round);	//false at the end of the file, at a truncated block or at a deal that isn't every card once
+	void rewind();
+	std::size_t getSize() const;
+
+private:
+	const uint8_t* m_data;
+	std::size_t m_size;
+	std::size_t m_position;
+	bool m_mapped;
+};
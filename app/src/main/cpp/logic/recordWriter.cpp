@@ -0,0 +1,58 @@
+#include "recordWriter.h"
+
+RecordWriter::RecordWriter() : m_file(nullptr)
+{
+}
+
+RecordWriter::~RecordWriter()
+{
+	close();
+}
+
+bool RecordWriter::open(const std::string& path)
+{
+	close();
+	std::lock_guard<std::mutex> lock(m_mutex);
+	m_file = std::fopen(path.c_str(), "wb");
+	if (!m_file)
+	{
+		return false;
+	}
+	uint8_t header[RECORD_HEADER_SIZE] = { uint8_t(RECORD_MAGIC[0]), uint8_t(RECORD_MAGIC[1]), uint8_t(RECORD_MAGIC[2]), uint8_t(RECORD_MAGIC[3]),
+		uint8_t(RECORD_VERSION), uint8_t(RECORD_VERSION >> 8), 0, 0 };
+	std::fwrite(header, 1, RECORD_HEADER_SIZE, m_file);
+	return true;
+}
+
+bool RecordWriter::isOpen() const
+{
+	return m_file != nullptr;
+}
+
+void RecordWriter::write(const RoundRecord& record)
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_file && record.getSize() > 0)
+	{
+		std::fwrite(record.getData(), 1, record.getSize(), m_file);
+	}
+}
+
+void RecordWriter::flush()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_file)
+	{
+		std::fflush(m_file);
+	}
+}
+
+void RecordWriter::close()
+{
+	std::lock_guard<std::mutex> lock(m_mutex);
+	if (m_file)
+	{
+		std::fclose(m_file);
+		m_file = nullptr;
+	}
+}
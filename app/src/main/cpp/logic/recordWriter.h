@@ -0,0 +1,26 @@
+#pragma once
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include "gameRecord.h"
+
+// appends round blocks to a record file (format in gameRecord.h). write() may be called from many
+// threads, every block lands whole.
+class RecordWriter
+{
+public:
+	RecordWriter();
+	~RecordWriter();
+	RecordWriter(const RecordWriter&) = delete;
+	RecordWriter& operator=(const RecordWriter&) = delete;
+
+	bool open(const std::string& path);	//creates or truncates the file and writes the header
+	bool isOpen() const;
+	void write(const RoundRecord& record);
+	void flush();	//push buffered blocks to the file, e.g. after every round of a live game
+	void close();
+
+private:
+	std::FILE* m_file;
+	std::mutex m_mutex;
+};
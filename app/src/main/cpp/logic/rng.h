@@ -0,0 +1,60 @@
+#pragma once
+#include <cstdint>
+
+// splitmix64 finalizer, spreads nearby values (seeds, counters) over the whole range
+inline uint64_t mixSeed(uint64_t x)
+{
+	x += 0x9E3779B97F4A7C15ULL;
+	x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+	x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+	return x ^ (x >> 31);
+}
+
+// counter based generator: the n-th number of a stream is mix(key + n * gamma), a pure function of
+// (seed, stream, n). it is two words of state, so every deck, bot and thread can own one, and any
+// deal can be regenerated from (seed, stream) alone. satisfies UniformRandomBitGenerator.
+class CounterRng
+{
+public:
+	typedef uint64_t result_type;
+
+	explicit CounterRng(uint64_t seed = 0, uint64_t stream = 0)
+	{
+		this->seed(seed, stream);
+	}
+
+	void seed(uint64_t seed, uint64_t stream = 0)
+	{
+		m_key = mixSeed(seed) ^ mixSeed(~stream * 0xD1342543DE82EF95ULL);
+		m_counter = 0;
+	}
+
+	uint64_t at(uint64_t counter) const	//random access into the stream
+	{
+		return mixSeed(m_key + counter * 0x9E3779B97F4A7C15ULL);
+	}
+
+	uint64_t operator()()
+	{
+		return at(m_counter++);
+	}
+
+	uint32_t below(uint32_t bound)	//uniform in [0, bound), multiply-shift (bias below 2^-32 * bound)
+	{
+		return static_cast<uint32_t>(((operator()() >> 32) * bound) >> 32);
+	}
+
+	static constexpr uint64_t min()
+	{
+		return 0;
+	}
+
+	static constexpr uint64_t max()
+	{
+		return ~uint64_t(0);
+	}
+
+private:
+	uint64_t m_key;
+	uint64_t m_counter;
+};
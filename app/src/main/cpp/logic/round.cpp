@@ -1,10 +1,55 @@
 #include "round.h"
 
-Round::Round(players firstPlayer) : roundDeck(), p1Points(0),p2Points(0), p1Hand(), p2Hand(), m_startCard(roundDeck.draw()),m_firstPlayer(firstPlayer)
+namespace
+{
+    Deck deckInDrawOrder(const uint8_t* drawOrder)
+    {
+        uint8_t cards[NUM_OF_CARDS];
+        for (int i = 0; i < NUM_OF_CARDS; ++i)
+        {
+            cards[i] = drawOrder[NUM_OF_CARDS - 1 - i]; //the deck deals from the back
+        }
+        Deck deck(0);
+        deck.setCards(cards, NUM_OF_CARDS);
+        return deck;
+    }
+}
+
+Round::Round(players firstPlayer) : roundDeck(), p1Points(0),p2Points(0), p1Hand(), p2Hand(), p1Pile(EMPTY_MASK), p2Pile(EMPTY_MASK), m_startCard(roundDeck.draw()), m_startCardTaken(false), m_firstPlayer(firstPlayer), m_turn(firstPlayer), m_lastCapturer(-1), m_counts(), m_seen()
 {
     
 }
 
+Round::Round(players firstPlayer, uint64_t deckSeed, uint64_t deckStream) : roundDeck(deckSeed, deckStream), p1Points(0),p2Points(0), p1Hand(), p2Hand(), p1Pile(EMPTY_MASK), p2Pile(EMPTY_MASK), m_startCard(roundDeck.draw()), m_startCardTaken(false), m_firstPlayer(firstPlayer), m_turn(firstPlayer), m_lastCapturer(-1), m_counts(), m_seen()
+{
+
+}
+
+Round::Round(players firstPlayer, const uint8_t* drawOrder) : roundDeck(deckInDrawOrder(drawOrder)), p1Points(0),p2Points(0), p1Hand(), p2Hand(), p1Pile(EMPTY_MASK), p2Pile(EMPTY_MASK), m_startCard(roundDeck.draw()), m_startCardTaken(false), m_firstPlayer(firstPlayer), m_turn(firstPlayer), m_lastCapturer(-1), m_counts(), m_seen()
+{
+
+}
+
+int RoundScore::total(players player) const
+{
+    int sum = 0;
+    for (int i = 0; i < NUM_OF_SCORE_CATEGORIES; ++i)
+    {
+        sum += points[player][i];
+    }
+    return sum;
+}
+
+void PileCounts::add(CardMask pileCards, int sign)
+{
+    const Card sevenOfDiamondsCard(Card::D, 7);
+    cards += sign * countCards(pileCards);
+    diamonds += sign * countCards(pileCards & suitMask(Card::D));
+    sevens += sign * countCards(pileCards & rankMask(7));
+    sixes += sign * countCards(pileCards & rankMask(6));
+    sevenOfDiamonds += sign * countCards(pileCards & sevenOfDiamondsCard.getMask());
+}
+
 int Round::getP1Points()
 {
     return p1Points;
@@ -17,105 +62,168 @@ int Round::getP2Points()
 
 void Round::addToP1Pile(Card cardToAdd)
 {
-    p1Pile.push_back(cardToAdd);
+    if (!(p1Pile & cardToAdd.getMask()))
+    {
+        m_counts[P1].add(cardToAdd.getMask(), 1);
+    }
+    p1Pile |= cardToAdd.getMask();
+    m_seen[P1] |= cardToAdd.getMask();
+    m_seen[P2] |= cardToAdd.getMask();
 }
 
 void Round::addToP2Pile(Card cardToAdd)
 {
-    p2Pile.push_back(cardToAdd);
+    if (!(p2Pile & cardToAdd.getMask()))
+    {
+        m_counts[P2].add(cardToAdd.getMask(), 1);
+    }
+    p2Pile |= cardToAdd.getMask();
+    m_seen[P1] |= cardToAdd.getMask();
+    m_seen[P2] |= cardToAdd.getMask();
+}
+
+CardMask Round::getP1Pile() const
+{
+    return p1Pile;
+}
+
+CardMask Round::getP2Pile() const
+{
+    return p2Pile;
 }
 
 void Round::countPiles()    
 {
-    int diamonds = 0;
-    int sevens = 0;
-    int sixes = 0;
-    int cards = 0;
-   
-    cards = p2Pile.size();
-    for (int i = 0; i < cards; ++i)
+    int p1RoundPoints = 0;
+    int p2RoundPoints = 0;
+    scorePiles(p1RoundPoints, p2RoundPoints);
+    p1Points += p1RoundPoints;
+    p2Points += p2RoundPoints;
+}
+
+void Round::scorePiles(int& p1RoundPoints, int& p2RoundPoints) const
+{
+    RoundScore score = scoreCategories();
+    p1RoundPoints = score.total(P1);
+    p2RoundPoints = score.total(P2);
+}
+
+RoundScore Round::scoreCategories() const
+{
+    return scoreCategories(m_counts[P1], m_counts[P2].sweeps);
+}
+
+RoundScore Round::scoreCategories(CardMask p1Pile, int p1Sweeps, int p2Sweeps)
+{
+    PileCounts p1Counts = {};
+    p1Counts.add(p1Pile, 1);
+    p1Counts.sweeps = p1Sweeps;
+    return scoreCategories(p1Counts, p2Sweeps);
+}
+
+RoundScore Round::scoreCategories(const PileCounts& p1Counts, int p2Sweeps)
+{
+    RoundScore score = {};
+
+    score.points[P1][SCORE_SWEEPS] = p1Counts.sweeps;
+    score.points[P2][SCORE_SWEEPS] = p2Sweeps;
+
+    if (p1Counts.sevenOfDiamonds)
     {
-        if (p1Pile[i].getSuit() == Card::D)
-        {
-            ++diamonds;
-            if (p1Pile[i].getRank() == 7) //only for 7 diamond
-            {
-                ++p1Points;
-            }
-            else
-            {
-                ++p2Points;
-            }
-        }
-        if (p1Pile[i].getRank() == 7)
-        {
-            ++sevens;
-        }
-        else if (p1Pile[i].getRank() == 6)
-        {
-            ++sixes;
-        }
+        score.points[P1][SCORE_SEVEN_OF_DIAMONDS] = 1;
+    }
+    else
+    {
+        score.points[P2][SCORE_SEVEN_OF_DIAMONDS] = 1;
     }
 
+    int sevens = p1Counts.sevens;
+    int sixes = p1Counts.sixes;
     if (sevens > 2 || (sevens == 2 && sixes > 2))
     {
-        ++p1Points;
+        score.points[P1][SCORE_SEVENS] = 1;
     }
     else if (sevens < 2 || (sevens == 2 && sixes < 2))
     {
-        ++p2Points;
+        score.points[P2][SCORE_SEVENS] = 1;
     }
-    if (cards > 20)
+    if (p1Counts.cards > 20)
     {
-        ++p1Points;
+        score.points[P1][SCORE_CARDS] = 1;
     }
-    else if (cards < 20)
+    else if (p1Counts.cards < 20)
     {
-        ++p2Points;
+        score.points[P2][SCORE_CARDS] = 1;
     }
-    if (diamonds > 5)
+    if (p1Counts.diamonds > 5)
     {
-        ++p1Points;
+        score.points[P1][SCORE_DIAMONDS] = 1;
     }
-    else if (diamonds < 5)
+    else if (p1Counts.diamonds < 5)
     {
-        ++p2Points;
+        score.points[P2][SCORE_DIAMONDS] = 1;
     }
+    return score;
+}
 
+RoundScore Round::getLiveScore() const
+{
+    // a category is decided once a pile has more than half of it, so at the end of the round
+    // (every card in a pile) this is the same as scoreCategories
+    RoundScore score = {};
+    for (int player = P1; player <= P2; ++player)
+    {
+        const PileCounts& mine = m_counts[player];
+        const PileCounts& theirs = m_counts[player == P1 ? P2 : P1];
+        score.points[player][SCORE_SWEEPS] = mine.sweeps;
+        score.points[player][SCORE_SEVEN_OF_DIAMONDS] = mine.sevenOfDiamonds;
+        score.points[player][SCORE_CARDS] = mine.cards > NUM_OF_CARDS / 2 ? 1 : 0;
+        score.points[player][SCORE_DIAMONDS] = mine.diamonds > NUM_OF_RANKS / 2 ? 1 : 0;
+        score.points[player][SCORE_SEVENS] = mine.sevens > 2 || (mine.sevens == 2 && theirs.sevens == 2 && mine.sixes > 2) ? 1 : 0;
+    }
+    return score;
+}
+
+const PileCounts& Round::getPileCounts(players player) const
+{
+    return m_counts[player];
 }
 
 void Round::firstMiniRound(bool choice)  //aka first mini-round
 {
     if (choice == false)
     {
-        m_board.addToBoard(m_startCard);
+        dealToBoard(m_startCard);
         for (int i = 0; i < NUM_OF_HAND; ++i)
         {
-            p1Hand.addToHand(roundDeck.draw());
-            p2Hand.addToHand(roundDeck.draw());
-            m_board.addToBoard(roundDeck.draw());
+            dealTo(P1, roundDeck.draw());
+            dealTo(P2, roundDeck.draw());
+            dealToBoard(roundDeck.draw());
         }
     }
     else
     {
+        m_startCardTaken = true;
+        m_seen[P1] |= m_startCard.getMask(); //everyone saw the start card before it was taken
+        m_seen[P2] |= m_startCard.getMask();
         if (m_firstPlayer == P1)
         {
-            p1Hand.addToHand(m_startCard);
-            p2Hand.addToHand(roundDeck.draw());
+            dealTo(P1, m_startCard);
+            dealTo(P2, roundDeck.draw());
         }
         else
         {
-            p2Hand.addToHand(m_startCard);
-            p1Hand.addToHand(roundDeck.draw());
+            dealTo(P2, m_startCard);
+            dealTo(P1, roundDeck.draw());
         }
         for (int i = 0; i < NUM_OF_HAND-1; ++i)
         {
-            p1Hand.addToHand(roundDeck.draw());
-            p2Hand.addToHand(roundDeck.draw());
+            dealTo(P1, roundDeck.draw());
+            dealTo(P2, roundDeck.draw());
         }
         for (int i = 0; i < NUM_OF_BOARD; ++i)
         {
-            m_board.addToBoard(roundDeck.draw());
+            dealToBoard(roundDeck.draw());
         }
 
     }
@@ -126,9 +234,201 @@ void Round::giveCardsToPlayers()
 {
     for (int i = 0; i < NUM_OF_HAND; ++i)
     {
-        p1Hand.addToHand(roundDeck.draw());
-        p2Hand.addToHand(roundDeck.draw());
+        dealTo(P1, roundDeck.draw());
+        dealTo(P2, roundDeck.draw());
     }
 
 
 }
+
+void Round::collectBoard()
+{
+    if (m_lastCapturer != -1)
+    {
+        m_counts[m_lastCapturer].add(m_board.getMask(), 1);
+        pileOf(static_cast<players>(m_lastCapturer)) |= m_board.getMask();
+        m_board.removeMask(m_board.getMask());
+    }
+}
+
+bool Round::isRoundOver() const
+{
+    return roundDeck.getSize() == 0 && p1Hand.getHandSize() == 0 && p2Hand.getHandSize() == 0;
+}
+
+int Round::getDeckSize() const
+{
+    return roundDeck.getSize();
+}
+
+int Round::getDrawOrder(uint8_t* drawOrder) const
+{
+    uint8_t cards[NUM_OF_CARDS];
+    int count = roundDeck.getCards(cards);
+    drawOrder[0] = static_cast<uint8_t>(m_startCard.getIndex());
+    for (int i = 0; i < count; ++i)
+    {
+        drawOrder[i + 1] = cards[count - 1 - i];
+    }
+    return count + 1;
+}
+
+void Round::redealHiddenCards(players viewer, CounterRng& rng)
+{
+    players other = viewer == P1 ? P2 : P1;
+    Hand& otherHand = handOf(other);
+    CardMask known = knownStartCard(viewer);
+
+    // what the viewer hasn't seen is exactly the other hand and the deck, less the known start card
+    uint8_t hidden[NUM_OF_CARDS];
+    int numOfHidden = 0;
+    for (CardMask rest = FULL_DECK_MASK & ~m_seen[viewer]; rest; rest &= rest - 1)
+    {
+        hidden[numOfHidden++] = static_cast<uint8_t>(lowestCard(rest));
+    }
+    Deck::shuffleCards(hidden, numOfHidden, rng);
+
+    int toHand = otherHand.getHandSize() - countCards(known);
+    otherHand = Hand(known);
+    for (int i = 0; i < toHand; ++i)
+    {
+        otherHand.addToHand(Card(hidden[i]));
+    }
+    roundDeck.setCards(hidden + toHand, numOfHidden - toHand);
+
+    // the other player now holds different cards: they have seen everything but the deck and the viewer's hand
+    CardMask deckMask = EMPTY_MASK;
+    for (int i = toHand; i < numOfHidden; ++i)
+    {
+        deckMask |= cardBit(hidden[i]);
+    }
+    m_seen[other] = (FULL_DECK_MASK & ~deckMask & ~handOf(viewer).getMask()) | knownStartCard(other);
+}
+
+MoveUndo Round::makeMove(Move move)
+{
+    MoveUndo undo = { m_lastCapturer, false };
+    Card played(move.getCard());
+    handOf(m_turn).removeFromHand(played);
+    m_seen[m_turn == P1 ? P2 : P1] |= played.getMask();
+    if (move.isDrop())
+    {
+        m_board.addToBoard(played);
+    }
+    else
+    {
+        m_board.removeMask(move.getCaptured());
+        pileOf(m_turn) |= move.getCaptured() | played.getMask();
+        m_counts[m_turn].add(move.getCaptured() | played.getMask(), 1);
+        m_lastCapturer = static_cast<int8_t>(m_turn);
+        if (m_board.getMask() == EMPTY_MASK) //took everything from the board
+        {
+            undo.sweep = true;
+            ++sweepsOf(m_turn);
+        }
+    }
+    m_turn = m_turn == P1 ? P2 : P1;
+    return undo;
+}
+
+void Round::unmakeMove(Move move, MoveUndo undo)
+{
+    m_turn = m_turn == P1 ? P2 : P1;
+    Card played(move.getCard());
+    if (move.isDrop())
+    {
+        m_board.removeMask(played.getMask());
+    }
+    else
+    {
+        m_board.addMask(move.getCaptured());
+        pileOf(m_turn) &= ~(move.getCaptured() | played.getMask());
+        m_counts[m_turn].add(move.getCaptured() | played.getMask(), -1);
+        m_lastCapturer = undo.lastCapturer;
+        if (undo.sweep)
+        {
+            --sweepsOf(m_turn);
+        }
+    }
+    handOf(m_turn).addToHand(played);
+    players other = m_turn == P1 ? P2 : P1;
+    if (!(knownStartCard(other) & played.getMask())) //back in a hand the other player can't see
+    {
+        m_seen[other] &= ~played.getMask();
+    }
+}
+
+const Hand& Round::getHand(players player) const
+{
+    return player == P1 ? p1Hand : p2Hand;
+}
+
+const Board& Round::getBoard() const
+{
+    return m_board;
+}
+
+players Round::getTurn() const
+{
+    return m_turn;
+}
+
+players Round::getFirstPlayer() const
+{
+    return m_firstPlayer;
+}
+
+Card Round::getStartCard() const
+{
+    return m_startCard;
+}
+
+int Round::getSweeps(players player) const
+{
+    return m_counts[player].sweeps;
+}
+
+int Round::getLastCapturer() const
+{
+    return m_lastCapturer;
+}
+
+CardKnowledge Round::getKnowledge(players viewer) const
+{
+    players other = viewer == P1 ? P2 : P1;
+    return CardKnowledge(m_seen[viewer], knownStartCard(viewer), getHand(other).getHandSize(), roundDeck.getSize());
+}
+
+Hand& Round::handOf(players player)
+{
+    return player == P1 ? p1Hand : p2Hand;
+}
+
+CardMask& Round::pileOf(players player)
+{
+    return player == P1 ? p1Pile : p2Pile;
+}
+
+int& Round::sweepsOf(players player)
+{
+    return m_counts[player].sweeps;
+}
+
+CardMask Round::knownStartCard(players viewer) const
+{
+    players other = viewer == P1 ? P2 : P1;
+    return m_startCardTaken && m_firstPlayer == other ? getHand(other).getMask() & m_startCard.getMask() : EMPTY_MASK;
+}
+
+void Round::dealTo(players player, Card card)
+{
+    handOf(player).addToHand(card);
+    m_seen[player] |= card.getMask();
+}
+
+void Round::dealToBoard(Card card)
+{
+    m_board.addToBoard(card);
+    m_seen[P1] |= card.getMask();
+    m_seen[P2] |= card.getMask();
+}
@@ -1,26 +1,86 @@
 #pragma once
+#include <type_traits>
 #include "hand.h"
 #include "card.h"
 #include "deck.h"
 #include "board.h"
+#include "move.h"
+#include "rng.h"
+#include "cardKnowledge.h"
 
 const int NUM_OF_HAND = 3;
 const int NUM_OF_BOARD = 4;
 enum players { P1, P2 };
 
+enum scoreCategory { SCORE_CARDS, SCORE_DIAMONDS, SCORE_SEVENS, SCORE_SEVEN_OF_DIAMONDS, SCORE_SWEEPS, NUM_OF_SCORE_CATEGORIES };
+
+struct RoundScore	//round points of every player in every category
+{
+	int points[2][NUM_OF_SCORE_CATEGORIES];
+	int total(players player) const;
+};
+
+struct PileCounts	//running totals of one player's pile, kept by Round as cards reach it
+{
+	int cards;
+	int diamonds;
+	int sevens;
+	int sixes;
+	int sevenOfDiamonds;
+	int sweeps;
+
+	void add(CardMask pileCards, int sign);	//sign 1 adds the cards, -1 takes them back
+};
+
+struct MoveUndo	//what makeMove overwrote, needed to take the move back
+{
+	int8_t lastCapturer;
+	bool sweep;
+};
+
 class Round
 {
 public:
 	Round(players firstPlayer);
+	Round(players firstPlayer, uint64_t deckSeed, uint64_t deckStream = 0);	//reproducible deal, see Deck
+	Round(players firstPlayer, const uint8_t* drawOrder);	//NUM_OF_CARDS card indices in the order they are dealt, the start card first
 	int getP1Points();
 	int getP2Points();
 
 	void addToP1Pile(Card cardToAdd);
 	void addToP2Pile(Card cardToAdd);
+	CardMask getP1Pile() const;
+	CardMask getP2Pile() const;
 
 	void countPiles();	//counts both players piles and add the points to the p1/p2Points. there are get functionts for those.
+	void scorePiles(int& p1RoundPoints, int& p2RoundPoints) const;	//the points countPiles would add, without adding them
+	RoundScore scoreCategories() const;	//end of round tally from the running counts, O(1)
+	static RoundScore scoreCategories(CardMask p1Pile, int p1Sweeps, int p2Sweeps);	//p2 has every card p1 doesn't
+	static RoundScore scoreCategories(const PileCounts& p1Counts, int p2Sweeps);
+	RoundScore getLiveScore() const;	//mid-round standing: only the categories a player already can't lose
+	const PileCounts& getPileCounts(players player) const;
 	void firstMiniRound(bool choice);
 	void giveCardsToPlayers();
+	void collectBoard();	//end of round: the cards left on the board go to the last player who captured
+	bool isRoundOver() const;
+	int getDeckSize() const;
+	int getDrawOrder(uint8_t* drawOrder) const;	//the start card and the deck in the order they will be dealt, before firstMiniRound
+
+	// replaces every card the viewer can't see (the other hand and the deck) with a random
+	// arrangement of the same cards. the start card stays in the hand of the player who took it.
+	void redealHiddenCards(players viewer, CounterRng& rng);
+
+	MoveUndo makeMove(Move move);	//plays a legal move for the player whose turn it is
+	void unmakeMove(Move move, MoveUndo undo);
+
+	const Hand& getHand(players player) const;
+	const Board& getBoard() const;
+	players getTurn() const;
+	players getFirstPlayer() const;
+	Card getStartCard() const;
+	int getSweeps(players player) const;
+	int getLastCapturer() const;	//-1 if nobody captured yet
+	CardKnowledge getKnowledge(players viewer) const;	//what the viewer has seen so far, kept up to date by every deal and move
 
 
 private:
@@ -30,10 +90,25 @@ private:
 
 	Hand p1Hand;
 	Hand p2Hand;
-	std::vector<Card> p1Pile;
-	std::vector<Card> p2Pile; //this is the computer (machine) pile. in future versions we may want to have 2v2
+	CardMask p1Pile;
+	CardMask p2Pile; //this is the computer (machine) pile. in future versions we may want to have 2v2
 	Board m_board;
 	
 	Card m_startCard;
+	bool m_startCardTaken;
 	players m_firstPlayer;
+	players m_turn;
+	int8_t m_lastCapturer; //-1 until someone captures
+	PileCounts m_counts[2];	//includes the sweeps
+	CardMask m_seen[2];	//cards every player has seen, see CardKnowledge
+
+	Hand& handOf(players player);
+	CardMask& pileOf(players player);
+	int& sweepsOf(players player);
+	CardMask knownStartCard(players viewer) const;	//the start card if the other player took it and still holds it
+	void dealTo(players player, Card card);
+	void dealToBoard(Card card);
 };
+
+// bots and the match host copy rounds all the time: a copy is a memcpy of a few hundred bytes, with no allocation
+static_assert(std::is_trivially_copyable<Round>::value, "Round must stay trivially copyable");
@@ -0,0 +1,23 @@
+#pragma once
+
+// the vector instructions the engine's hot loops are compiled for, chosen when compiling: exactly one of
+// SHKUBA_SIMD_AVX2, SHKUBA_SIMD_SSE2, SHKUBA_SIMD_NEON and SHKUBA_SIMD_SCALAR ends up defined, with its
+// intrinsics header included. SHKUBA_NO_SIMD forces plain C++. SHKUBA_NEON_EMULATION takes the NEON code on
+// any host, against the plain C++ arm_neon.h in tests/neonEmulation, so the host tests run it too.
+#if defined(SHKUBA_NO_SIMD)
+#define SHKUBA_SIMD_SCALAR
+#elif defined(SHKUBA_NEON_EMULATION)
+#define SHKUBA_SIMD_NEON
+#include <arm_neon.h>
+#elif defined(__AVX2__)
+#define SHKUBA_SIMD_AVX2
+#include <immintrin.h>
+#elif defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define SHKUBA_SIMD_SSE2
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(_M_ARM64)
+#define SHKUBA_SIMD_NEON
+#include <arm_neon.h>
+#else
+#define SHKUBA_SIMD_SCALAR
+#endif
@@ -0,0 +1,153 @@
+#include "simulator.h"
+#include <atomic>
+#include <memory>
+#include "botRegistry.h"
+#include "threadPool.h"
+#include "trace.h"
+
+namespace
+{
+	const int MATCHES_PER_GRAB = 16;	//matches a thread takes at once, keeps the shared counter cold
+	const int ROUND_STREAM_BITS = 16;
+}
+
+void SimulationStats::merge(const SimulationStats& other)
+{
+	matches += other.matches;
+	rounds += other.rounds;
+	moves += other.moves;
+	for (int bot = 0; bot < 2; ++bot)
+	{
+		wins[bot] += other.wins[bot];
+		matchPoints[bot] += other.matchPoints[bot];
+		for (int i = 0; i < NUM_OF_SCORE_CATEGORIES; ++i)
+		{
+			categoryPoints[bot][i] += other.categoryPoints[bot][i];
+		}
+	}
+}
+
+uint64_t Simulator::roundStream(uint64_t matchNumber, int roundNumber)
+{
+	return (matchNumber << ROUND_STREAM_BITS) + roundNumber;
+}
+
+SimulationStats Simulator::run(const SimulationConfig& config)
+{
+	SimulationStats total = {};
+	RecordWriter writer;
+	if (!config.recordPath.empty() && !writer.open(config.recordPath))
+	{
+		return total;
+	}
+	RecordWriter* recordTo = writer.isOpen() ? &writer : nullptr;
+	ThreadPool pool(config.numOfThreads);
+	int numOfThreads = pool.getSize();
+	std::vector<SimulationStats> threadStats(numOfThreads, total);
+	std::vector<std::unique_ptr<Bot>> threadBots(numOfThreads * 2);
+	for (std::size_t i = 0; i < threadBots.size(); ++i)
+	{
+		threadBots[i] = BotRegistry::create(config.bots[i % 2]);
+		if (!threadBots[i])
+		{
+			return total;
+		}
+	}
+
+	std::atomic<int> nextMatch(0);
+	pool.run(numOfThreads, [&](int thread)
+	{
+		Bot* botA = threadBots[thread * 2].get();
+		Bot* botB = threadBots[thread * 2 + 1].get();
+		while (true)
+		{
+			int first = nextMatch.fetch_add(MATCHES_PER_GRAB);
+			if (first >= config.numOfMatches)
+			{
+				return;
+			}
+			int last = first + MATCHES_PER_GRAB < config.numOfMatches ? first + MATCHES_PER_GRAB : config.numOfMatches;
+			for (int match = first; match < last; ++match)
+			{
+				// the bots swap seats every match so neither keeps the first turn advantage
+				bool swapSeats = match % 2 == 1;
+				Bot* seats[2] = { swapSeats ? botB : botA, swapSeats ? botA : botB };
+				int botIndex[2] = { swapSeats ? 1 : 0, swapSeats ? 0 : 1 };
+				playMatch(seats, botIndex, config.seed, match, config.targetPoints, threadStats[thread], recordTo);
+			}
+		}
+	});
+
+	for (int i = 0; i < numOfThreads; ++i)
+	{
+		total.merge(threadStats[i]);
+	}
+	return total;
+}
+
+void Simulator::playMatch(Bot* bots[2], const int botIndex[2], uint64_t seed, uint64_t matchNumber, int targetPoints, SimulationStats& stats,
+	RecordWriter* writer)
+{
+	Game game(P1);
+	RoundRecord record;
+	CounterRng botSeeds(seed, matchNumber);
+	bots[P1]->setSeed(botSeeds.at(P1));
+	bots[P2]->setSeed(botSeeds.at(P2));
+	for (int roundNumber = 0; !game.isOver(targetPoints); ++roundNumber)
+	{
+		Round round(game.getFirstPlayer(), seed, roundStream(matchNumber, roundNumber));
+		Bot* first = bots[game.getFirstPlayer()];
+		bool takeStartCard = first->takeStartCard(round);
+		round.firstMiniRound(takeStartCard);
+		if (writer)
+		{
+			record.beginSeeded(game.getFirstPlayer(), takeStartCard, seed, roundStream(matchNumber, roundNumber));
+		}
+		playRound(round, bots, &stats, writer ? &record : nullptr);
+		if (writer)
+		{
+			writer->write(record);
+		}
+
+		RoundScore score = round.scoreCategories();
+		round.countPiles();
+		game.addToP1Points(round.getP1Points());
+		game.addToP2Points(round.getP2Points());
+		game.changeFirstPlayer();
+		for (int seat = P1; seat <= P2; ++seat)
+		{
+			for (int i = 0; i < NUM_OF_SCORE_CATEGORIES; ++i)
+			{
+				stats.categoryPoints[botIndex[seat]][i] += score.points[seat][i];
+			}
+		}
+		++stats.rounds;
+	}
+	++stats.matches;
+	++stats.wins[botIndex[game.getWinner()]];
+	stats.matchPoints[botIndex[P1]] += game.getP1Points();
+	stats.matchPoints[botIndex[P2]] += game.getP2Points();
+}
+
+void Simulator::playRound(Round& round, Bot* bots[2], SimulationStats* stats, RoundRecord* record)
+{
+	TRACE_SCOPE("Simulator::playRound");
+	while (!round.isRoundOver())
+	{
+		if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0)
+		{
+			round.giveCardsToPlayers();
+		}
+		Move move = bots[round.getTurn()]->chooseMove(round);
+		if (record)
+		{
+			record->addMove(move, round.getBoard().getMask());
+		}
+		round.makeMove(move);
+		if (stats)
+		{
+			++stats->moves;
+		}
+	}
+	round.collectBoard();
+}
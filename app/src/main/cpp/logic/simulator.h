@@ -0,0 +1,43 @@
+#pragma once
+#include <string>
+#include "bot.h"
+#include "game.h"
+#include "recordWriter.h"
+
+struct SimulationConfig
+{
+	std::string bots[2];	//bot specs, see BotRegistry
+	int numOfMatches;
+	int numOfThreads;	//0 = one per core
+	uint64_t seed;
+	int targetPoints;
+	std::string recordPath;	//every round is appended to this record file (gameRecord.h), empty for none
+};
+
+// everything is indexed by bot (bots[0] / bots[1] of the config), not by seat.
+struct SimulationStats
+{
+	uint64_t matches;
+	uint64_t wins[2];
+	uint64_t rounds;
+	uint64_t moves;
+	uint64_t matchPoints[2];
+	uint64_t categoryPoints[2][NUM_OF_SCORE_CATEGORIES];
+
+	void merge(const SimulationStats& other);
+};
+
+// plays complete matches (rounds until someone reaches the target, see roundLogic.md) between bots.
+// a match only depends on the seed and its number: round r of match m is dealt by
+// Deck(seed, roundStream(m, r)), so any match or deal can be replayed on its own.
+class Simulator
+{
+public:
+	static SimulationStats run(const SimulationConfig& config);	//empty stats if a bot spec is unknown or the record file can't be created
+
+	// bots[P1] plays P1. botIndex maps a seat to the index the stats are kept under.
+	static void playMatch(Bot* bots[2], const int botIndex[2], uint64_t seed, uint64_t matchNumber, int targetPoints, SimulationStats& stats,
+		RecordWriter* writer = nullptr);
+	static void playRound(Round& round, Bot* bots[2], SimulationStats* stats, RoundRecord* record = nullptr);
+	static uint64_t roundStream(uint64_t matchNumber, int roundNumber);
+};
@@ -0,0 +1,31 @@
+#include "startCardPolicy.h"
+#include <cmath>
+#include "startCardTable.h"
+
+static_assert(sizeof(START_CARD_TABLE) / sizeof(START_CARD_TABLE[0]) == NUM_OF_CARDS, "one entry per card index");
+
+bool StartCardPolicy::shouldTake(const Card& startCard)
+{
+	const StartCardValue& value = START_CARD_TABLE[startCard.getIndex()];
+	return isClear(value) ? value.take > value.leave : takeByRule(startCard);
+}
+
+bool StartCardPolicy::isClear(const StartCardValue& value)
+{
+	return std::fabs(value.take - value.leave) > START_CARD_MIN_ERRORS * value.error;
+}
+
+bool StartCardPolicy::takeByRule(const Card& startCard)
+{
+	return startCard.getRank() == 7 || startCard.getSuit() == Card::D;
+}
+
+StartCardValue StartCardPolicy::getValue(const Card& startCard)
+{
+	return START_CARD_TABLE[startCard.getIndex()];
+}
+
+const char* StartCardPolicy::getSource()
+{
+	return START_CARD_TABLE_SOURCE;
+}
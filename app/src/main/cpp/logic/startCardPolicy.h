@@ -0,0 +1,27 @@
+#pragma once
+#include "card.h"
+
+// the first player's mean round point difference (first - other) after each Round::firstMiniRound choice,
+// and the standard error of the difference between the two (both choices are played on the same deals)
+struct StartCardValue
+{
+	float take;
+	float leave;
+	float error;
+};
+
+// the table decides a card only when its two choices differ by more than this many standard errors
+const float START_CARD_MIN_ERRORS = 2;
+
+// whether the first player should take the start card, looked up in a table shkuba_startcard simulated offline
+// (startCardTable.h), so the choice costs nothing at the start of a round. Bot::takeStartCard uses it.
+// where the table can't tell the choices apart the fixed rule decides, not the noise
+class StartCardPolicy
+{
+public:
+	static bool shouldTake(const Card& startCard);
+	static bool isClear(const StartCardValue& value);	//take and leave differ by more than START_CARD_MIN_ERRORS errors
+	static bool takeByRule(const Card& startCard);	//the fixed rule: take a 7 or a diamond
+	static StartCardValue getValue(const Card& startCard);
+	static const char* getSource();	//the generator command line the table came from
+};
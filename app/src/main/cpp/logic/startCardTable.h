@@ -0,0 +1,49 @@
+#pragma once
+#include "startCardPolicy.h"
+
+// generated by tools/startCard.cpp, don't edit. by card index: take, leave, standard error of the difference
+constexpr const char* START_CARD_TABLE_SOURCE = "shkuba_startcard --bots greedy greedy --deals 50000 --seed 1";
+
+constexpr StartCardValue START_CARD_TABLE[NUM_OF_CARDS] =
+{
+	{ -0.6928f, -0.3698f, 0.0165f },	//1S
+	{ -0.6584f, -0.3748f, 0.0165f },	//1H
+	{ -0.6894f, -0.2666f, 0.0165f },	//1D
+	{ -0.7027f, -0.3656f, 0.0166f },	//1C
+	{ -0.6440f, -0.3965f, 0.0165f },	//2S
+	{ -0.6697f, -0.4250f, 0.0164f },	//2H
+	{ -0.6140f, -0.2933f, 0.0166f },	//2D
+	{ -0.6872f, -0.4117f, 0.0166f },	//2C
+	{ -0.5997f, -0.4295f, 0.0165f },	//3S
+	{ -0.6107f, -0.4240f, 0.0165f },	//3H
+	{ -0.5103f, -0.3253f, 0.0166f },	//3D
+	{ -0.6022f, -0.4334f, 0.0166f },	//3C
+	{ -0.5679f, -0.4658f, 0.0164f },	//4S
+	{ -0.5676f, -0.4619f, 0.0164f },	//4H
+	{ -0.4903f, -0.3772f, 0.0165f },	//4D
+	{ -0.5697f, -0.4557f, 0.0165f },	//4C
+	{ -0.5183f, -0.4531f, 0.0163f },	//5S
+	{ -0.5108f, -0.4616f, 0.0164f },	//5H
+	{ -0.4158f, -0.3975f, 0.0164f },	//5D
+	{ -0.4946f, -0.4719f, 0.0164f },	//5C
+	{ -0.4636f, -0.4668f, 0.0164f },	//6S
+	{ -0.4690f, -0.4587f, 0.0164f },	//6H
+	{ -0.3582f, -0.4124f, 0.0164f },	//6D
+	{ -0.4368f, -0.4863f, 0.0164f },	//6C
+	{ -0.1020f, -0.4584f, 0.0165f },	//7S
+	{ -0.1374f, -0.4551f, 0.0166f },	//7H
+	{ 0.6947f, -0.1622f, 0.0166f },	//7D
+	{ -0.1250f, -0.4668f, 0.0165f },	//7C
+	{ -0.3952f, -0.4975f, 0.0163f },	//8S
+	{ -0.3959f, -0.4878f, 0.0161f },	//8H
+	{ -0.2609f, -0.4514f, 0.0163f },	//8D
+	{ -0.3946f, -0.4774f, 0.0162f },	//8C
+	{ -0.3658f, -0.4996f, 0.0161f },	//9S
+	{ -0.3725f, -0.4871f, 0.0163f },	//9H
+	{ -0.1968f, -0.4562f, 0.0163f },	//9D
+	{ -0.3511f, -0.4972f, 0.0162f },	//9C
+	{ -0.3577f, -0.4878f, 0.0162f },	//10S
+	{ -0.3506f, -0.5063f, 0.0160f },	//10H
+	{ -0.1698f, -0.4650f, 0.0162f },	//10D
+	{ -0.3702f, -0.5179f, 0.0161f },	//10C
+};
@@ -0,0 +1,246 @@
+#include "stateDelta.h"
+
+namespace
+{
+	enum place { PLACE_P1_HAND, PLACE_P2_HAND, PLACE_BOARD, PLACE_P1_PILE, PLACE_P2_PILE, PLACE_NONE, NUM_OF_PLACES };
+	enum deltaFlags { DELTA_P2_TURN = 1, DELTA_P2_FIRST = 2, DELTA_DECK_SIZE = 4, DELTA_START_CARD = 8, DELTA_CARDS = 16, DELTA_POINTS = 32 };
+
+	const int HEADER_SIZE = 6;
+	const int PLACE_SHIFT = 5;
+	const int MAX_GROUP = (1 << PLACE_SHIFT) - 1;
+	const int NUM_OF_POINTS = 2 + 2 * NUM_OF_SCORE_CATEGORIES;	//game points, then round points
+	const int MAX_VARINT_BYTES = 10;
+
+	template <typename Snapshot>
+	auto placeMask(Snapshot& state, int where) -> decltype(&state.board)	//null for PLACE_NONE
+	{
+		switch (where)
+		{
+		case PLACE_P1_HAND: return &state.hands[P1];
+		case PLACE_P2_HAND: return &state.hands[P2];
+		case PLACE_BOARD: return &state.board;
+		case PLACE_P1_PILE: return &state.piles[P1];
+		case PLACE_P2_PILE: return &state.piles[P2];
+		default: return nullptr;
+		}
+	}
+
+	CardMask cardsAt(const GameSnapshot& state, int where)
+	{
+		const CardMask* mask = placeMask(state, where);
+		if (mask)
+		{
+			return *mask;
+		}
+		return FULL_DECK_MASK & ~(state.hands[P1] | state.hands[P2] | state.board | state.piles[P1] | state.piles[P2]);
+	}
+
+	template <typename Snapshot>
+	auto pointsAt(Snapshot& state, int i) -> decltype(state.gamePoints[0])
+	{
+		return i < 2 ? state.gamePoints[i] : state.roundPoints[(i - 2) / NUM_OF_SCORE_CATEGORIES][(i - 2) % NUM_OF_SCORE_CATEGORIES];
+	}
+}
+
+GameSnapshot StateDelta::base()
+{
+	GameSnapshot state = {};
+	state.version = SNAPSHOT_VERSION;
+	return state;
+}
+
+uint32_t StateDelta::checksum(const GameSnapshot& state)
+{
+	const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&state);
+	uint32_t hash = 2166136261u;
+	for (std::size_t i = 0; i < sizeof(state); ++i)
+	{
+		hash = (hash ^ bytes[i]) * 16777619u;
+	}
+	return hash;
+}
+
+int StateDelta::encode(const GameSnapshot& from, const GameSnapshot& to, uint8_t* out)
+{
+	uint8_t* at = out + HEADER_SIZE;
+	int flags = (to.turn == P2 ? DELTA_P2_TURN : 0) | (to.firstPlayer == P2 ? DELTA_P2_FIRST : 0);
+	if (to.deckSize != from.deckSize)
+	{
+		flags |= DELTA_DECK_SIZE;
+		*at++ = to.deckSize;
+	}
+	if (to.startCard != from.startCard)
+	{
+		flags |= DELTA_START_CARD;
+		*at++ = to.startCard;
+	}
+
+	CardMask moved = EMPTY_MASK;
+	for (int where = 0; where < NUM_OF_PLACES; ++where)
+	{
+		moved |= cardsAt(from, where) ^ cardsAt(to, where);
+	}
+	if (moved)
+	{
+		flags |= DELTA_CARDS;
+		for (int where = 0; where < NUM_OF_PLACES; ++where)
+		{
+			CardMask cards = moved & cardsAt(to, where);
+			while (cards)
+			{
+				uint8_t* group = at++;
+				int count = 0;
+				for (; cards && count < MAX_GROUP; cards &= cards - 1, ++count)
+				{
+					*at++ = static_cast<uint8_t>(lowestCard(cards));
+				}
+				*group = static_cast<uint8_t>(where << PLACE_SHIFT | count);
+			}
+		}
+		*at++ = 0;
+	}
+
+	uint8_t* numOfChanges = at;
+	for (int i = 0; i < NUM_OF_POINTS; ++i)
+	{
+		int64_t diff = int64_t(pointsAt(to, i)) - pointsAt(from, i);
+		if (diff == 0)
+		{
+			continue;
+		}
+		if (!(flags & DELTA_POINTS))
+		{
+			flags |= DELTA_POINTS;
+			*at++ = 0;
+		}
+		++*numOfChanges;
+		*at++ = static_cast<uint8_t>(i);
+		uint64_t zigzag = (uint64_t(diff) << 1) ^ uint64_t(diff >> 63);
+		for (; zigzag >= 0x80; zigzag >>= 7)
+		{
+			*at++ = static_cast<uint8_t>(zigzag | 0x80);
+		}
+		*at++ = static_cast<uint8_t>(zigzag);
+	}
+
+	uint32_t sum = checksum(to);
+	out[0] = DELTA_VERSION;
+	out[1] = static_cast<uint8_t>(flags);
+	for (int i = 0; i < 4; ++i)
+	{
+		out[2 + i] = static_cast<uint8_t>(sum >> (8 * i));
+	}
+	return static_cast<int>(at - out);
+}
+
+bool StateDelta::apply(GameSnapshot& state, const uint8_t* delta, int size)
+{
+	if (size < HEADER_SIZE || delta[0] != DELTA_VERSION)
+	{
+		return false;
+	}
+	int flags = delta[1];
+	const uint8_t* at = delta + HEADER_SIZE;
+	const uint8_t* end = delta + size;
+	GameSnapshot next = state;
+	next.version = SNAPSHOT_VERSION;
+	next.turn = static_cast<uint8_t>((flags & DELTA_P2_TURN) ? P2 : P1);
+	next.firstPlayer = static_cast<uint8_t>((flags & DELTA_P2_FIRST) ? P2 : P1);
+	if (flags & DELTA_DECK_SIZE)
+	{
+		if (at == end)
+		{
+			return false;
+		}
+		next.deckSize = *at++;
+	}
+	if (flags & DELTA_START_CARD)
+	{
+		if (at == end)
+		{
+			return false;
+		}
+		next.startCard = *at++;
+	}
+
+	if (flags & DELTA_CARDS)
+	{
+		while (true)
+		{
+			if (at == end)
+			{
+				return false;
+			}
+			int group = *at++;
+			if (group == 0)
+			{
+				break;
+			}
+			int where = group >> PLACE_SHIFT;
+			int count = group & MAX_GROUP;
+			if (where >= NUM_OF_PLACES || count == 0 || end - at < count)
+			{
+				return false;
+			}
+			CardMask* mask = placeMask(next, where);
+			for (int i = 0; i < count; ++i, ++at)
+			{
+				if (*at >= NUM_OF_CARDS)
+				{
+					return false;
+				}
+				CardMask card = cardBit(*at);
+				next.hands[P1] &= ~card;
+				next.hands[P2] &= ~card;
+				next.board &= ~card;
+				next.piles[P1] &= ~card;
+				next.piles[P2] &= ~card;
+				if (mask)
+				{
+					*mask |= card;
+				}
+			}
+		}
+	}
+
+	if (flags & DELTA_POINTS)
+	{
+		if (at == end)
+		{
+			return false;
+		}
+		int numOfChanges = *at++;
+		for (int change = 0; change < numOfChanges; ++change)
+		{
+			if (at == end || *at >= NUM_OF_POINTS)
+			{
+				return false;
+			}
+			int32_t& points = pointsAt(next, *at++);
+			uint64_t zigzag = 0;
+			for (int shift = 0; ; shift += 7)
+			{
+				if (at == end || shift >= 7 * MAX_VARINT_BYTES)
+				{
+					return false;
+				}
+				uint8_t byte = *at++;
+				zigzag |= uint64_t(byte & 0x7F) << shift;
+				if (!(byte & 0x80))
+				{
+					break;
+				}
+			}
+			int64_t diff = static_cast<int64_t>(zigzag >> 1) ^ -static_cast<int64_t>(zigzag & 1);
+			points = static_cast<int32_t>(points + diff);
+		}
+	}
+
+	uint32_t expected = uint32_t(delta[2]) | uint32_t(delta[3]) << 8 | uint32_t(delta[4]) << 16 | uint32_t(delta[5]) << 24;
+	if (at != end || checksum(next) != expected)
+	{
+		return false;
+	}
+	state = next;
+	return true;
+}
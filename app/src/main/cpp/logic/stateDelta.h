@@ -0,0 +1,29 @@
+#pragma once
+#include <cstdint>
+#include "gameSnapshot.h"
+
+// binary deltas between two GameSnapshots, for keeping a remote copy of the state in sync. a delta:
+//   uint8   DELTA_VERSION
+//   uint8   flags: bit 0 P2 to move, bit 1 P2 first, bit 2 deck size follows, bit 3 start card follows,
+//           bit 4 card moves follow, bit 5 point changes follow
+//   uint32  checksum of the state after the delta (StateDelta::checksum)
+//   uint8   deck size, uint8 start card (when flagged)
+//   card moves: groups of a byte (new place << 5 | count, count 1..31) and the card indices moved there
+//           (places: P1 hand, P2 hand, board, P1 pile, P2 pile, none = deck / start card), 0 ends the list
+//   points: uint8 count, then per change a byte (0..1 game points, 2..11 round points [player][category])
+//           and the difference as a zigzag varint
+// numbers are little endian. a turn is 12 bytes on average (96 for a snapshot), never more than MAX_DELTA_BYTES.
+// the receiver applies deltas in order; a checksum mismatch means it missed one and needs a keyframe.
+// deltas carry whatever the snapshots hold, so a player's device must only get deltas between
+// GameSnapshot::viewedBy(player) states (the other hand's cards then count as the deck's).
+const uint8_t DELTA_VERSION = 1;
+const int MAX_DELTA_BYTES = 160;
+
+class StateDelta
+{
+public:
+	static GameSnapshot base();	//the state both sides start from, a delta from it is a keyframe
+	static int encode(const GameSnapshot& from, const GameSnapshot& to, uint8_t* out);	//out holds MAX_DELTA_BYTES, returns the bytes written
+	static bool apply(GameSnapshot& state, const uint8_t* delta, int size);	//false and state untouched if the delta is bad or for another state
+	static uint32_t checksum(const GameSnapshot& state);	//FNV-1a over the snapshot bytes
+};
@@ -0,0 +1,79 @@
+#include "suitSymmetry.h"
+#include "card.h"
+
+namespace
+{
+	// the suit every suit is renamed to
+	const int PERMUTATIONS[SuitSymmetry::NUM_OF_PERMUTATIONS][NUM_OF_SUITS] = {
+		{ Card::S, Card::H, Card::D, Card::C },
+		{ Card::S, Card::C, Card::D, Card::H },
+		{ Card::H, Card::S, Card::D, Card::C },
+		{ Card::H, Card::C, Card::D, Card::S },
+		{ Card::C, Card::S, Card::D, Card::H },
+		{ Card::C, Card::H, Card::D, Card::S },
+	};
+	const int INVERSES[SuitSymmetry::NUM_OF_PERMUTATIONS] = { 0, 1, 2, 4, 3, 5 };
+	const int MAX_MASKS = 8;
+}
+
+CardMask SuitSymmetry::apply(CardMask cards, int permutation)
+{
+	const int* to = PERMUTATIONS[permutation];
+	CardMask result = cards & suitMask(Card::D);
+	for (int suit = 0; suit < NUM_OF_SUITS; ++suit)
+	{
+		if (suit == Card::D)
+		{
+			continue;
+		}
+		CardMask ofSuit = cards & suitMask(suit);
+		result |= to[suit] >= suit ? ofSuit << (to[suit] - suit) : ofSuit >> (suit - to[suit]);
+	}
+	return result;
+}
+
+int SuitSymmetry::applyToCard(int cardIndex, int permutation)
+{
+	return cardIndexOf(PERMUTATIONS[permutation][suitOfIndex(cardIndex)], rankOfIndex(cardIndex));
+}
+
+Move SuitSymmetry::apply(Move move, int permutation)
+{
+	return Move(applyToCard(move.getCard(), permutation), apply(move.getCaptured(), permutation));
+}
+
+int SuitSymmetry::inverse(int permutation)
+{
+	return INVERSES[permutation];
+}
+
+int SuitSymmetry::canonicalPermutation(const CardMask* masks, int count)
+{
+	CardMask best[MAX_MASKS];
+	int bestPermutation = 0;
+	count = count < MAX_MASKS ? count : MAX_MASKS;
+	for (int i = 0; i < count; ++i)
+	{
+		best[i] = masks[i];
+	}
+	for (int permutation = 1; permutation < NUM_OF_PERMUTATIONS; ++permutation)
+	{
+		for (int i = 0; i < count; ++i)
+		{
+			CardMask permuted = apply(masks[i], permutation);
+			if (permuted != best[i])
+			{
+				if (permuted < best[i])
+				{
+					bestPermutation = permutation;
+					for (int j = 0; j < count; ++j)
+					{
+						best[j] = apply(masks[j], permutation);
+					}
+				}
+				break;
+			}
+		}
+	}
+	return bestPermutation;
+}
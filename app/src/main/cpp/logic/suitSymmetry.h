@@ -0,0 +1,20 @@
+#pragma once
+#include "move.h"
+
+// only diamonds score on their own, so spades, hearts and clubs can be renamed freely: two positions
+// that differ by a permutation of those three suits play the same. a permutation is a number
+// 0..NUM_OF_PERMUTATIONS-1, 0 is the identity. diamonds always stay diamonds.
+class SuitSymmetry
+{
+public:
+	static const int NUM_OF_PERMUTATIONS = 6;
+
+	static CardMask apply(CardMask cards, int permutation);
+	static int applyToCard(int cardIndex, int permutation);
+	static Move apply(Move move, int permutation);
+	static int inverse(int permutation);
+
+	// the permutation that makes masks[0..count-1] smallest (compared in that order, count <= 8). positions with
+	// the same canonical masks are equivalent; the first such permutation is returned, so it is deterministic.
+	static int canonicalPermutation(const CardMask* masks, int count);
+};
@@ -0,0 +1,77 @@
+#include "threadPool.h"
+
+ThreadPool::ThreadPool(int numOfThreads) : m_task(nullptr), m_nextTask(0), m_numOfTasks(0), m_unfinished(0), m_stop(false)
+{
+	if (numOfThreads <= 0)
+	{
+		numOfThreads = defaultSize();
+	}
+	for (int i = 0; i < numOfThreads; ++i)
+	{
+		m_threads.emplace_back(&ThreadPool::workerLoop, this);
+	}
+}
+
+ThreadPool::~ThreadPool()
+{
+	{
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_stop = true;
+	}
+	m_wakeUp.notify_all();
+	for (std::thread& thread : m_threads)
+	{
+		thread.join();
+	}
+}
+
+int ThreadPool::getSize() const
+{
+	return m_threads.size();
+}
+
+int ThreadPool::defaultSize()
+{
+	int cores = static_cast<int>(std::thread::hardware_concurrency());
+	return cores > 0 ? cores : 1;
+}
+
+void ThreadPool::run(int numOfTasks, const std::function<void(int)>& task)
+{
+	if (numOfTasks <= 0)
+	{
+		return;
+	}
+	std::lock_guard<std::mutex> runLock(m_runMutex);
+	std::unique_lock<std::mutex> lock(m_mutex);
+	m_task = &task;
+	m_nextTask = 0;
+	m_numOfTasks = numOfTasks;
+	m_unfinished = numOfTasks;
+	m_wakeUp.notify_all();
+	m_done.wait(lock, [this] { return m_unfinished == 0; });
+	m_task = nullptr;
+	m_numOfTasks = 0;
+}
+
+void ThreadPool::workerLoop()
+{
+	std::unique_lock<std::mutex> lock(m_mutex);
+	while (true)
+	{
+		m_wakeUp.wait(lock, [this] { return m_stop || m_nextTask < m_numOfTasks; });
+		if (m_stop)
+		{
+			return;
+		}
+		int taskNumber = m_nextTask++;
+		const std::function<void(int)>& task = *m_task;
+		lock.unlock();
+		task(taskNumber);
+		lock.lock();
+		if (--m_unfinished == 0)
+		{
+			m_done.notify_all();
+		}
+	}
+}
@@ -0,0 +1,36 @@
+#pragma once
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// a fixed set of worker threads. run() hands the task numbers 0..numOfTasks-1 to the workers
+// and blocks until all of them are done, so callers can keep per-task state in plain arrays.
+class ThreadPool
+{
+public:
+	explicit ThreadPool(int numOfThreads = 0);	//0 = one thread per core
+	~ThreadPool();
+	ThreadPool(const ThreadPool&) = delete;
+	ThreadPool& operator=(const ThreadPool&) = delete;
+
+	int getSize() const;
+	void run(int numOfTasks, const std::function<void(int)>& task);
+
+	static int defaultSize();
+
+private:
+	void workerLoop();
+
+	std::vector<std::thread> m_threads;
+	std::mutex m_runMutex;	//one run() at a time
+	std::mutex m_mutex;
+	std::condition_variable m_wakeUp;
+	std::condition_variable m_done;
+	const std::function<void(int)>* m_task;
+	int m_nextTask;
+	int m_numOfTasks;
+	int m_unfinished;
+	bool m_stop;
+};
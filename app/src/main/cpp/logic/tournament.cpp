@@ -0,0 +1,251 @@
+#include "tournament.h"
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <memory>
+#include "botRegistry.h"
+#include "threadPool.h"
+
+namespace
+{
+	const int PAIRS_PER_GRAB = 4;	//pairs a thread takes at once, keeps the shared counter cold
+	const double Z_95 = 1.959964;
+	const double MIN_SCORE = 1e-4;	//elo of a 0 or 100% score is infinite, show it as about +-1600
+	const double MIN_PAIR_VARIANCE = 1e-3;	//a pairing one bot always wins has no variance, the SPRT still has to decide it
+	const double PRIOR_MATCHES = 0.5;	//won by each side of every pairing, keeps a bot that never won out of -infinity
+	const int RATING_ITERATIONS = 1000;
+	const double RATING_TOLERANCE = 1e-10;
+
+	// mean and variance of the pair scores (0, 0.5 or 1), the share of the pair bots[0] won
+	void pairScoreMoments(const PairingResult& result, double& mean, double& variance)
+	{
+		mean = 0;
+		variance = 0;
+		if (result.pairs == 0)
+		{
+			return;
+		}
+		double squares = 0;
+		for (int won = 0; won <= 2; ++won)
+		{
+			double share = static_cast<double>(result.pairOutcomes[won]) / result.pairs;
+			mean += share * won / 2;
+			squares += share * won * won / 4;
+		}
+		variance = squares - mean * mean;
+	}
+
+	void playPair(Bot* botA, Bot* botB, uint64_t seed, uint64_t pair, int targetPoints, PairingResult& into)
+	{
+		SimulationStats pairStats = {};
+		Bot* seats[2] = { botA, botB };
+		int botIndex[2] = { 0, 1 };
+		Simulator::playMatch(seats, botIndex, seed, pair, targetPoints, pairStats);
+		Bot* swappedSeats[2] = { botB, botA };
+		int swappedIndex[2] = { 1, 0 };
+		Simulator::playMatch(swappedSeats, swappedIndex, seed, pair, targetPoints, pairStats);
+		++into.pairs;
+		++into.pairOutcomes[pairStats.wins[0]];
+		into.stats.merge(pairStats);
+	}
+}
+
+double PairingResult::getScore() const
+{
+	return stats.matches > 0 ? static_cast<double>(stats.wins[0]) / stats.matches : 0.5;
+}
+
+double PairingResult::getElo() const
+{
+	return Tournament::eloOfScore(getScore());
+}
+
+void PairingResult::getEloInterval(double& low, double& high) const
+{
+	double mean, variance;
+	pairScoreMoments(*this, mean, variance);
+	double margin = pairs > 1 ? Z_95 * std::sqrt(variance / pairs) : 0.5;
+	low = Tournament::eloOfScore(mean - margin);
+	high = Tournament::eloOfScore(mean + margin);
+}
+
+double Tournament::eloOfScore(double score)
+{
+	score = std::min(std::max(score, MIN_SCORE), 1 - MIN_SCORE);
+	return -400 * std::log10(1 / score - 1);
+}
+
+double Tournament::scoreOfElo(double elo)
+{
+	return 1 / (1 + std::pow(10, -elo / 400));
+}
+
+// the normal approximation of the generalized SPRT on the pair scores
+double Tournament::sprtLlr(const PairingResult& result, double elo0, double elo1)
+{
+	if (result.pairs < 2)
+	{
+		return 0;
+	}
+	double mean, variance;
+	pairScoreMoments(result, mean, variance);
+	variance = std::max(variance, MIN_PAIR_VARIANCE);
+	double score0 = scoreOfElo(elo0);
+	double score1 = scoreOfElo(elo1);
+	return result.pairs * (score1 - score0) * (2 * mean - score0 - score1) / (2 * variance);
+}
+
+// Bradley-Terry by minorization-maximization: strength_i = wins_i / sum_j matches_ij / (strength_i + strength_j)
+std::vector<double> Tournament::ratings(int numOfBots, const std::vector<PairingResult>& pairings)
+{
+	std::vector<double> wins(numOfBots, 0);
+	std::vector<double> strength(numOfBots, 1);
+	for (const PairingResult& pairing : pairings)
+	{
+		wins[pairing.bots[0]] += pairing.stats.wins[0] + PRIOR_MATCHES;
+		wins[pairing.bots[1]] += pairing.stats.wins[1] + PRIOR_MATCHES;
+	}
+	for (int iteration = 0; iteration < RATING_ITERATIONS; ++iteration)
+	{
+		std::vector<double> sums(numOfBots, 0);
+		for (const PairingResult& pairing : pairings)
+		{
+			double matches = pairing.stats.matches + 2 * PRIOR_MATCHES;
+			double share = matches / (strength[pairing.bots[0]] + strength[pairing.bots[1]]);
+			sums[pairing.bots[0]] += share;
+			sums[pairing.bots[1]] += share;
+		}
+		double change = 0;
+		for (int bot = 0; bot < numOfBots; ++bot)
+		{
+			double next = sums[bot] > 0 ? wins[bot] / sums[bot] : 1;
+			change = std::max(change, std::fabs(next - strength[bot]) / strength[bot]);
+			strength[bot] = next;
+		}
+		if (change < RATING_TOLERANCE)
+		{
+			break;
+		}
+	}
+
+	std::vector<double> elo(numOfBots, 0);
+	for (int bot = 0; bot < numOfBots; ++bot)
+	{
+		elo[bot] = 400 * std::log10(strength[bot] / strength[0]);
+	}
+	return elo;
+}
+
+TournamentResult Tournament::run(const TournamentConfig& config, const progress& onBatch)
+{
+	TournamentResult result = {};
+	int numOfBots = static_cast<int>(config.bots.size());
+	ThreadPool pool(config.numOfThreads);
+	int numOfThreads = pool.getSize();
+	std::vector<std::unique_ptr<Bot>> threadBots(numOfThreads * numOfBots);
+	for (int i = 0; i < numOfThreads * numOfBots; ++i)
+	{
+		threadBots[i] = BotRegistry::create(config.bots[i % numOfBots]);
+		if (!threadBots[i])
+		{
+			return result;
+		}
+	}
+	for (int a = 0; a < numOfBots; ++a)
+	{
+		for (int b = a + 1; b < numOfBots; ++b)
+		{
+			PairingResult pairing = {};
+			pairing.bots[0] = a;
+			pairing.bots[1] = b;
+			result.pairings.push_back(pairing);
+		}
+	}
+	int numOfPairings = static_cast<int>(result.pairings.size());
+	uint64_t batchSize = static_cast<uint64_t>(std::max(config.pairsPerBatch, 1));
+	uint64_t maxPairs = static_cast<uint64_t>(std::max(config.maxPairs, 0));
+	double lowerBound = std::log(config.beta / (1 - config.alpha));
+	double upperBound = std::log((1 - config.beta) / config.alpha);
+
+	std::vector<PairingResult> threadResults(numOfThreads * numOfPairings);
+	while (true)
+	{
+		// the next batch: pairs [first, first + count) of every pairing still running, laid end to end
+		std::vector<int> batchPairings;
+		std::vector<int> batchEnds;
+		int numOfTasks = 0;
+		for (int i = 0; i < numOfPairings; ++i)
+		{
+			const PairingResult& pairing = result.pairings[i];
+			if (pairing.sprt == SPRT_RUNNING && pairing.pairs < maxPairs)
+			{
+				numOfTasks += static_cast<int>(std::min(batchSize, maxPairs - pairing.pairs));
+				batchPairings.push_back(i);
+				batchEnds.push_back(numOfTasks);
+			}
+		}
+		if (numOfTasks == 0)
+		{
+			break;
+		}
+
+		std::fill(threadResults.begin(), threadResults.end(), PairingResult());
+		std::atomic<int> nextTask(0);
+		pool.run(numOfThreads, [&](int thread)
+		{
+			while (true)
+			{
+				int first = nextTask.fetch_add(PAIRS_PER_GRAB);
+				if (first >= numOfTasks)
+				{
+					return;
+				}
+				int last = std::min(first + PAIRS_PER_GRAB, numOfTasks);
+				for (int task = first; task < last; ++task)
+				{
+					int slot = static_cast<int>(std::upper_bound(batchEnds.begin(), batchEnds.end(), task) - batchEnds.begin());
+					int index = batchPairings[slot];
+					const PairingResult& pairing = result.pairings[index];
+					uint64_t pair = pairing.pairs + task - (slot > 0 ? batchEnds[slot - 1] : 0);
+					playPair(threadBots[thread * numOfBots + pairing.bots[0]].get(), threadBots[thread * numOfBots + pairing.bots[1]].get(),
+						config.seed, pair, config.targetPoints, threadResults[thread * numOfPairings + index]);
+				}
+			}
+		});
+
+		result.matches = 0;
+		for (int i = 0; i < numOfPairings; ++i)
+		{
+			PairingResult& pairing = result.pairings[i];
+			for (int thread = 0; thread < numOfThreads; ++thread)
+			{
+				const PairingResult& part = threadResults[thread * numOfPairings + i];
+				pairing.pairs += part.pairs;
+				for (int won = 0; won <= 2; ++won)
+				{
+					pairing.pairOutcomes[won] += part.pairOutcomes[won];
+				}
+				pairing.stats.merge(part.stats);
+			}
+			if (config.useSprt)
+			{
+				pairing.llr = sprtLlr(pairing, config.elo0, config.elo1);
+				if (pairing.sprt == SPRT_RUNNING && pairing.llr <= lowerBound)
+				{
+					pairing.sprt = SPRT_H0;
+				}
+				else if (pairing.sprt == SPRT_RUNNING && pairing.llr >= upperBound)
+				{
+					pairing.sprt = SPRT_H1;
+				}
+			}
+			result.matches += pairing.stats.matches;
+		}
+		result.ratings = ratings(numOfBots, result.pairings);
+		if (onBatch)
+		{
+			onBatch(result);
+		}
+	}
+	return result;
+}
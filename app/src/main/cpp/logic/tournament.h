@@ -0,0 +1,60 @@
+#pragma once
+#include <functional>
+#include <string>
+#include <vector>
+#include "simulator.h"
+
+struct TournamentConfig
+{
+	std::vector<std::string> bots;	//bot specs, see BotRegistry. every two of them are a pairing
+	int maxPairs;	//per pairing, a pair is one deal set played twice with the seats swapped
+	int pairsPerBatch;	//per pairing between two looks at the results (and the SPRT)
+	int numOfThreads;	//0 = one per core
+	uint64_t seed;
+	int targetPoints;
+	bool useSprt;	//stop a pairing once the SPRT accepts elo0 or elo1 (elo of the first bot over the second)
+	double elo0;
+	double elo1;
+	double alpha;
+	double beta;
+};
+
+enum sprtState { SPRT_RUNNING, SPRT_H0, SPRT_H1 };	//H0: the difference is elo0 (or less), H1: elo1 (or more)
+
+struct PairingResult
+{
+	int bots[2];	//indices into TournamentConfig::bots
+	uint64_t pairs;
+	uint64_t pairOutcomes[3];	//pairs in which bots[0] won 0, 1 or 2 of the two matches
+	SimulationStats stats;	//indexed by bots[0] / bots[1]
+	double llr;
+	int sprt;
+
+	double getScore() const;	//share of the matches bots[0] won
+	double getElo() const;	//of bots[0] over bots[1]
+	void getEloInterval(double& low, double& high) const;	//95%, from the variance of the pair scores
+};
+
+struct TournamentResult
+{
+	std::vector<PairingResult> pairings;
+	std::vector<double> ratings;	//elo per bot from all pairings at once (Bradley-Terry), the first bot is 0
+	uint64_t matches;
+};
+
+// round robin between any number of bots. pair p of every pairing plays match p of Simulator (the same deals
+// for all pairings) twice, the second time with the seats swapped, so a lucky deal helps both bots alike and
+// the pair is the unit for the statistics. the result depends only on the config, never on the threads:
+// every pair is a pure function of (seed, pair), and the SPRT only looks between batches.
+class Tournament
+{
+public:
+	typedef std::function<void(const TournamentResult& soFar)> progress;
+
+	static TournamentResult run(const TournamentConfig& config, const progress& onBatch = progress());	//empty if a bot spec is unknown
+
+	static double eloOfScore(double score);
+	static double scoreOfElo(double elo);
+	static double sprtLlr(const PairingResult& result, double elo0, double elo1);	//log likelihood ratio of H1 over H0
+	static std::vector<double> ratings(int numOfBots, const std::vector<PairingResult>& pairings);
+};
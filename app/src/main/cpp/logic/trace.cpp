@@ -0,0 +1,313 @@
+#include "trace.h"
+#include <algorithm>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <mutex>
+
+namespace
+{
+	struct NameStat
+	{
+		std::atomic<const char*> name;
+		std::atomic<bool> isCounter;
+		std::atomic<uint64_t> count;
+		std::atomic<int64_t> total;
+		std::atomic<int64_t> max;
+	};
+
+	struct Event
+	{
+		const char* name;
+		int64_t start;
+		int64_t value;	//duration or counter value
+		bool isCounter;
+	};
+
+	// written by its thread only; readers copy it and throw away what was rewritten meanwhile
+	struct ThreadBuffer
+	{
+		int lane;
+		std::atomic<bool> inUse;
+		std::atomic<uint32_t> epoch;	//the clear() it was last reset for
+		std::atomic<uint64_t> written;	//events ever written, the ring holds the last TRACE_BUFFER_EVENTS
+		NameStat stats[TRACE_MAX_NAMES];
+		Event events[TRACE_BUFFER_EVENTS];
+	};
+
+	// buffers outlive their threads, the events of a finished thread can still be dumped, and a new
+	// thread takes over a free one. never freed, so threads still running at exit can't touch a dead one
+	std::mutex& buffersMutex()
+	{
+		static std::mutex* mutex = new std::mutex();
+		return *mutex;
+	}
+
+	std::vector<ThreadBuffer*>& buffers()
+	{
+		static std::vector<ThreadBuffer*>* all = new std::vector<ThreadBuffer*>();
+		return *all;
+	}
+
+	std::atomic<uint32_t> g_epoch(0);
+
+	struct BufferOwner
+	{
+		ThreadBuffer* buffer = nullptr;
+
+		~BufferOwner()
+		{
+			if (buffer)
+			{
+				buffer->inUse.store(false, std::memory_order_release);
+			}
+		}
+	};
+
+	thread_local BufferOwner t_owner;
+
+	void reset(ThreadBuffer& buffer, uint32_t epoch)
+	{
+		for (NameStat& stat : buffer.stats)
+		{
+			stat.name.store(nullptr, std::memory_order_relaxed);
+		}
+		buffer.written.store(0, std::memory_order_relaxed);
+		buffer.epoch.store(epoch, std::memory_order_release);
+	}
+
+	ThreadBuffer& ownBuffer()
+	{
+		ThreadBuffer* buffer = t_owner.buffer;
+		if (!buffer)
+		{
+			std::lock_guard<std::mutex> lock(buffersMutex());
+			for (ThreadBuffer* free : buffers())
+			{
+				if (!free->inUse.load(std::memory_order_acquire))
+				{
+					buffer = free;
+					break;
+				}
+			}
+			if (!buffer)
+			{
+				buffer = new ThreadBuffer();
+				buffer->lane = static_cast<int>(buffers().size()) + 1;
+				buffers().push_back(buffer);
+			}
+			buffer->inUse.store(true, std::memory_order_relaxed);
+			t_owner.buffer = buffer;
+		}
+		uint32_t epoch = g_epoch.load(std::memory_order_acquire);
+		if (buffer->epoch.load(std::memory_order_relaxed) != epoch)
+		{
+			reset(*buffer, epoch);
+		}
+		return *buffer;
+	}
+
+	void record(const char* name, int64_t start, int64_t value, bool isCounter)
+	{
+		ThreadBuffer& buffer = ownBuffer();
+		uint64_t written = buffer.written.load(std::memory_order_relaxed);
+		buffer.events[written % TRACE_BUFFER_EVENTS] = { name, start, value, isCounter };
+		buffer.written.store(written + 1, std::memory_order_release);
+
+		// open addressing on the name pointer, only this thread adds names
+		std::size_t slot = static_cast<std::size_t>((reinterpret_cast<uintptr_t>(name) >> 3) * 0x9E3779B97F4A7C15ULL >> 58);
+		for (int probe = 0; probe < TRACE_MAX_NAMES; ++probe, slot = (slot + 1) % TRACE_MAX_NAMES)
+		{
+			NameStat& stat = buffer.stats[slot];
+			const char* slotName = stat.name.load(std::memory_order_relaxed);
+			if (slotName == nullptr)
+			{
+				stat.isCounter.store(isCounter, std::memory_order_relaxed);
+				stat.count.store(0, std::memory_order_relaxed);
+				stat.total.store(0, std::memory_order_relaxed);
+				stat.max.store(value, std::memory_order_relaxed);
+				stat.name.store(name, std::memory_order_release);
+			}
+			else if (slotName != name)
+			{
+				continue;
+			}
+			stat.count.store(stat.count.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+			stat.total.store(stat.total.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+			if (value > stat.max.load(std::memory_order_relaxed))
+			{
+				stat.max.store(value, std::memory_order_relaxed);
+			}
+			return;
+		}
+	}
+
+	// the events a buffer still holds, oldest first
+	void copyEvents(const ThreadBuffer& buffer, uint32_t epoch, std::vector<Event>& out)
+	{
+		out.clear();
+		if (buffer.epoch.load(std::memory_order_acquire) != epoch)
+		{
+			return;
+		}
+		uint64_t end = buffer.written.load(std::memory_order_acquire);
+		uint64_t begin = end > TRACE_BUFFER_EVENTS ? end - TRACE_BUFFER_EVENTS : 0;
+		for (uint64_t i = begin; i < end; ++i)
+		{
+			out.push_back(buffer.events[i % TRACE_BUFFER_EVENTS]);
+		}
+		uint64_t after = buffer.written.load(std::memory_order_acquire);
+		if (buffer.epoch.load(std::memory_order_acquire) != epoch || after < end)
+		{
+			out.clear();
+			return;
+		}
+		uint64_t overwritten = after > TRACE_BUFFER_EVENTS ? after - TRACE_BUFFER_EVENTS : 0;
+		if (overwritten > begin)
+		{
+			out.erase(out.begin(), out.begin() + static_cast<std::ptrdiff_t>(std::min(overwritten, end) - begin));
+		}
+	}
+}
+
+std::atomic<bool> Trace::s_enabled(false);
+
+bool Trace::isCompiledIn()
+{
+#ifdef SHKUBA_TRACE
+	return true;
+#else
+	return false;
+#endif
+}
+
+void Trace::setEnabled(bool enabled)
+{
+	s_enabled.store(enabled && isCompiledIn(), std::memory_order_relaxed);
+}
+
+void Trace::clear()
+{
+	g_epoch.fetch_add(1, std::memory_order_acq_rel);
+}
+
+int64_t Trace::now()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+void Trace::complete(const char* name, int64_t startNs, int64_t durationNs)
+{
+	record(name, startNs, durationNs, false);
+}
+
+void Trace::counter(const char* name, int64_t value)
+{
+	if (isEnabled())
+	{
+		record(name, now(), value, true);
+	}
+}
+
+std::vector<TraceStat> Trace::summary()
+{
+	uint32_t epoch = g_epoch.load(std::memory_order_acquire);
+	std::vector<TraceStat> stats;
+	std::lock_guard<std::mutex> lock(buffersMutex());
+	for (const ThreadBuffer* buffer : buffers())
+	{
+		if (buffer->epoch.load(std::memory_order_acquire) != epoch)
+		{
+			continue;
+		}
+		for (const NameStat& stat : buffer->stats)
+		{
+			const char* name = stat.name.load(std::memory_order_acquire);
+			if (!name)
+			{
+				continue;
+			}
+			auto merged = std::find_if(stats.begin(), stats.end(), [name](const TraceStat& s) { return s.name == name; });
+			if (merged == stats.end())
+			{
+				stats.push_back({ name, stat.isCounter.load(std::memory_order_relaxed), 0, 0, stat.max.load(std::memory_order_relaxed) });
+				merged = stats.end() - 1;
+			}
+			merged->count += stat.count.load(std::memory_order_relaxed);
+			merged->total += stat.total.load(std::memory_order_relaxed);
+			merged->max = std::max(merged->max, stat.max.load(std::memory_order_relaxed));
+		}
+	}
+	std::sort(stats.begin(), stats.end(), [](const TraceStat& a, const TraceStat& b)
+	{
+		if (a.isCounter != b.isCounter)
+		{
+			return !a.isCounter;
+		}
+		return a.isCounter ? std::string(a.name) < b.name : a.total > b.total;
+	});
+	return stats;
+}
+
+std::string Trace::toChromeJson()
+{
+	uint32_t epoch = g_epoch.load(std::memory_order_acquire);
+	std::vector<std::pair<int, std::vector<Event>>> lanes;
+	int64_t origin = INT64_MAX;
+	{
+		std::lock_guard<std::mutex> lock(buffersMutex());
+		for (const ThreadBuffer* buffer : buffers())
+		{
+			lanes.emplace_back(buffer->lane, std::vector<Event>());
+			copyEvents(*buffer, epoch, lanes.back().second);
+			for (const Event& event : lanes.back().second)
+			{
+				origin = std::min(origin, event.start);
+			}
+		}
+	}
+
+	std::string json = "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[";
+	char line[256];
+	bool first = true;
+	for (const auto& lane : lanes)
+	{
+		if (lane.second.empty())
+		{
+			continue;
+		}
+		std::snprintf(line, sizeof(line), "%s\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"shkuba %d\"}}",
+			first ? "" : ",", lane.first, lane.first);
+		json += line;
+		first = false;
+		for (const Event& event : lane.second)
+		{
+			double ts = (event.start - origin) / 1000.0;
+			if (event.isCounter)
+			{
+				std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"ph\":\"C\",\"ts\":%.3f,\"pid\":1,\"tid\":%d,\"args\":{\"value\":%" PRId64 "}}",
+					event.name, ts, lane.first, event.value);
+			}
+			else
+			{
+				std::snprintf(line, sizeof(line), ",\n{\"name\":\"%s\",\"cat\":\"shkuba\",\"ph\":\"X\",\"ts\":%.3f,\"dur\":%.3f,\"pid\":1,\"tid\":%d}",
+					event.name, ts, event.value / 1000.0, lane.first);
+			}
+			json += line;
+		}
+	}
+	json += "\n]}\n";
+	return json;
+}
+
+bool Trace::writeChromeJson(const char* path)
+{
+	std::FILE* file = std::fopen(path, "wb");
+	if (!file)
+	{
+		return false;
+	}
+	std::string json = toChromeJson();
+	bool ok = std::fwrite(json.data(), 1, json.size(), file) == json.size();
+	return std::fclose(file) == 0 && ok;
+}
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// engine instrumentation: scoped timers and counters. every thread records into its own ring of the last
+// TRACE_BUFFER_EVENTS events (no locks, no allocation after the first event of a thread) and into per name
+// totals that never wrap. the rings dump as Chrome trace event JSON (chrome://tracing, ui.perfetto.dev).
+// compiled in when SHKUBA_TRACE is defined (cmake -DSHKUBA_TRACE=OFF leaves the macros empty) and recording
+// only after Trace::setEnabled(true); until then a scope costs one relaxed load.
+// names must be string literals without quotes or backslashes, only the pointer is kept.
+const int TRACE_BUFFER_EVENTS = 1 << 13;
+const int TRACE_MAX_NAMES = 64;	//per thread, events of more names are only in the ring
+
+#ifdef SHKUBA_TRACE
+#define TRACE_CONCAT_INNER(a, b) a##b
+#define TRACE_CONCAT(a, b) TRACE_CONCAT_INNER(a, b)
+#define TRACE_SCOPE(name) TraceScope TRACE_CONCAT(traceScope, __LINE__)(name)
+#define TRACE_COUNTER(name, value) Trace::counter(name, value)
+#else
+#define TRACE_SCOPE(name) ((void)0)
+#define TRACE_COUNTER(name, value) ((void)0)
+#endif
+
+struct TraceStat
+{
+	const char* name;
+	bool isCounter;	//a counter: total is the sum of the values and max the largest, not nanoseconds
+	uint64_t count;
+	int64_t total;
+	int64_t max;
+};
+
+class Trace
+{
+public:
+	static bool isCompiledIn();	//false when built without SHKUBA_TRACE, everything then stays empty
+	static void setEnabled(bool enabled);
+	static bool isEnabled()
+	{
+		return s_enabled.load(std::memory_order_relaxed);
+	}
+	static void clear();	//forgets what every thread recorded so far
+
+	static int64_t now();	//nanoseconds, the clock of all events
+	static void complete(const char* name, int64_t startNs, int64_t durationNs);
+	static void counter(const char* name, int64_t value);
+
+	static std::vector<TraceStat> summary();	//per name over all threads since the last clear, timers by total time first
+	static std::string toChromeJson();	//what the rings still hold, a lane per thread
+	static bool writeChromeJson(const char* path);
+
+private:
+	static std::atomic<bool> s_enabled;
+};
+
+class TraceScope
+{
+public:
+	explicit TraceScope(const char* name) :
+		m_name(Trace::isEnabled() ? name : nullptr), m_start(m_name ? Trace::now() : 0)
+	{
+	}
+
+	~TraceScope()
+	{
+		if (m_name)
+		{
+			Trace::complete(m_name, m_start, Trace::now() - m_start);
+		}
+	}
+
+	TraceScope(const TraceScope&) = delete;
+	TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+	const char* m_name;
+	int64_t m_start;
+};
@@ -1,19 +1,75 @@
 #include <jni.h>
 #include <android/log.h>
+#include <cstdio>
+#include <cstring>
+#include <string>
 #include "board.h"
 #include "card.h"
 #include "deck.h"
 #include "hand.h"
 #include "round.h"
+#include "game.h"
+#include "moveGen.h"
+#include "gameSnapshot.h"
+#include "stateDelta.h"
+#include "botThinker.h"
+#include "recordWriter.h"
+#include "threadPool.h"
+#include "trace.h"
 
 #define LOG_TAG "ShkubaJNI"
 #define LOGI(...) __android_log_print(ANDROID_LOG_INFO, LOG_TAG, __VA_ARGS__)
 #define LOGE(...) __android_log_print(ANDROID_LOG_ERROR, LOG_TAG, __VA_ARGS__)
 
-extern "C" {
+// natives are bound with RegisterNatives in JNI_OnLoad and the "nativeHandle" field IDs are
+// resolved there once, so every call below costs a single GetLongField to reach its object.
+
+namespace {
+
+struct HandleFields {
+    jfieldID board;
+    jfieldID deck;
+    jfieldID hand;
+    jfieldID game;
+};
+
+HandleFields handles = {};
+
+JavaVM* javaVm = nullptr;
+jmethodID onBotMoveMethod = nullptr;	//BotMoveListener.onBotMove(int, long)
+
+template <typename T>
+T* fromHandle(JNIEnv* env, jobject thiz, jfieldID field) {
+    return reinterpret_cast<T*>(env->GetLongField(thiz, field));
+}
+
+// leave a core to the UI thread
+int searchThreads() {
+    int cores = ThreadPool::defaultSize();
+    return cores > 1 ? cores - 1 : 1;
+}
+
+// one match as the app plays it: the score so far, the round in progress and the bot thinking about it.
+// the thinker is declared last so it is stopped before the rest goes away.
+struct NativeGame {
+    Game game;
+    Round round;
+    RecordWriter recorder;  // closed unless nativeRecordTo was called
+    RoundRecord roundRecord;  // empty until a round starts while recording
+    bool choosingStartCard;  // dealt, the first player hasn't taken or left the start card yet
+    BotThinker thinker;
+    GameSnapshot deltaBase[2];  // per viewer, the state the last delta brought that player's device to
+
+    NativeGame() : game(P1), round(P1), choosingStartCard(false), thinker(searchThreads()),
+                   deltaBase{StateDelta::base(), StateDelta::base()} {}
+};
+
+jlong toJavaMove(Move move) {
+    return static_cast<jlong>(move.getKey());
+}
 
 // Board JNI Methods
-JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Board_nativeCreate(JNIEnv* env, jobject thiz) {
+jlong Board_nativeCreate(JNIEnv* env, jobject thiz) {
     try {
         Board* board = new Board();
         LOGI("Board created successfully");
@@ -24,7 +80,7 @@ JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Board_nativeCreate(JNIEnv* env, j
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Board_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
+void Board_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
     Board* board = reinterpret_cast<Board*>(handle);
     if (board) {
         delete board;
@@ -32,103 +88,58 @@ JNIEXPORT void JNICALL Java_com_dinari_shkuba_Board_nativeDestroy(JNIEnv* env, j
     }
 }
 
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_Board_getBoardSize(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Board* board = reinterpret_cast<Board*>(handle);
+jint Board_getBoardSizeNative(JNIEnv* env, jobject thiz) {
+    Board* board = fromHandle<Board>(env, thiz, handles.board);
     if (board) {
         return static_cast<jint>(board->getBoardSize());
     }
     return 0;
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Board_addToBoard(JNIEnv* env, jobject thiz, jint suit, jint rank) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Board* board = reinterpret_cast<Board*>(handle);
+void Board_addToBoard(JNIEnv* env, jobject thiz, jint suit, jint rank) {
+    Board* board = fromHandle<Board>(env, thiz, handles.board);
     if (board) {
         Card card(static_cast<Card::suit>(suit), rank);
         board->addToBoard(card);
     }
 }
 
-JNIEXPORT jintArray JNICALL Java_com_dinari_shkuba_Board_getBoard(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Board* board = reinterpret_cast<Board*>(handle);
-
-    if (board) {
-        std::vector<Card> cards = board->getBoard();
-        jintArray result = env->NewIntArray(cards.size() * 2);
-        jint* elements = env->GetIntArrayElements(result, nullptr);
-
-        for (size_t i = 0; i < cards.size(); i++) {
-            elements[i * 2] = static_cast<jint>(cards[i].getSuit());
-            elements[i * 2 + 1] = static_cast<jint>(cards[i].getRank());
-        }
-
-        env->ReleaseIntArrayElements(result, elements, 0);
-        return result;
-    }
-    return env->NewIntArray(0);
-}
-
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_Board_getBoardSizeNative(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Board* board = reinterpret_cast<Board*>(handle);
-    if (board) {
-        return static_cast<jint>(board->getBoardSize());
-    }
-    return 0;
-}
-
-// Card JNI Methods
-JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Card_nativeCreate(JNIEnv* env, jobject thiz, jint suit, jint rank) {
-    try {
-        Card* card = new Card(static_cast<Card::suit>(suit), rank);
-        return reinterpret_cast<jlong>(card);
-    } catch (const std::exception& e) {
-        LOGE("Error creating Card: %s", e.what());
-        return 0;
-    }
-}
-
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Card_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        delete card;
+jintArray Board_getBoard(JNIEnv* env, jobject thiz) {
+    Board* board = fromHandle<Board>(env, thiz, handles.board);
+    if (!board) {
+        return env->NewIntArray(0);
     }
-}
 
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_Card_getSuit(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        return static_cast<jint>(card->getSuit());
+    // straight from the mask into one region copy, no intermediate vector
+    jint elements[NUM_OF_CARDS * 2];
+    jsize count = 0;
+    for (CardMask cards = board->getMask(); cards; cards &= cards - 1) {
+        Card card(lowestCard(cards));
+        elements[count++] = static_cast<jint>(card.getSuit());
+        elements[count++] = static_cast<jint>(card.getRank());
     }
-    return -1;
+    jintArray result = env->NewIntArray(count);
+    env->SetIntArrayRegion(result, 0, count, elements);
+    return result;
 }
 
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_Card_getRank(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        return static_cast<jint>(card->getRank());
+// NativeCard JNI Methods
+// cards are flyweights: Kotlin keeps a card id (the card index) and reads suit and rank from this
+// table, fetched once. no native object per card.
+jintArray NativeCard_nativeCardTable(JNIEnv* env, jclass cls) {
+    jint table[NUM_OF_CARDS * 2];
+    for (int i = 0; i < NUM_OF_CARDS; ++i) {
+        const Card& card = Card::fromIndex(i);
+        table[i * 2] = static_cast<jint>(card.getSuit());
+        table[i * 2 + 1] = static_cast<jint>(card.getRank());
     }
-    return -1;
+    jintArray result = env->NewIntArray(NUM_OF_CARDS * 2);
+    env->SetIntArrayRegion(result, 0, NUM_OF_CARDS * 2, table);
+    return result;
 }
 
 // Deck JNI Methods
-JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Deck_nativeCreate(JNIEnv* env, jobject thiz) {
+jlong Deck_nativeCreate(JNIEnv* env, jobject thiz) {
     try {
         Deck* deck = new Deck();
         return reinterpret_cast<jlong>(deck);
@@ -138,46 +149,34 @@ JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Deck_nativeCreate(JNIEnv* env, jo
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Deck_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
+void Deck_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
     Deck* deck = reinterpret_cast<Deck*>(handle);
     if (deck) {
         delete deck;
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Deck_shuffle(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Deck* deck = reinterpret_cast<Deck*>(handle);
+void Deck_shuffle(JNIEnv* env, jobject thiz) {
+    Deck* deck = fromHandle<Deck>(env, thiz, handles.deck);
     if (deck) {
         deck->shuffleDeck();
     }
 }
 
-JNIEXPORT jintArray JNICALL Java_com_dinari_shkuba_Deck_dealCard(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Deck* deck = reinterpret_cast<Deck*>(handle);
-
-    if (deck) {
-        try {
-            Card card = deck->draw();
-            jintArray result = env->NewIntArray(2);
-            jint cardData[2] = {static_cast<jint>(card.getSuit()), static_cast<jint>(card.getRank())};
-            env->SetIntArrayRegion(result, 0, 2, cardData);
-            return result;
-        } catch (const std::exception& e) {
-            LOGE("Error dealing card: %s", e.what());
-            return env->NewIntArray(0);
-        }
+jintArray Deck_dealCard(JNIEnv* env, jobject thiz) {
+    Deck* deck = fromHandle<Deck>(env, thiz, handles.deck);
+    if (deck && deck->getSize() > 0) {
+        Card card = deck->draw();
+        jintArray result = env->NewIntArray(2);
+        jint cardData[2] = {static_cast<jint>(card.getSuit()), static_cast<jint>(card.getRank())};
+        env->SetIntArrayRegion(result, 0, 2, cardData);
+        return result;
     }
     return env->NewIntArray(0);
 }
 
 // Hand JNI Methods
-JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Hand_nativeCreate(JNIEnv* env, jobject thiz) {
+jlong Hand_nativeCreate(JNIEnv* env, jobject thiz) {
     try {
         Hand* hand = new Hand();
         return reinterpret_cast<jlong>(hand);
@@ -187,62 +186,389 @@ JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_Hand_nativeCreate(JNIEnv* env, jo
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Hand_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
+void Hand_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
     Hand* hand = reinterpret_cast<Hand*>(handle);
     if (hand) {
         delete hand;
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_Hand_addCard(JNIEnv* env, jobject thiz, jint suit, jint rank) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Hand* hand = reinterpret_cast<Hand*>(handle);
+void Hand_addCard(JNIEnv* env, jobject thiz, jint suit, jint rank) {
+    Hand* hand = fromHandle<Hand>(env, thiz, handles.hand);
     if (hand) {
         Card card(static_cast<Card::suit>(suit), rank);
         hand->addToHand(card);
     }
 }
 
-// NativeCard JNI Methods
-JNIEXPORT jlong JNICALL Java_com_dinari_shkuba_NativeCard_nativeCreate(JNIEnv* env, jobject thiz, jint suit, jint rank) {
+// NativeGame JNI Methods
+jlong NativeGame_nativeCreate(JNIEnv* env, jobject thiz) {
     try {
-        Card* card = new Card(static_cast<Card::suit>(suit), rank);
-        return reinterpret_cast<jlong>(card);
+        NativeGame* game = new NativeGame();
+        return reinterpret_cast<jlong>(game);
     } catch (const std::exception& e) {
-        __android_log_print(ANDROID_LOG_ERROR, "ShkubaJNI", "Error creating NativeCard: %s", e.what());
+        LOGE("Error creating NativeGame: %s", e.what());
         return 0;
     }
 }
 
-JNIEXPORT void JNICALL Java_com_dinari_shkuba_NativeCard_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        delete card;
+void NativeGame_nativeDestroy(JNIEnv* env, jobject thiz, jlong handle) {
+    NativeGame* game = reinterpret_cast<NativeGame*>(handle);
+    if (game) {
+        delete game;
     }
 }
 
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_NativeCard_nativeGetSuit(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        return static_cast<jint>(card->getSuit());
+// deals the next round up to the start card, which readState then shows; nativeChooseStartCard starts the play
+void NativeGame_nativeDealRound(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni NativeGame.dealRound");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (game) {
+        game->thinker.cancel();
+        game->round = Round(game->game.getFirstPlayer());
+        game->choosingStartCard = true;
     }
-    return -1;
 }
 
-JNIEXPORT jint JNICALL Java_com_dinari_shkuba_NativeCard_nativeGetRank(JNIEnv* env, jobject thiz) {
-    jclass cls = env->GetObjectClass(thiz);
-    jfieldID handleField = env->GetFieldID(cls, "nativeHandle", "J");
-    jlong handle = env->GetLongField(thiz, handleField);
-    Card* card = reinterpret_cast<Card*>(handle);
-    if (card) {
-        return card->getRank();
+// the first player's Round::firstMiniRound choice, false unless a dealt round is waiting for it
+jboolean NativeGame_nativeChooseStartCard(JNIEnv* env, jobject thiz, jboolean takeStartCard) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (!game || !game->choosingStartCard) {
+        return JNI_FALSE;
     }
-    return -1;
+    if (game->recorder.isOpen()) {
+        game->roundRecord.beginDealt(game->round, takeStartCard == JNI_TRUE);
+    }
+    game->round.firstMiniRound(takeStartCard == JNI_TRUE);
+    game->choosingStartCard = false;
+    return JNI_TRUE;
+}
+
+// what the bot would choose with the dealt start card (Bot::takeStartCard), for when the bot plays first
+jboolean NativeGame_nativeBotTakesStartCard(JNIEnv* env, jobject thiz) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    return game && game->choosingStartCard && game->thinker.takeStartCard(game->round) ? JNI_TRUE : JNI_FALSE;
+}
+
+jboolean NativeGame_nativePlayMove(JNIEnv* env, jobject thiz, jint cardIndex, jlong captured) {
+    TRACE_SCOPE("jni NativeGame.playMove");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (!game || game->round.isRoundOver()) {
+        return JNI_FALSE;
+    }
+    game->thinker.cancel();
+    // Move packs the card above the captured bits, so out of range values would turn into a different move
+    if (cardIndex < 0 || cardIndex >= NUM_OF_CARDS || (static_cast<CardMask>(captured) & ~FULL_DECK_MASK) != 0) {
+        return JNI_FALSE;
+    }
+    Round& round = game->round;
+    Move move(cardIndex, static_cast<CardMask>(captured));
+    if (!MoveGen::isLegal(round.getHand(round.getTurn()), round.getBoard(), move)) {
+        return JNI_FALSE;
+    }
+    if (game->recorder.isOpen() && game->roundRecord.getSize() > 0) {
+        game->roundRecord.addMove(move, round.getBoard().getMask());
+    }
+    round.makeMove(move);
+    if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0) {
+        if (round.getDeckSize() > 0) {
+            round.giveCardsToPlayers();
+        } else {
+            round.collectBoard();
+            round.countPiles();
+            game->recorder.write(game->roundRecord);
+            game->recorder.flush();
+            game->roundRecord = RoundRecord();
+            game->game.addToP1Points(round.getP1Points());
+            game->game.addToP2Points(round.getP2Points());
+            game->game.changeFirstPlayer();
+        }
+    }
+    return JNI_TRUE;
+}
+
+jint NativeGame_nativeGetGameState(JNIEnv* env, jobject thiz, jobject buffer) {
+    TRACE_SCOPE("jni NativeGame.readState");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    void* address = env->GetDirectBufferAddress(buffer);
+    if (!game || !address || env->GetDirectBufferCapacity(buffer) < static_cast<jlong>(sizeof(GameSnapshot))) {
+        return 0;
+    }
+    GameSnapshot snapshot = GameSnapshot::capture(game->game, game->round);
+    std::memcpy(address, &snapshot, sizeof(snapshot));
+    return static_cast<jint>(sizeof(snapshot));
 }
 
-} // extern "C"
+// every round from the next one on is appended to the file (logic/gameRecord.h)
+jboolean NativeGame_nativeRecordTo(JNIEnv* env, jobject thiz, jstring path) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    const char* chars = path ? env->GetStringUTFChars(path, nullptr) : nullptr;
+    if (!game || !chars) {
+        return JNI_FALSE;
+    }
+    game->roundRecord = RoundRecord();
+    bool opened = game->recorder.open(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    if (!opened) {
+        LOGE("Can't create the game record file");
+    }
+    return opened ? JNI_TRUE : JNI_FALSE;
+}
+
+// the listener is called on the thinking thread, attached to the VM for the call only
+jboolean NativeGame_nativeStartThinking(JNIEnv* env, jobject thiz, jint timeMs, jint iterations, jobject listener) {
+    TRACE_SCOPE("jni NativeGame.startBotThinking");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (!game || (timeMs <= 0 && iterations <= 0) || game->round.isRoundOver()) {
+        return JNI_FALSE;
+    }
+    BotThinker::callback onDone;
+    jobject listenerRef = nullptr;
+    if (listener && onBotMoveMethod) {
+        listenerRef = env->NewGlobalRef(listener);
+        onDone = [listenerRef](Move move, bool cancelled) {
+            JNIEnv* threadEnv = nullptr;
+            if (javaVm->AttachCurrentThread(&threadEnv, nullptr) != JNI_OK) {
+                LOGE("Bot thread could not attach to the VM");
+                return;
+            }
+            if (!cancelled) {
+                threadEnv->CallVoidMethod(listenerRef, onBotMoveMethod, static_cast<jint>(move.getCard()),
+                                          static_cast<jlong>(move.getCaptured()));
+                if (threadEnv->ExceptionCheck()) {
+                    threadEnv->ExceptionDescribe();
+                    threadEnv->ExceptionClear();
+                }
+            }
+            threadEnv->DeleteGlobalRef(listenerRef);
+            javaVm->DetachCurrentThread();
+        };
+    }
+    bool started = game->thinker.start(game->round, timeMs, iterations, onDone);
+    if (!started && listenerRef) {
+        env->DeleteGlobalRef(listenerRef);  // nothing to think about (e.g. before the deal), the callback never runs
+    }
+    return started ? JNI_TRUE : JNI_FALSE;
+}
+
+jlong NativeGame_nativePollBotMove(JNIEnv* env, jobject thiz) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    Move move;
+    return game && game->thinker.poll(move) ? toJavaMove(move) : -1;
+}
+
+jlong NativeGame_nativeBestBotMoveNow(JNIEnv* env, jobject thiz) {
+    TRACE_SCOPE("jni NativeGame.bestBotMoveNow");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    Move move;
+    return game && game->thinker.bestMoveNow(move) ? toJavaMove(move) : -1;
+}
+
+void NativeGame_nativeCancelThinking(JNIEnv* env, jobject thiz) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (game) {
+        game->thinker.cancel();
+    }
+}
+
+bool isPlayer(jint viewer) {
+    return viewer == P1 || viewer == P2;
+}
+
+// the change since the last delta for the viewer's device (logic/stateDelta.h); the first one, and the first
+// after a reset, is a keyframe. the other hand is cleared before encoding, so neither the delta nor its
+// checksum carries it
+jint NativeGame_nativeGetStateDelta(JNIEnv* env, jobject thiz, jobject buffer, jint viewer) {
+    TRACE_SCOPE("jni NativeGame.nextStateDelta");
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    uint8_t* address = static_cast<uint8_t*>(env->GetDirectBufferAddress(buffer));
+    if (!game || !address || !isPlayer(viewer) || env->GetDirectBufferCapacity(buffer) < MAX_DELTA_BYTES) {
+        return 0;
+    }
+    players who = static_cast<players>(viewer);
+    GameSnapshot snapshot = GameSnapshot::capture(game->game, game->round).viewedBy(who);
+    int size = StateDelta::encode(game->deltaBase[who], snapshot, address);
+    game->deltaBase[who] = snapshot;
+    return static_cast<jint>(size);
+}
+
+void NativeGame_nativeResetStateDelta(JNIEnv* env, jobject thiz, jint viewer) {
+    NativeGame* game = fromHandle<NativeGame>(env, thiz, handles.game);
+    if (game && isPlayer(viewer)) {
+        game->deltaBase[viewer] = StateDelta::base();
+    }
+}
+
+// StateSync JNI Methods: the state lives in a Kotlin owned direct buffer, there is no native object
+jboolean StateSync_nativeApplyDelta(JNIEnv* env, jclass cls, jobject state, jobject delta, jint size) {
+    TRACE_SCOPE("jni StateSync.apply");
+    void* stateAddress = env->GetDirectBufferAddress(state);
+    const uint8_t* deltaAddress = static_cast<const uint8_t*>(env->GetDirectBufferAddress(delta));
+    if (!stateAddress || !deltaAddress || env->GetDirectBufferCapacity(state) < static_cast<jlong>(sizeof(GameSnapshot)) ||
+        size < 0 || env->GetDirectBufferCapacity(delta) < size) {
+        return JNI_FALSE;
+    }
+    GameSnapshot snapshot;
+    std::memcpy(&snapshot, stateAddress, sizeof(snapshot));
+    if (!StateDelta::apply(snapshot, deltaAddress, size)) {
+        return JNI_FALSE;
+    }
+    std::memcpy(stateAddress, &snapshot, sizeof(snapshot));
+    return JNI_TRUE;
+}
+
+void StateSync_nativeResetState(JNIEnv* env, jclass cls, jobject state) {
+    void* address = env->GetDirectBufferAddress(state);
+    if (address && env->GetDirectBufferCapacity(state) >= static_cast<jlong>(sizeof(GameSnapshot))) {
+        GameSnapshot snapshot = StateDelta::base();
+        std::memcpy(address, &snapshot, sizeof(snapshot));
+    }
+}
+
+// EngineTrace JNI Methods: the process wide tracing of logic/trace.h
+jboolean EngineTrace_nativeIsCompiledIn(JNIEnv* env, jclass cls) {
+    return Trace::isCompiledIn() ? JNI_TRUE : JNI_FALSE;
+}
+
+void EngineTrace_nativeSetEnabled(JNIEnv* env, jclass cls, jboolean enabled) {
+    Trace::setEnabled(enabled == JNI_TRUE);
+}
+
+void EngineTrace_nativeClear(JNIEnv* env, jclass cls) {
+    Trace::clear();
+}
+
+// a line per name: name, 'T' (timer, nanoseconds) or 'C' (counter), count, total, max; tab separated
+jstring EngineTrace_nativeSummary(JNIEnv* env, jclass cls) {
+    std::string text;
+    char line[64];
+    for (const TraceStat& stat : Trace::summary()) {
+        text += stat.name;
+        std::snprintf(line, sizeof(line), "\t%c\t%llu\t%lld\t%lld\n", stat.isCounter ? 'C' : 'T',
+                      static_cast<unsigned long long>(stat.count), static_cast<long long>(stat.total),
+                      static_cast<long long>(stat.max));
+        text += line;
+    }
+    return env->NewStringUTF(text.c_str());
+}
+
+jboolean EngineTrace_nativeWriteChromeTrace(JNIEnv* env, jclass cls, jstring path) {
+    const char* chars = path ? env->GetStringUTFChars(path, nullptr) : nullptr;
+    if (!chars) {
+        return JNI_FALSE;
+    }
+    bool written = Trace::writeChromeJson(chars);
+    env->ReleaseStringUTFChars(path, chars);
+    if (!written) {
+        LOGE("Can't write the trace file");
+    }
+    return written ? JNI_TRUE : JNI_FALSE;
+}
+
+#define NATIVE_METHOD(cls, name, signature) { #name, signature, reinterpret_cast<void*>(cls##_##name) }
+
+const JNINativeMethod boardMethods[] = {
+    NATIVE_METHOD(Board, nativeCreate, "()J"),
+    NATIVE_METHOD(Board, nativeDestroy, "(J)V"),
+    NATIVE_METHOD(Board, getBoardSizeNative, "()I"),
+    NATIVE_METHOD(Board, addToBoard, "(II)V"),
+    NATIVE_METHOD(Board, getBoard, "()[I"),
+};
+
+const JNINativeMethod cardMethods[] = {
+    NATIVE_METHOD(NativeCard, nativeCardTable, "()[I"),
+};
+
+const JNINativeMethod deckMethods[] = {
+    NATIVE_METHOD(Deck, nativeCreate, "()J"),
+    NATIVE_METHOD(Deck, nativeDestroy, "(J)V"),
+    NATIVE_METHOD(Deck, shuffle, "()V"),
+    NATIVE_METHOD(Deck, dealCard, "()[I"),
+};
+
+const JNINativeMethod handMethods[] = {
+    NATIVE_METHOD(Hand, nativeCreate, "()J"),
+    NATIVE_METHOD(Hand, nativeDestroy, "(J)V"),
+    NATIVE_METHOD(Hand, addCard, "(II)V"),
+};
+
+const JNINativeMethod gameMethods[] = {
+    NATIVE_METHOD(NativeGame, nativeCreate, "()J"),
+    NATIVE_METHOD(NativeGame, nativeDestroy, "(J)V"),
+    NATIVE_METHOD(NativeGame, nativeDealRound, "()V"),
+    NATIVE_METHOD(NativeGame, nativeChooseStartCard, "(Z)Z"),
+    NATIVE_METHOD(NativeGame, nativeBotTakesStartCard, "()Z"),
+    NATIVE_METHOD(NativeGame, nativePlayMove, "(IJ)Z"),
+    NATIVE_METHOD(NativeGame, nativeGetGameState, "(Ljava/nio/ByteBuffer;)I"),
+    NATIVE_METHOD(NativeGame, nativeRecordTo, "(Ljava/lang/String;)Z"),
+    NATIVE_METHOD(NativeGame, nativeStartThinking, "(IILcom/dinari/shkuba/BotMoveListener;)Z"),
+    NATIVE_METHOD(NativeGame, nativePollBotMove, "()J"),
+    NATIVE_METHOD(NativeGame, nativeBestBotMoveNow, "()J"),
+    NATIVE_METHOD(NativeGame, nativeCancelThinking, "()V"),
+    NATIVE_METHOD(NativeGame, nativeGetStateDelta, "(Ljava/nio/ByteBuffer;I)I"),
+    NATIVE_METHOD(NativeGame, nativeResetStateDelta, "(I)V"),
+};
+
+const JNINativeMethod stateSyncMethods[] = {
+    NATIVE_METHOD(StateSync, nativeApplyDelta, "(Ljava/nio/ByteBuffer;Ljava/nio/ByteBuffer;I)Z"),
+    NATIVE_METHOD(StateSync, nativeResetState, "(Ljava/nio/ByteBuffer;)V"),
+};
+
+const JNINativeMethod traceMethods[] = {
+    NATIVE_METHOD(EngineTrace, nativeIsCompiledIn, "()Z"),
+    NATIVE_METHOD(EngineTrace, nativeSetEnabled, "(Z)V"),
+    NATIVE_METHOD(EngineTrace, nativeClear, "()V"),
+    NATIVE_METHOD(EngineTrace, nativeSummary, "()Ljava/lang/String;"),
+    NATIVE_METHOD(EngineTrace, nativeWriteChromeTrace, "(Ljava/lang/String;)Z"),
+};
+
+// handleField is null for classes without a native object
+template <size_t N>
+bool registerClass(JNIEnv* env, const char* className, const JNINativeMethod (&methods)[N], jfieldID* handleField) {
+    jclass cls = env->FindClass(className);
+    if (!cls) {
+        env->ExceptionClear();
+        LOGE("Class not found: %s", className);
+        return false;
+    }
+    if (handleField) {
+        *handleField = env->GetFieldID(cls, "nativeHandle", "J");
+    }
+    bool ok = (!handleField || *handleField) && env->RegisterNatives(cls, methods, static_cast<jint>(N)) == JNI_OK;
+    if (!ok) {
+        env->ExceptionClear();
+        LOGE("Error registering natives of %s", className);
+    }
+    env->DeleteLocalRef(cls);
+    return ok;
+}
+
+} // namespace
+
+extern "C" JNIEXPORT jint JNICALL JNI_OnLoad(JavaVM* vm, void* reserved) {
+    JNIEnv* env = nullptr;
+    if (vm->GetEnv(reinterpret_cast<void**>(&env), JNI_VERSION_1_6) != JNI_OK) {
+        return JNI_ERR;
+    }
+    javaVm = vm;
+    jclass listenerClass = env->FindClass("com/dinari/shkuba/BotMoveListener");
+    if (listenerClass) {
+        onBotMoveMethod = env->GetMethodID(listenerClass, "onBotMove", "(IJ)V");
+        env->DeleteLocalRef(listenerClass);
+    }
+    if (!onBotMoveMethod) {
+        env->ExceptionClear();
+        LOGE("BotMoveListener.onBotMove not found, bot moves can only be polled");
+    }
+    bool ok = registerClass(env, "com/dinari/shkuba/Board", boardMethods, &handles.board);
+    ok = registerClass(env, "com/dinari/shkuba/NativeCard", cardMethods, nullptr) && ok;
+    ok = registerClass(env, "com/dinari/shkuba/Deck", deckMethods, &handles.deck) && ok;
+    ok = registerClass(env, "com/dinari/shkuba/Hand", handMethods, &handles.hand) && ok;
+    ok = registerClass(env, "com/dinari/shkuba/NativeGame", gameMethods, &handles.game) && ok;
+    ok = registerClass(env, "com/dinari/shkuba/StateSync", stateSyncMethods, nullptr) && ok;
+    ok = registerClass(env, "com/dinari/shkuba/EngineTrace", traceMethods, nullptr) && ok;
+    if (!ok) {
+        LOGE("Some native methods are not registered");
+    }
+    return JNI_VERSION_1_6;
+}
@@ -0,0 +1,127 @@
+// BatchEval's lanes give what the one state functions give, and those what the round rules give. built for
+// plain C++ (SHKUBA_NO_SIMD), the host's SIMD and NEON (on the host through tests/neonEmulation)
+#include <cstdio>
+#include <vector>
+#include "batchEval.h"
+#include "captureTable.h"
+#include "check.h"
+#include "testRounds.h"
+
+namespace
+{
+	const int ROUNDS = 100;
+	const int RANDOM_PILES = 2001;	//not a multiple of any step, so the tails run too
+
+	// piles of finished random rounds, then random card sets
+	void checkScoreDiffs()
+	{
+		CounterRng rng(43);
+		std::vector<CardMask> piles;
+		std::vector<int32_t> sweepDiffs;
+		for (int number = 0; number < ROUNDS; ++number)
+		{
+			Round round(number % 2 == 0 ? P1 : P2, 47, number);
+			round.firstMiniRound(rng.below(2) == 1);
+			while (!round.isRoundOver())
+			{
+				dealIfNeeded(round);
+				round.makeMove(randomMove(round, rng));
+			}
+			piles.push_back(round.getP1Pile());
+			sweepDiffs.push_back(static_cast<int32_t>(rng.below(11)) - 5);
+		}
+		for (int i = 0; i < RANDOM_PILES; ++i)
+		{
+			piles.push_back(rng() & FULL_DECK_MASK);
+			sweepDiffs.push_back(static_cast<int32_t>(rng.below(11)) - 5);
+		}
+
+		int count = static_cast<int>(piles.size());
+		std::vector<int32_t> out(piles.size());
+		BatchEval::scoreDiffs(piles.data(), sweepDiffs.data(), count, out.data());
+		int different = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			int32_t sweeps = sweepDiffs[i];
+			RoundScore score = Round::scoreCategories(piles[i], sweeps > 0 ? sweeps : 0, sweeps < 0 ? -sweeps : 0);
+			int32_t expected = score.total(P1) - score.total(P2);
+			CHECK(BatchEval::scoreDiff(piles[i], sweeps) == expected);
+			if (out[i] != expected)
+			{
+				++different;
+			}
+		}
+		CHECK(different == 0);
+	}
+
+	// hands against boards from random rounds, then random boards of up to 8 cards
+	void checkHasCapture()
+	{
+		CounterRng rng(53);
+		std::vector<CardMask> hands;
+		std::vector<Board> boards;
+		for (int number = 0; number < ROUNDS; ++number)
+		{
+			Round round(number % 2 == 0 ? P1 : P2, 59, number);
+			round.firstMiniRound(rng.below(2) == 1);
+			while (!round.isRoundOver())
+			{
+				dealIfNeeded(round);
+				hands.push_back(round.getHand(round.getTurn()).getMask());
+				boards.push_back(round.getBoard());
+				round.makeMove(randomMove(round, rng));
+			}
+		}
+		for (int i = 0; i < RANDOM_PILES; ++i)
+		{
+			CardMask board = 0;
+			int size = static_cast<int>(rng.below(9));
+			while (countCards(board) < size)
+			{
+				board |= CardMask(1) << rng.below(NUM_OF_CARDS);
+			}
+			CardMask hand = 0;
+			for (int card = 0; card < 4; ++card)
+			{
+				hand |= (CardMask(1) << rng.below(NUM_OF_CARDS)) & ~board;
+			}
+			hands.push_back(hand);
+			boards.push_back(Board(board));
+		}
+
+		int count = static_cast<int>(hands.size());
+		std::vector<uint16_t> sums;
+		for (const Board& board : boards)
+		{
+			sums.push_back(board.getReachableSums());
+		}
+		std::vector<uint8_t> out(hands.size());
+		BatchEval::hasCapture(hands.data(), sums.data(), count, out.data());
+		int different = 0;
+		for (int i = 0; i < count; ++i)
+		{
+			uint8_t expected = 0;
+			for (int rank = 1; rank <= NUM_OF_RANKS; ++rank)
+			{
+				if ((hands[i] & rankMask(rank)) != 0 && CaptureTable::canCapture(boards[i], rank))
+				{
+					expected = 1;
+				}
+			}
+			CHECK(BatchEval::hasCapture(hands[i], sums[i]) == expected);
+			if (out[i] != expected)
+			{
+				++different;
+			}
+		}
+		CHECK(different == 0);
+	}
+}
+
+int main()
+{
+	std::printf("%s\n", BatchEval::getInstructionSet());
+	checkScoreDiffs();
+	checkHasCapture();
+	return checkResult();
+}
@@ -0,0 +1,35 @@
+#pragma once
+#include <cstdio>
+
+// the host tests are plain executables run by ctest: CHECK reports a failed condition and carries on,
+// main returns checkResult() so any failure fails the test
+namespace check
+{
+	inline int& failures()
+	{
+		static int count = 0;
+		return count;
+	}
+
+	inline bool report(bool passed, const char* condition, const char* file, int line)
+	{
+		if (!passed)
+		{
+			std::printf("%s:%d: CHECK(%s) failed\n", file, line, condition);
+			++failures();
+		}
+		return passed;
+	}
+}
+
+#define CHECK(condition) check::report(static_cast<bool>(condition), #condition, __FILE__, __LINE__)
+
+inline int checkResult()
+{
+	if (check::failures() > 0)
+	{
+		std::printf("%d checks failed\n", check::failures());
+		return 1;
+	}
+	return 0;
+}
@@ -0,0 +1,166 @@
+// game records: rounds written by RecordWriter read back through RecordReader and replay to the same piles,
+// and a corrupt last round is refused without reading past the file or the deck
+#include <cstdio>
+#include <vector>
+#include "check.h"
+#include "recordReader.h"
+#include "recordWriter.h"
+#include "testRounds.h"
+
+namespace
+{
+	const char* const RECORD_PATH = "gameRecordTest.shkr";
+	const int ROUNDS = 1000;
+
+	struct Played
+	{
+		int numOfMoves;
+		CardMask p1Pile;
+		int p1Sweeps;
+		int p2Sweeps;
+	};
+
+	// plays a random round into the record, the even ones as seeded deals and the odd ones as explicit deals
+	Played playRound(int number, RoundRecord& record)
+	{
+		CounterRng rng(23, number);
+		players firstPlayer = number % 4 < 2 ? P1 : P2;
+		bool takeStartCard = rng.below(2) == 1;
+		Round round = number % 2 == 0 ? Round(firstPlayer, 29, number) : Round(firstPlayer);
+		if (number % 2 == 0)
+		{
+			record.beginSeeded(firstPlayer, takeStartCard, 29, number);
+		}
+		else
+		{
+			record.beginDealt(round, takeStartCard);
+		}
+		round.firstMiniRound(takeStartCard);
+		while (!round.isRoundOver())
+		{
+			dealIfNeeded(round);
+			Move move = randomMove(round, rng);
+			record.addMove(move, round.getBoard().getMask());
+			round.makeMove(move);
+		}
+		round.collectBoard();
+		Played played = { record.getNumOfMoves(), round.getP1Pile(), round.getSweeps(P1), round.getSweeps(P2) };
+		return played;
+	}
+
+	bool replays(const RecordedRound& recorded, const Played& played)
+	{
+		Round round = recorded.createRound();
+		round.firstMiniRound(recorded.startCardTaken());
+		const uint8_t* in = recorded.moves;
+		for (int i = 0; i < recorded.numOfMoves; ++i)
+		{
+			dealIfNeeded(round);
+			Move move;
+			if (!RoundRecord::decodeMove(in, recorded.moves + recorded.moveBytes, round.getBoard().getMask(), move) ||
+				!MoveGen::isLegal(round.getHand(round.getTurn()), round.getBoard(), move))
+			{
+				return false;
+			}
+			round.makeMove(move);
+		}
+		if (!round.isRoundOver() || in != recorded.moves + recorded.moveBytes)
+		{
+			return false;
+		}
+		round.collectBoard();
+		return round.getP1Pile() == played.p1Pile && round.getSweeps(P1) == played.p1Sweeps && round.getSweeps(P2) == played.p2Sweeps;
+	}
+}
+
+int main()
+{
+	std::vector<Played> played;
+	RecordWriter writer;
+	CHECK(writer.open(RECORD_PATH));
+	for (int number = 0; number < ROUNDS; ++number)
+	{
+		RoundRecord record;
+		played.push_back(playRound(number, record));
+		writer.write(record);
+	}
+	writer.close();
+
+	RecordReader reader;
+	CHECK(reader.open(RECORD_PATH));
+	RecordedRound recorded;
+	std::size_t rounds = 0;
+	while (reader.next(recorded))
+	{
+		CHECK(rounds < played.size() && recorded.numOfMoves == played[rounds].numOfMoves && replays(recorded, played[rounds]));
+		++rounds;
+	}
+	CHECK(rounds == played.size());
+	std::vector<uint8_t> written(reader.getSize());
+	reader.close();
+
+	// the file with a corrupt last round: one that claims 255 moves in 0 bytes, one whose only move needs more
+	// bytes than it has
+	std::FILE* file = std::fopen(RECORD_PATH, "rb");
+	CHECK(file && std::fread(written.data(), 1, written.size(), file) == written.size());
+	if (file)
+	{
+		std::fclose(file);
+	}
+	const uint8_t noMoves[RECORD_ROUND_HEADER_SIZE + 16] = { 0, 255, 0, 0 };
+	const uint8_t cutMove[RECORD_ROUND_HEADER_SIZE + 16 + 1] = { 0, 1, 1, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 3 << 6 };
+	for (const std::vector<uint8_t>& corrupt : { std::vector<uint8_t>(noMoves, noMoves + sizeof(noMoves)),
+		std::vector<uint8_t>(cutMove, cutMove + sizeof(cutMove)) })
+	{
+		file = std::fopen(RECORD_PATH, "wb");
+		CHECK(file && std::fwrite(written.data(), 1, written.size(), file) == written.size() &&
+			std::fwrite(corrupt.data(), 1, corrupt.size(), file) == corrupt.size());
+		if (file)
+		{
+			std::fclose(file);
+		}
+		CHECK(reader.open(RECORD_PATH));
+		for (std::size_t i = 0; i < played.size(); ++i)
+		{
+			CHECK(reader.next(recorded));
+		}
+		CHECK(reader.next(recorded) && recorded.numOfMoves == corrupt[1] && !replays(recorded, played[0]));
+		CHECK(!reader.next(recorded));
+		reader.close();
+
+		// and straight on the bytes: nothing is decoded past the end
+		const uint8_t* moves = corrupt.data() + RECORD_ROUND_HEADER_SIZE + 16;
+		const uint8_t* in = moves;
+		Move move;
+		CHECK(!RoundRecord::decodeMove(in, corrupt.data() + corrupt.size(), EMPTY_MASK, move) && in == moves);
+	}
+
+	// a last round dealt from card indices that aren't every card once: one past the deck, one card twice.
+	// the reader refuses it rather than hand it to Round
+	for (int bad = 0; bad < 2; ++bad)
+	{
+		std::vector<uint8_t> corrupt(RECORD_ROUND_HEADER_SIZE + NUM_OF_CARDS);
+		corrupt[0] = RECORD_EXPLICIT_DEAL;
+		for (int card = 0; card < NUM_OF_CARDS; ++card)
+		{
+			corrupt[RECORD_ROUND_HEADER_SIZE + card] = static_cast<uint8_t>(card);
+		}
+		corrupt[RECORD_ROUND_HEADER_SIZE + 7] = bad == 0 ? NUM_OF_CARDS : 3;
+		file = std::fopen(RECORD_PATH, "wb");
+		CHECK(file && std::fwrite(written.data(), 1, written.size(), file) == written.size() &&
+			std::fwrite(corrupt.data(), 1, corrupt.size(), file) == corrupt.size());
+		if (file)
+		{
+			std::fclose(file);
+		}
+		CHECK(reader.open(RECORD_PATH));
+		for (std::size_t i = 0; i < played.size(); ++i)
+		{
+			CHECK(reader.next(recorded));
+		}
+		CHECK(!reader.next(recorded));
+		reader.close();
+	}
+	std::remove(RECORD_PATH);
+	return checkResult();
+}
@@ -0,0 +1,113 @@
+// LearnedEval inference gives the same bits whichever instructions it was compiled for. built three times:
+// plain C++ (SHKUBA_NO_SIMD) writes the values, the host's own SIMD build and the NEON code (on the host through
+// tests/neonEmulation) compare against them. usage: shkuba_learnedEvalTest write|compare FILE
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "check.h"
+#include "learnedEval.h"
+#include "testRounds.h"
+
+namespace
+{
+	const int ROUNDS = 200;
+
+	// uniform in [-limit, limit]
+	float randomWeight(CounterRng& rng, float limit)
+	{
+		return (static_cast<float>(rng.below(2001)) - 1000) / 1000 * limit;
+	}
+
+	// weights large enough that the first layer is clamped at LEARNED_MAX_FIRST_LAYER now and then and the
+	// hidden units clip at both ends
+	LearnedEval randomModel()
+	{
+		CounterRng rng(31);
+		std::vector<float> w1(LEARNED_INPUTS * LEARNED_HIDDEN);
+		float b1[LEARNED_HIDDEN];
+		float w2[LEARNED_HIDDEN];
+		for (float& weight : w1)
+		{
+			weight = randomWeight(rng, 12);
+		}
+		for (int j = 0; j < LEARNED_HIDDEN; ++j)
+		{
+			b1[j] = randomWeight(rng, 4);
+			w2[j] = randomWeight(rng, 1);
+		}
+		LearnedEval model;
+		model.setWeights(w1.data(), b1, w2, randomWeight(rng, 5));
+		return model;
+	}
+
+	// the value of every position of random rounds, from both sides
+	std::vector<uint32_t> evaluateRounds(const LearnedEval& model)
+	{
+		std::vector<uint32_t> values;
+		for (int number = 0; number < ROUNDS; ++number)
+		{
+			CounterRng rng(37, number);
+			Round round(number % 2 == 0 ? P1 : P2, 41, number);
+			round.firstMiniRound(rng.below(2) == 1);
+			while (!round.isRoundOver())
+			{
+				dealIfNeeded(round);
+				for (int viewer = P1; viewer <= P2; ++viewer)
+				{
+					float value = model.evaluate(round, static_cast<players>(viewer));
+					uint32_t bits;
+					std::memcpy(&bits, &value, sizeof(bits));
+					values.push_back(bits);
+				}
+				round.makeMove(randomMove(round, rng));
+			}
+		}
+		return values;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	if (argc != 3 || (std::strcmp(argv[1], "write") != 0 && std::strcmp(argv[1], "compare") != 0))
+	{
+		std::printf("usage: %s write|compare FILE\n", argv[0]);
+		return 2;
+	}
+	std::vector<uint32_t> values = evaluateRounds(randomModel());
+	std::printf("%s: %zu values\n", LearnedEval::getInstructionSet(), values.size());
+	if (std::strcmp(argv[1], "write") == 0)
+	{
+		std::FILE* file = std::fopen(argv[2], "w");
+		CHECK(file != nullptr);
+		if (file)
+		{
+			for (uint32_t bits : values)
+			{
+				std::fprintf(file, "%08x\n", bits);
+			}
+			CHECK(std::fclose(file) == 0);
+		}
+		return checkResult();
+	}
+
+	std::FILE* file = std::fopen(argv[2], "r");
+	CHECK(file != nullptr);
+	if (file)
+	{
+		std::size_t count = 0;
+		std::size_t different = 0;
+		unsigned int bits;
+		while (std::fscanf(file, "%x", &bits) == 1)
+		{
+			if (count >= values.size() || values[count] != bits)
+			{
+				++different;
+			}
+			++count;
+		}
+		std::fclose(file);
+		CHECK(count == values.size());
+		CHECK(different == 0);
+	}
+	return checkResult();
+}
@@ -0,0 +1,378 @@
+#pragma once
+#include <cstdint>
+#include <cstring>
+
+// the NEON intrinsics the engine uses, in plain C++ with the ARM semantics (wrapping 16 bit adds, widening
+// multiply-accumulate), so the NEON code compiles and runs on the host (SHKUBA_NEON_EMULATION, logic/simd.h).
+// the 32 bit sums are plain int arithmetic: the engine's stay far from overflowing, and gcc 12 -O3 vectorizes
+// the wrapping unsigned form wrongly. each vector is its own type, as in the real header, so mixing up widths
+// or halves fails to compile
+struct int16x4_t
+{
+	int16_t lanes[4];
+};
+
+struct int16x8_t
+{
+	int16_t lanes[8];
+};
+
+struct int32x2_t
+{
+	int32_t lanes[2];
+};
+
+struct int32x4_t
+{
+	int32_t lanes[4];
+};
+
+struct uint8x16_t
+{
+	uint8_t lanes[16];
+};
+
+struct uint16x8_t
+{
+	uint16_t lanes[8];
+};
+
+struct uint32x2_t
+{
+	uint32_t lanes[2];
+};
+
+struct uint32x4_t
+{
+	uint32_t lanes[4];
+};
+
+struct uint64x1_t
+{
+	uint64_t lanes[1];
+};
+
+struct uint64x2_t
+{
+	uint64_t lanes[2];
+};
+
+inline int16x8_t vld1q_s16(const int16_t* in)
+{
+	int16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = in[i];
+	}
+	return v;
+}
+
+inline int16x8_t vdupq_n_s16(int16_t value)
+{
+	int16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = value;
+	}
+	return v;
+}
+
+inline int32x4_t vdupq_n_s32(int32_t value)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = value;
+	}
+	return v;
+}
+
+inline int16x8_t vaddq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = static_cast<int16_t>(static_cast<uint16_t>(a.lanes[i]) + static_cast<uint16_t>(b.lanes[i]));
+	}
+	return v;
+}
+
+inline int16x8_t vmaxq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = a.lanes[i] > b.lanes[i] ? a.lanes[i] : b.lanes[i];
+	}
+	return v;
+}
+
+inline int16x8_t vminq_s16(int16x8_t a, int16x8_t b)
+{
+	int16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = a.lanes[i] < b.lanes[i] ? a.lanes[i] : b.lanes[i];
+	}
+	return v;
+}
+
+inline int16x4_t vget_low_s16(int16x8_t a)
+{
+	int16x4_t v = { { a.lanes[0], a.lanes[1], a.lanes[2], a.lanes[3] } };
+	return v;
+}
+
+inline int16x4_t vget_high_s16(int16x8_t a)
+{
+	int16x4_t v = { { a.lanes[4], a.lanes[5], a.lanes[6], a.lanes[7] } };
+	return v;
+}
+
+inline int32x2_t vget_low_s32(int32x4_t a)
+{
+	int32x2_t v = { { a.lanes[0], a.lanes[1] } };
+	return v;
+}
+
+inline int32x2_t vget_high_s32(int32x4_t a)
+{
+	int32x2_t v = { { a.lanes[2], a.lanes[3] } };
+	return v;
+}
+
+// a + b * c, the products widened to 32 bits
+inline int32x4_t vmlal_s16(int32x4_t a, int16x4_t b, int16x4_t c)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] + b.lanes[i] * c.lanes[i];
+	}
+	return v;
+}
+
+inline int32x2_t vadd_s32(int32x2_t a, int32x2_t b)
+{
+	int32x2_t v;
+	for (int i = 0; i < 2; ++i)
+	{
+		v.lanes[i] = a.lanes[i] + b.lanes[i];
+	}
+	return v;
+}
+
+// the sums of neighbouring lanes: { a0 + a1, b0 + b1 }
+inline int32x2_t vpadd_s32(int32x2_t a, int32x2_t b)
+{
+	int32x2_t v;
+	v.lanes[0] = a.lanes[0] + a.lanes[1];
+	v.lanes[1] = b.lanes[0] + b.lanes[1];
+	return v;
+}
+
+inline int32x4_t vld1q_s32(const int32_t* in)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = in[i];
+	}
+	return v;
+}
+
+inline void vst1q_s32(int32_t* out, int32x4_t a)
+{
+	for (int i = 0; i < 4; ++i)
+	{
+		out[i] = a.lanes[i];
+	}
+}
+
+inline int32x4_t vaddq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] + b.lanes[i];
+	}
+	return v;
+}
+
+inline int32x4_t vsubq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] - b.lanes[i];
+	}
+	return v;
+}
+
+inline int32x4_t vandq_s32(int32x4_t a, int32x4_t b)
+{
+	int32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] & b.lanes[i];
+	}
+	return v;
+}
+
+// comparisons give all ones in the lanes where they hold
+inline uint32x4_t vcgtq_s32(int32x4_t a, int32x4_t b)
+{
+	uint32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] > b.lanes[i] ? 0xFFFFFFFFu : 0;
+	}
+	return v;
+}
+
+inline uint32x4_t vceqq_s32(int32x4_t a, int32x4_t b)
+{
+	uint32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = a.lanes[i] == b.lanes[i] ? 0xFFFFFFFFu : 0;
+	}
+	return v;
+}
+
+inline int32x4_t vreinterpretq_s32_u32(uint32x4_t a)
+{
+	int32x4_t v;
+	std::memcpy(v.lanes, a.lanes, sizeof(v.lanes));
+	return v;
+}
+
+inline uint64x2_t vld1q_u64(const uint64_t* in)
+{
+	uint64x2_t v = { { in[0], in[1] } };
+	return v;
+}
+
+inline uint64x2_t vdupq_n_u64(uint64_t value)
+{
+	uint64x2_t v = { { value, value } };
+	return v;
+}
+
+inline uint64x1_t vcreate_u64(uint64_t value)
+{
+	uint64x1_t v = { { value } };
+	return v;
+}
+
+inline uint64x2_t vcombine_u64(uint64x1_t low, uint64x1_t high)
+{
+	uint64x2_t v = { { low.lanes[0], high.lanes[0] } };
+	return v;
+}
+
+inline uint64x2_t vandq_u64(uint64x2_t a, uint64x2_t b)
+{
+	uint64x2_t v = { { a.lanes[0] & b.lanes[0], a.lanes[1] & b.lanes[1] } };
+	return v;
+}
+
+inline uint64x2_t vorrq_u64(uint64x2_t a, uint64x2_t b)
+{
+	uint64x2_t v = { { a.lanes[0] | b.lanes[0], a.lanes[1] | b.lanes[1] } };
+	return v;
+}
+
+inline uint64x2_t vshrq_n_u64(uint64x2_t a, int shift)
+{
+	uint64x2_t v = { { a.lanes[0] >> shift, a.lanes[1] >> shift } };
+	return v;
+}
+
+inline uint64x2_t vshlq_n_u64(uint64x2_t a, int shift)
+{
+	uint64x2_t v = { { a.lanes[0] << shift, a.lanes[1] << shift } };
+	return v;
+}
+
+// the low 32 bits of each lane
+inline uint32x2_t vmovn_u64(uint64x2_t a)
+{
+	uint32x2_t v = { { static_cast<uint32_t>(a.lanes[0]), static_cast<uint32_t>(a.lanes[1]) } };
+	return v;
+}
+
+// each lane shifted right, then its low 32 bits
+inline uint32x2_t vshrn_n_u64(uint64x2_t a, int shift)
+{
+	return vmovn_u64(vshrq_n_u64(a, shift));
+}
+
+inline uint32x2_t vorr_u32(uint32x2_t a, uint32x2_t b)
+{
+	uint32x2_t v = { { a.lanes[0] | b.lanes[0], a.lanes[1] | b.lanes[1] } };
+	return v;
+}
+
+inline uint32x4_t vcombine_u32(uint32x2_t low, uint32x2_t high)
+{
+	uint32x4_t v = { { low.lanes[0], low.lanes[1], high.lanes[0], high.lanes[1] } };
+	return v;
+}
+
+// the bytes of the lanes, lowest first (little endian, as on the ARM targets)
+inline uint8x16_t vreinterpretq_u8_u64(uint64x2_t a)
+{
+	uint8x16_t v;
+	for (int i = 0; i < 16; ++i)
+	{
+		v.lanes[i] = static_cast<uint8_t>(a.lanes[i / 8] >> (8 * (i % 8)));
+	}
+	return v;
+}
+
+// the set bits of each byte
+inline uint8x16_t vcntq_u8(uint8x16_t a)
+{
+	uint8x16_t v;
+	for (int i = 0; i < 16; ++i)
+	{
+		int bits = 0;
+		for (int bit = 0; bit < 8; ++bit)
+		{
+			bits += (a.lanes[i] >> bit) & 1;
+		}
+		v.lanes[i] = static_cast<uint8_t>(bits);
+	}
+	return v;
+}
+
+// the sums of neighbouring lanes, widened
+inline uint16x8_t vpaddlq_u8(uint8x16_t a)
+{
+	uint16x8_t v;
+	for (int i = 0; i < 8; ++i)
+	{
+		v.lanes[i] = static_cast<uint16_t>(a.lanes[2 * i] + a.lanes[2 * i + 1]);
+	}
+	return v;
+}
+
+inline uint32x4_t vpaddlq_u16(uint16x8_t a)
+{
+	uint32x4_t v;
+	for (int i = 0; i < 4; ++i)
+	{
+		v.lanes[i] = static_cast<uint32_t>(a.lanes[2 * i] + a.lanes[2 * i + 1]);
+	}
+	return v;
+}
+
+inline uint64x2_t vpaddlq_u32(uint32x4_t a)
+{
+	uint64x2_t v = { { static_cast<uint64_t>(a.lanes[0]) + a.lanes[1], static_cast<uint64_t>(a.lanes[2]) + a.lanes[3] } };
+	return v;
+}
+
+#define vget_lane_s32(v, lane) ((v).lanes[lane])
+#define vget_lane_u32(v, lane) ((v).lanes[lane])
@@ -0,0 +1,140 @@
+// Round::makeMove / unmakeMove: taking a move back restores everything the move changed.
+// the end of round scoring rules, category by category
+#include <cstring>
+#include "check.h"
+#include "testRounds.h"
+
+namespace
+{
+	const int ROUNDS = 2000;
+
+	bool samePileCounts(const PileCounts& a, const PileCounts& b)
+	{
+		return a.cards == b.cards && a.diamonds == b.diamonds && a.sevens == b.sevens && a.sixes == b.sixes &&
+			a.sevenOfDiamonds == b.sevenOfDiamonds && a.sweeps == b.sweeps;
+	}
+
+	bool sameRound(const Round& a, const Round& b)
+	{
+		bool same = a.getTurn() == b.getTurn() && a.getLastCapturer() == b.getLastCapturer() && a.getDeckSize() == b.getDeckSize() &&
+			a.getBoard().getMask() == b.getBoard().getMask() && a.getBoard().getRankCounts() == b.getBoard().getRankCounts() &&
+			a.getP1Pile() == b.getP1Pile() && a.getP2Pile() == b.getP2Pile();
+		for (int player = P1; player <= P2; ++player)
+		{
+			players who = static_cast<players>(player);
+			same = same && a.getHand(who).getMask() == b.getHand(who).getMask() && a.getSweeps(who) == b.getSweeps(who) &&
+				samePileCounts(a.getPileCounts(who), b.getPileCounts(who)) &&
+				a.getKnowledge(who).getSeen() == b.getKnowledge(who).getSeen() &&
+				a.getKnowledge(who).getKnownInOpponentHand() == b.getKnowledge(who).getKnownInOpponentHand();
+		}
+		return same;
+	}
+
+	// every legal move of every position of the round is made and taken back
+	void makeAndUnmake(uint64_t stream)
+	{
+		CounterRng rng(3, stream);
+		Round round(stream % 2 == 0 ? P1 : P2, 11, stream);
+		round.firstMiniRound(rng.below(2) == 1);
+		while (!round.isRoundOver())
+		{
+			dealIfNeeded(round);
+			Move moves[MAX_MOVES];
+			int count = MoveGen::generate(round, moves, MAX_MOVES);
+			CHECK(count > 0);
+			for (int i = 0; i < count; ++i)
+			{
+				Round before = round;
+				MoveUndo undo = round.makeMove(moves[i]);
+				CHECK(round.getTurn() != before.getTurn());
+				round.unmakeMove(moves[i], undo);
+				CHECK(sameRound(round, before));
+			}
+			round.makeMove(moves[rng.below(static_cast<uint32_t>(count))]);
+		}
+	}
+
+	// the running counts follow the piles, so the O(1) score is the one counted from the piles
+	void countsFollowPiles(uint64_t stream)
+	{
+		CounterRng rng(5, stream);
+		Round round(P1, 13, stream);
+		round.firstMiniRound(rng.below(2) == 1);
+		while (!round.isRoundOver())
+		{
+			dealIfNeeded(round);
+			round.makeMove(randomMove(round, rng));
+		}
+		round.collectBoard();
+		CHECK((round.getP1Pile() | round.getP2Pile()) == FULL_DECK_MASK);
+		CHECK((round.getP1Pile() & round.getP2Pile()) == EMPTY_MASK);
+		RoundScore counted = Round::scoreCategories(round.getP1Pile(), round.getSweeps(P1), round.getSweeps(P2));
+		RoundScore running = round.scoreCategories();
+		CHECK(std::memcmp(&counted, &running, sizeof(counted)) == 0);
+		RoundScore live = round.getLiveScore();
+		CHECK(std::memcmp(&live, &running, sizeof(live)) == 0);
+	}
+
+	CardMask card(int suit, int rank)
+	{
+		return cardBit(cardIndexOf(suit, rank));
+	}
+
+	bool scores(CardMask p1Pile, int p1Sweeps, int p2Sweeps, const int (&p1)[NUM_OF_SCORE_CATEGORIES], const int (&p2)[NUM_OF_SCORE_CATEGORIES])
+	{
+		RoundScore score = Round::scoreCategories(p1Pile, p1Sweeps, p2Sweeps);
+		return std::memcmp(score.points[P1], p1, sizeof(p1)) == 0 && std::memcmp(score.points[P2], p2, sizeof(p2)) == 0;
+	}
+
+	// a point per category to the player with more than half of it, nobody on a tie; the sevens tie of 2 - 2 goes
+	// to the player with more sixes; the 7 of diamonds to whoever holds it; a point per sweep
+	void scoringRules()
+	{
+		const CardMask sevenOfDiamonds = card(Card::D, 7);
+		const CardMask diamonds = suitMask(Card::D);
+		//                                        cards, diamonds, sevens, 7 of diamonds, sweeps
+		CHECK(scores(sevenOfDiamonds, 0, 0, { 0, 0, 0, 1, 0 }, { 1, 1, 1, 0, 0 }));
+		CHECK(scores(diamonds & ~sevenOfDiamonds, 0, 0, { 0, 1, 0, 0, 0 }, { 1, 0, 1, 1, 0 }));	//the other diamonds give the other player nothing
+		CHECK(scores(FULL_DECK_MASK & ~sevenOfDiamonds, 2, 1, { 1, 1, 1, 0, 2 }, { 0, 0, 0, 1, 1 }));
+		CHECK(scores(diamonds & (rankMask(1) | rankMask(2) | rankMask(3) | rankMask(4) | rankMask(5)), 0, 0, { 0, 0, 0, 0, 0 }, { 1, 0, 1, 1, 0 }));
+
+		const CardMask twoSevens = card(Card::S, 7) | card(Card::H, 7);
+		CHECK(scores(twoSevens | card(Card::S, 6) | card(Card::H, 6) | card(Card::C, 6), 0, 0, { 0, 0, 1, 0, 0 }, { 1, 1, 0, 1, 0 }));
+		CHECK(scores(twoSevens | card(Card::S, 6) | card(Card::H, 6), 0, 0, { 0, 0, 0, 0, 0 }, { 1, 1, 0, 1, 0 }));
+		CHECK(scores(twoSevens | card(Card::S, 6), 0, 0, { 0, 0, 0, 0, 0 }, { 1, 1, 1, 1, 0 }));
+
+		CardMask twentyCards = rankMask(1) | rankMask(2) | rankMask(3) | rankMask(4) | rankMask(5);
+		CHECK(scores(twentyCards, 0, 0, { 0, 0, 0, 0, 0 }, { 0, 0, 1, 1, 0 }));
+		CHECK(scores(twentyCards | card(Card::S, 10), 0, 0, { 1, 0, 0, 0, 0 }, { 0, 0, 1, 1, 0 }));
+
+		// countPiles counts each player's own pile: 25 cards against 15 is P1's point
+		Round round(P1);
+		for (CardMask rest = FULL_DECK_MASK; rest; rest &= rest - 1)
+		{
+			int index = lowestCard(rest);
+			if (index < 25)
+			{
+				round.addToP1Pile(Card::fromIndex(index));
+			}
+			else
+			{
+				round.addToP2Pile(Card::fromIndex(index));
+			}
+		}
+		round.countPiles();
+		RoundScore score = round.scoreCategories();
+		CHECK(score.points[P1][SCORE_CARDS] == 1 && score.points[P2][SCORE_CARDS] == 0);
+		CHECK(round.getP1Points() == score.total(P1) && round.getP2Points() == score.total(P2));
+	}
+}
+
+int main()
+{
+	scoringRules();
+	for (int i = 0; i < ROUNDS; ++i)
+	{
+		makeAndUnmake(i);
+		countsFollowPiles(i);
+	}
+	return checkResult();
+}
@@ -0,0 +1,113 @@
+// StateDelta: a replica that applies every delta in order stays equal to the sender's state (or to what its
+// player may see of it), and a delta that doesn't fit the replica is refused without touching it
+#include <cstring>
+#include "check.h"
+#include "game.h"
+#include "stateDelta.h"
+#include "testRounds.h"
+
+namespace
+{
+	const int MATCHES = 200;
+
+	bool sameSnapshot(const GameSnapshot& a, const GameSnapshot& b)
+	{
+		return std::memcmp(&a, &b, sizeof(a)) == 0;
+	}
+
+	// sends a delta from the sender's last state to now and applies it to the replica
+	void sync(GameSnapshot& sent, GameSnapshot& replica, const GameSnapshot& now, int viewer)
+	{
+		uint8_t delta[MAX_DELTA_BYTES];
+		int size = StateDelta::encode(sent, now, delta);
+		CHECK(size > 0 && size <= MAX_DELTA_BYTES);
+		CHECK(StateDelta::apply(replica, delta, size));
+		CHECK(sameSnapshot(replica, now));
+		CHECK(viewer < 0 || replica.hands[viewer == P1 ? P2 : P1] == EMPTY_MASK);
+		sent = now;
+	}
+
+	// the whole truth, or from one player's view when viewer is P1 / P2
+	GameSnapshot stateFor(const Game& game, const Round& round, int viewer)
+	{
+		GameSnapshot state = GameSnapshot::capture(game, round);
+		return viewer < 0 ? state : state.viewedBy(static_cast<players>(viewer));
+	}
+
+	void roundTrips(uint64_t stream, int viewer)
+	{
+		CounterRng rng(7, stream);
+		Game game(stream % 2 == 0 ? P1 : P2);
+		GameSnapshot sent = StateDelta::base();
+		GameSnapshot replica = StateDelta::base();
+		for (int roundNumber = 0; roundNumber < 3; ++roundNumber)
+		{
+			Round round(game.getFirstPlayer(), 17, stream * 3 + roundNumber);
+			sync(sent, replica, stateFor(game, round, viewer), viewer);
+			round.firstMiniRound(rng.below(2) == 1);
+			sync(sent, replica, stateFor(game, round, viewer), viewer);
+			while (!round.isRoundOver())
+			{
+				dealIfNeeded(round);
+				round.makeMove(randomMove(round, rng));
+				sync(sent, replica, stateFor(game, round, viewer), viewer);
+			}
+			round.collectBoard();
+			round.countPiles();
+			game.addToP1Points(round.getP1Points());
+			game.addToP2Points(round.getP2Points());
+			game.changeFirstPlayer();
+			sync(sent, replica, stateFor(game, round, viewer), viewer);
+		}
+	}
+
+	void badDeltas()
+	{
+		CounterRng rng(9);
+		Game game(P1);
+		Round round(P1, 19, 0);
+		round.firstMiniRound(true);
+		GameSnapshot first = GameSnapshot::capture(game, round);
+		round.makeMove(randomMove(round, rng));
+		GameSnapshot second = GameSnapshot::capture(game, round);
+
+		uint8_t delta[MAX_DELTA_BYTES];
+		int size = StateDelta::encode(first, second, delta);
+
+		// applied to a state it wasn't made from: the checksum doesn't match
+		GameSnapshot replica = StateDelta::base();
+		CHECK(!StateDelta::apply(replica, delta, size));
+		CHECK(sameSnapshot(replica, StateDelta::base()));
+
+		// a flipped bit anywhere, or a cut delta: refused, or (a bit the format doesn't use) the right state
+		for (int i = 0; i < size; ++i)
+		{
+			for (int bit = 0; bit < 8; ++bit)
+			{
+				uint8_t corrupt[MAX_DELTA_BYTES];
+				std::memcpy(corrupt, delta, size);
+				corrupt[i] ^= static_cast<uint8_t>(1 << bit);
+				replica = first;
+				bool applied = StateDelta::apply(replica, corrupt, size);
+				CHECK(sameSnapshot(replica, applied ? second : first));
+			}
+			replica = first;
+			CHECK(!StateDelta::apply(replica, delta, i) && sameSnapshot(replica, first));
+		}
+		replica = first;
+		CHECK(StateDelta::apply(replica, delta, size) && sameSnapshot(replica, second));
+	}
+}
+
+int main()
+{
+	for (int i = 0; i < MATCHES; ++i)
+	{
+		for (int viewer = -1; viewer <= P2; ++viewer)
+		{
+			roundTrips(i, viewer);
+		}
+	}
+	badDeltas();
+	return checkResult();
+}
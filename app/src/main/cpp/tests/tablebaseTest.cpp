@@ -0,0 +1,158 @@
+// EndgameTablebase: a small generated table gives EndgameSolver's value and a best move for every position
+// it covers, and the solver finds the same values with it as without. corrupt slots are refused and a table
+// with no empty slot still answers
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "check.h"
+#include "endgameSolver.h"
+#include "gameBot.h"
+#include "testRounds.h"
+
+namespace
+{
+	const char* const TABLEBASE_PATH = "tablebaseTest.shkt";
+	const int HAND_CARDS = 2;
+	const int CARDS = 3;
+	const int ROUNDS = 1000;
+
+	void compareWithSolver(const EndgameTablebase& tablebase, uint64_t stream, int& covered)
+	{
+		GameBot bot(nullptr);	//greedy play empties the board, random play rarely gets a board small enough
+		EndgameSolver solver;
+		EndgameSolver withTablebase;
+		withTablebase.setTablebase(&tablebase);
+		Round round(stream % 2 == 0 ? P1 : P2, 37, stream);
+		round.firstMiniRound(bot.takeStartCard(round));
+		while (!round.isRoundOver())
+		{
+			dealIfNeeded(round);
+			if (EndgameSolver::canSolve(round))
+			{
+				int value, valueWithTablebase;
+				solver.solve(round, &value);
+				withTablebase.solve(round, &valueWithTablebase);
+				CHECK(value == valueWithTablebase);
+			}
+			if (tablebase.covers(round))
+			{
+				++covered;
+				int searched;
+				solver.solve(round, &searched);
+				CHECK(tablebase.probe(round) == searched);
+				int moveValue;
+				Move move = tablebase.bestMove(round, &moveValue);
+				CHECK(moveValue == searched);
+				Round next = round;
+				next.makeMove(move);
+				if (!next.isRoundOver())	//the move keeps the value: the other side can't do better than -searched
+				{
+					int afterMove;
+					solver.solve(next, &afterMove);
+					CHECK(-afterMove == searched);
+				}
+			}
+			round.makeMove(bot.chooseMove(round));
+		}
+	}
+
+	const std::size_t HEADER_SIZE = 24;
+	const std::size_t SLOT_SIZE = 12;
+
+	bool writeFile(const std::vector<uint8_t>& bytes)
+	{
+		std::FILE* file = std::fopen(TABLEBASE_PATH, "wb");
+		bool ok = file && std::fwrite(bytes.data(), 1, bytes.size(), file) == bytes.size();
+		return file && std::fclose(file) == 0 && ok;
+	}
+
+	// the generated file with its slots changed: a first value past the values, a key no position has, and
+	// every slot a copy of one, so nearly every probe looks for a key that isn't there in a table with no empty slot
+	void checkCorrupt()
+	{
+		std::vector<uint8_t> written;
+		std::FILE* file = std::fopen(TABLEBASE_PATH, "rb");
+		CHECK(file != nullptr);
+		if (!file)
+		{
+			return;
+		}
+		uint8_t byte[4096];
+		for (std::size_t read; (read = std::fread(byte, 1, sizeof(byte), file)) > 0;)
+		{
+			written.insert(written.end(), byte, byte + read);
+		}
+		std::fclose(file);
+		uint32_t slots;
+		std::memcpy(&slots, written.data() + 8, sizeof(slots));	//little endian, as the hosts the tests run on
+		std::vector<std::size_t> used;
+		for (std::size_t slot = 0; slot < slots; ++slot)
+		{
+			uint64_t key;
+			std::memcpy(&key, written.data() + HEADER_SIZE + slot * SLOT_SIZE, sizeof(key));
+			if (key != 0)
+			{
+				used.push_back(HEADER_SIZE + slot * SLOT_SIZE);
+			}
+		}
+		CHECK(!used.empty());
+		if (used.empty())
+		{
+			return;
+		}
+
+		EndgameTablebase tablebase;
+		std::vector<uint8_t> bytes = written;
+		std::memset(bytes.data() + used[0] + 8, 0xFF, 4);
+		CHECK(writeFile(bytes) && !tablebase.open(TABLEBASE_PATH));
+		bytes = written;
+		std::memset(bytes.data() + used[0], 0xFF, 8);
+		CHECK(writeFile(bytes) && !tablebase.open(TABLEBASE_PATH));
+
+		bytes = written;
+		for (std::size_t slot = 0; slot < slots; ++slot)
+		{
+			std::memcpy(bytes.data() + HEADER_SIZE + slot * SLOT_SIZE, written.data() + used[0], SLOT_SIZE);
+		}
+		CHECK(writeFile(bytes) && tablebase.open(TABLEBASE_PATH));
+		int covered = 0;
+		GameBot bot(nullptr);
+		for (int i = 0; i < ROUNDS && tablebase.isOpen(); ++i)
+		{
+			Round round(i % 2 == 0 ? P1 : P2, 37, i);
+			round.firstMiniRound(bot.takeStartCard(round));
+			while (!round.isRoundOver())
+			{
+				dealIfNeeded(round);
+				if (tablebase.covers(round))
+				{
+					tablebase.probe(round);	//only has to come back, the missing keys read as 0
+					++covered;
+				}
+				round.makeMove(bot.chooseMove(round));
+			}
+		}
+		CHECK(covered > ROUNDS / 4);
+	}
+}
+
+int main()
+{
+	CHECK(EndgameTablebase::generate(TABLEBASE_PATH, HAND_CARDS, CARDS));
+	EndgameTablebase tablebase;
+	CHECK(tablebase.open(TABLEBASE_PATH));
+	CHECK(tablebase.getMaxHandCards() == HAND_CARDS && tablebase.getMaxCards() == CARDS);
+	int covered = 0;
+	if (tablebase.isOpen())
+	{
+		for (int i = 0; i < ROUNDS; ++i)
+		{
+			compareWithSolver(tablebase, i, covered);
+		}
+	}
+	CHECK(covered > ROUNDS / 4);
+	tablebase.close();
+	checkCorrupt();
+	std::remove(TABLEBASE_PATH);
+	return checkResult();
+}
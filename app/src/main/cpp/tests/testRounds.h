@@ -0,0 +1,20 @@
+#pragma once
+#include "moveGen.h"
+#include "round.h"
+
+// random legal play for the tests: every legal move alike, so captures, drops and sweeps all come up
+inline Move randomMove(const Round& round, CounterRng& rng)
+{
+	Move moves[MAX_MOVES];
+	int count = MoveGen::generate(round, moves, MAX_MOVES);
+	return moves[rng.below(static_cast<uint32_t>(count))];
+}
+
+// deals the next hands once both are empty, as the game loop does
+inline void dealIfNeeded(Round& round)
+{
+	if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0 && round.getDeckSize() > 0)
+	{
+		round.giveCardsToPlayers();
+	}
+}
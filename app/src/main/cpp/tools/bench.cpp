@@ -0,0 +1,228 @@
+// engine micro benchmarks (Google Benchmark). run with --benchmark_format=json to keep numbers
+// between builds, e.g. shkuba_bench --benchmark_out=bench.json --benchmark_out_format=json
+#include <benchmark/benchmark.h>
+#include <vector>
+#include "batchEval.h"
+#include "deck.h"
+#include "endgameSolver.h"
+#include "gameBot.h"
+#include "round.h"
+#include "simulator.h"
+
+namespace
+{
+	const int NUM_OF_POSITIONS = 64;	//different deals per measurement, so one lucky board doesn't decide the result
+	const uint64_t BENCH_SEED = 2024;
+
+	struct Position
+	{
+		Hand hand;
+		Board board;
+	};
+
+	// a hand of 3 and a board of boardSize cards, all taken from one seeded deck
+	std::vector<Position> makePositions(int boardSize)
+	{
+		std::vector<Position> positions;
+		for (int i = 0; i < NUM_OF_POSITIONS; ++i)
+		{
+			Deck deck(BENCH_SEED, i);
+			Position position;
+			for (int j = 0; j < NUM_OF_HAND; ++j)
+			{
+				position.hand.addToHand(deck.draw());
+			}
+			for (int j = 0; j < boardSize; ++j)
+			{
+				position.board.addToBoard(deck.draw());
+			}
+			positions.push_back(position);
+		}
+		return positions;
+	}
+}
+
+static void BM_GameBotPlayCard(benchmark::State& state)
+{
+	std::vector<Position> positions = makePositions(static_cast<int>(state.range(0)));
+	GameBot bot;
+	int i = 0;
+	for (auto _ : state)
+	{
+		const Position& position = positions[i++ % NUM_OF_POSITIONS];
+		bot.playCard(position.hand, position.board);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBotPlayCard)->Arg(0)->Arg(1)->Arg(2)->Arg(4)->Arg(6)->Arg(8)->Arg(12)->Arg(16);
+
+// the same positions through a decision cache, after the first pass every call is a hit
+static void BM_GameBotPlayCardCached(benchmark::State& state)
+{
+	std::vector<Position> positions = makePositions(static_cast<int>(state.range(0)));
+	DecisionCache cache;
+	GameBot bot(&cache);
+	int i = 0;
+	for (auto _ : state)
+	{
+		const Position& position = positions[i++ % NUM_OF_POSITIONS];
+		bot.playCard(position.hand, position.board);
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_GameBotPlayCardCached)->Arg(0)->Arg(4)->Arg(8)->Arg(16);
+
+static void BM_DeckShuffle(benchmark::State& state)
+{
+	Deck deck(BENCH_SEED);
+	for (auto _ : state)
+	{
+		deck.shuffleDeck();
+		benchmark::DoNotOptimize(deck.getMask());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_DeckShuffle);
+
+static void BM_DeckGenerateDeals(benchmark::State& state)
+{
+	const int numOfDeals = 256;
+	std::vector<uint8_t> deals(numOfDeals * NUM_OF_CARDS);
+	uint64_t stream = 0;
+	for (auto _ : state)
+	{
+		Deck::generateDeals(BENCH_SEED, stream, numOfDeals, deals.data());
+		benchmark::DoNotOptimize(deals.data());
+		stream += numOfDeals;
+	}
+	state.SetItemsProcessed(state.iterations() * numOfDeals);
+}
+BENCHMARK(BM_DeckGenerateDeals);
+
+static void BM_RoundCountPiles(benchmark::State& state)
+{
+	// split the whole deck between the piles, the way it is at the end of a round
+	Round round(P1, BENCH_SEED);
+	Deck deck(BENCH_SEED, 1);
+	for (int i = 0; i < NUM_OF_CARDS; ++i)
+	{
+		if (i % 3 == 0)
+		{
+			round.addToP2Pile(deck.draw());
+		}
+		else
+		{
+			round.addToP1Pile(deck.draw());
+		}
+	}
+	for (auto _ : state)
+	{
+		round.countPiles();
+		benchmark::DoNotOptimize(round.getP1Points());
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_RoundCountPiles);
+
+// a complete round between two greedy bots, from the deal to counting the piles
+static void BM_SimulateRound(benchmark::State& state)
+{
+	GameBot p1Bot;
+	GameBot p2Bot;
+	Bot* bots[2] = { &p1Bot, &p2Bot };
+	SimulationStats stats = {};
+	uint64_t roundNumber = 0;
+	for (auto _ : state)
+	{
+		Round round(P1, BENCH_SEED, roundNumber++);
+		round.firstMiniRound(p1Bot.takeStartCard(round));
+		Simulator::playRound(round, bots, &stats);
+		round.countPiles();
+		benchmark::DoNotOptimize(round.getP1Points());
+	}
+	state.SetItemsProcessed(state.iterations());
+	state.counters["moves/round"] = benchmark::Counter(static_cast<double>(stats.moves) / state.iterations());
+}
+BENCHMARK(BM_SimulateRound);
+
+// the first decision of the last mini-round, rounds played by greedy bots up to there
+static void BM_EndgameSolve(benchmark::State& state)
+{
+	GameBot bot;
+	std::vector<Round> positions;
+	for (int i = 0; i < NUM_OF_POSITIONS; ++i)
+	{
+		Round round(P1, BENCH_SEED, i);
+		round.firstMiniRound(bot.takeStartCard(round));
+		while (!EndgameSolver::canSolve(round))
+		{
+			if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0)
+			{
+				round.giveCardsToPlayers();
+			}
+			if (!EndgameSolver::canSolve(round))
+			{
+				round.makeMove(bot.chooseMove(round));
+			}
+		}
+		positions.push_back(round);
+	}
+	EndgameSolver solver;
+	int i = 0;
+	for (auto _ : state)
+	{
+		benchmark::DoNotOptimize(solver.solve(positions[i++ % NUM_OF_POSITIONS]));
+	}
+	state.SetItemsProcessed(state.iterations());
+}
+BENCHMARK(BM_EndgameSolve);
+
+// end of round piles for many states at once against one at a time, items are states
+static void BM_BatchScoreDiffs(benchmark::State& state)
+{
+	const int numOfStates = static_cast<int>(state.range(0));
+	CounterRng rng(BENCH_SEED);
+	std::vector<CardMask> piles(numOfStates);
+	std::vector<int32_t> sweepDiffs(numOfStates);
+	std::vector<int32_t> diffs(numOfStates);
+	for (int i = 0; i < numOfStates; ++i)
+	{
+		piles[i] = rng() & FULL_DECK_MASK;
+		sweepDiffs[i] = static_cast<int32_t>(rng.below(9)) - 4;
+	}
+	for (auto _ : state)
+	{
+		BatchEval::scoreDiffs(piles.data(), sweepDiffs.data(), numOfStates, diffs.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * numOfStates);
+	state.SetLabel(BatchEval::getInstructionSet());
+}
+BENCHMARK(BM_BatchScoreDiffs)->Arg(64)->Arg(4096);
+
+static void BM_BatchHasCapture(benchmark::State& state)
+{
+	const int numOfStates = static_cast<int>(state.range(0));
+	std::vector<CardMask> hands(numOfStates);
+	std::vector<uint16_t> boardSums(numOfStates);
+	std::vector<uint8_t> captures(numOfStates);
+	std::vector<Position> positions = makePositions(4);
+	for (int i = 0; i < numOfStates; ++i)
+	{
+		const Position& position = positions[i % NUM_OF_POSITIONS];
+		hands[i] = position.hand.getMask();
+		boardSums[i] = position.board.getReachableSums();
+	}
+	for (auto _ : state)
+	{
+		BatchEval::hasCapture(hands.data(), boardSums.data(), numOfStates, captures.data());
+		benchmark::ClobberMemory();
+	}
+	state.SetItemsProcessed(state.iterations() * numOfStates);
+	state.SetLabel(BatchEval::getInstructionSet());
+}
+BENCHMARK(BM_BatchHasCapture)->Arg(64)->Arg(4096);
+
+BENCHMARK_MAIN();
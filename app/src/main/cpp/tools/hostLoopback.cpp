@@ -0,0 +1,226 @@
+// in-process client for MatchHost: plays many concurrent matches through the host's queues with greedy
+// players on both seats, mixing in bad commands (wrong player, illegal move, closed session) that must
+// all be rejected. prints the throughput, exits with 1 if any command got an unexpected answer.
+// usage: shkuba_host [--sessions N] [--matches M] [--threads T] [--seed S] [--inline]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+#include "gameBot.h"
+#include "matchHost.h"
+#include "startCardPolicy.h"
+
+namespace
+{
+	const int BAD_COMMAND_EVERY = 61;	//moves between injected bad commands
+
+	struct Driver
+	{
+		Driver(MatchHost& host, bool inlineHost, int numOfMatches, uint64_t seed) : host(host), inlineHost(inlineHost), matchesToOpen(numOfMatches),
+			seed(seed), nextTag(0), liveMatches(0), moves(0), rounds(0), matches(0), events(0), expectedRejects(0), rejects(0), unexpected(0), gamePoints()
+		{
+		}
+
+		MatchHost& host;
+		bool inlineHost;
+		GameBot bot;
+		std::vector<HostCommand> backlog;	//commands a full queue didn't take yet
+		int matchesToOpen;
+		uint64_t seed;
+		uint64_t nextTag;
+		int liveMatches;	//opened and not closed yet
+		uint64_t moves;
+		uint64_t rounds;
+		uint64_t matches;
+		uint64_t events;
+		uint64_t expectedRejects;
+		uint64_t rejects;
+		uint64_t unexpected;
+		uint64_t gamePoints[2];
+
+		void send(const HostCommand& command)
+		{
+			if (!backlog.empty() || !host.submit(command))
+			{
+				backlog.push_back(command);
+			}
+		}
+
+		void openNext()
+		{
+			if (matchesToOpen > 0)
+			{
+				--matchesToOpen;
+				++liveMatches;
+				send(HostCommand::open(nextTag, mixSeed(seed + nextTag)));
+				++nextTag;
+			}
+		}
+
+		void sendBadCommand(const HostEvent& event)
+		{
+			players turn = static_cast<players>(event.state.turn);
+			CardMask notHeld = FULL_DECK_MASK & ~event.state.hands[turn];
+			switch (moves / BAD_COMMAND_EVERY % 3)
+			{
+			case 0:
+				send(HostCommand::play(event.session, turn == P1 ? P2 : P1, Move(lowestCard(event.state.hands[turn]), EMPTY_MASK)));
+				break;
+			case 1:
+				send(HostCommand::play(event.session, turn, Move(lowestCard(notHeld), EMPTY_MASK)));
+				break;
+			default:
+				send(HostCommand::startRound(event.session, turn, true));	//mid-round
+				break;
+			}
+			++expectedRejects;
+		}
+
+		void onEvent(const HostEvent& event)
+		{
+			++events;
+			const GameSnapshot& state = event.state;
+			switch (event.type)
+			{
+			case EVENT_OPENED:
+			case EVENT_NEW_ROUND:
+			{
+				bool take = StartCardPolicy::shouldTake(Card::fromIndex(state.startCard));	//the Bot default
+				send(HostCommand::startRound(event.session, static_cast<players>(state.firstPlayer), take));
+				break;
+			}
+			case EVENT_MOVE_PLAYED:
+				++moves;
+				if (moves % BAD_COMMAND_EVERY == 0)
+				{
+					sendBadCommand(event);
+				}
+				//fall through
+			case EVENT_ROUND_STARTED:
+			{
+				players turn = static_cast<players>(state.turn);
+				send(HostCommand::play(event.session, turn, bot.chooseMove(Hand(state.hands[turn]), Board(state.board))));
+				break;
+			}
+			case EVENT_ROUND_OVER:
+				++moves;
+				++rounds;
+				break;
+			case EVENT_MATCH_OVER:
+				++moves;
+				++rounds;
+				++matches;
+				gamePoints[P1] += state.gamePoints[P1];
+				gamePoints[P2] += state.gamePoints[P2];
+				send(HostCommand::close(event.session));
+				break;
+			case EVENT_CLOSED:
+				send(HostCommand::play(event.session, P1, Move(0, EMPTY_MASK)));	//the id is stale now
+				++expectedRejects;
+				--liveMatches;
+				openNext();
+				break;
+			case EVENT_REJECTED:
+				++rejects;
+				if (event.reason == REJECT_HOST_FULL || event.reason == REJECT_NONE)
+				{
+					++unexpected;
+					liveMatches -= event.commandType == COMMAND_OPEN ? 1 : 0;
+				}
+				break;
+			default:
+				++unexpected;
+				break;
+			}
+		}
+
+		bool finished() const
+		{
+			return matchesToOpen == 0 && liveMatches == 0 && backlog.empty() && rejects >= expectedRejects;
+		}
+
+		void run()
+		{
+			HostEvent event;
+			while (!finished())
+			{
+				std::size_t sent = 0;
+				while (sent < backlog.size() && host.submit(backlog[sent]))
+				{
+					++sent;
+				}
+				backlog.erase(backlog.begin(), backlog.begin() + sent);
+				if (inlineHost)
+				{
+					host.process();
+				}
+				while (host.pollEvent(event))
+				{
+					onEvent(event);
+				}
+			}
+		}
+	};
+}
+
+int main(int argc, char** argv)
+{
+	int sessions = 4096;
+	int numOfMatches = 20000;
+	int numOfThreads = 0;
+	uint64_t seed = 1;
+	bool inlineHost = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--sessions") == 0 && hasValue)
+		{
+			sessions = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--matches") == 0 && hasValue)
+		{
+			numOfMatches = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--inline") == 0)
+		{
+			inlineHost = true;
+		}
+		else
+		{
+			std::printf("usage: shkuba_host [--sessions N] [--matches M] [--threads T] [--seed S] [--inline]\n");
+			return 1;
+		}
+	}
+
+	MatchHost host(sessions, numOfThreads);
+	Driver driver(host, inlineHost, numOfMatches, seed);
+	if (!inlineHost)
+	{
+		host.start(numOfThreads);
+	}
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int i = 0; i < sessions; ++i)	//every slot busy from the start, a closed match makes room for the next
+	{
+		driver.openNext();
+	}
+	driver.run();
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	host.stop();
+
+	std::printf("%d sessions on %d shards, %llu matches, %llu rounds, %llu moves in %.2f s\n", host.getCapacity(), host.getNumOfShards(),
+		(unsigned long long)driver.matches, (unsigned long long)driver.rounds, (unsigned long long)driver.moves, seconds);
+	std::printf("%.0f moves/s, %.0f events/s\n", driver.moves / seconds, driver.events / seconds);
+	std::printf("rejected %llu of %llu bad commands, %llu unexpected answers\n", (unsigned long long)driver.rejects,
+		(unsigned long long)driver.expectedRejects, (unsigned long long)driver.unexpected);
+	std::printf("game points p1 %llu, p2 %llu\n", (unsigned long long)driver.gamePoints[P1], (unsigned long long)driver.gamePoints[P2]);
+	return driver.unexpected == 0 && driver.rejects == driver.expectedRejects ? 0 : 1;
+}
@@ -0,0 +1,73 @@
+// reads a game record file (logic/gameRecord.h) and replays every round through the engine.
+// usage: shkuba_records FILE [--no-replay]
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include "moveGen.h"
+#include "recordReader.h"
+
+int main(int argc, char** argv)
+{
+	if (argc < 2)
+	{
+		std::printf("usage: shkuba_records FILE [--no-replay]\n");
+		return 1;
+	}
+	bool replay = !(argc > 2 && std::strcmp(argv[2], "--no-replay") == 0);
+	RecordReader reader;
+	if (!reader.open(argv[1]))
+	{
+		std::printf("can't read %s as a record file\n", argv[1]);
+		return 1;
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	uint64_t rounds = 0;
+	uint64_t moves = 0;
+	uint64_t illegal = 0;
+	int64_t pointsDiff = 0;
+	RecordedRound recorded;
+	while (reader.next(recorded))
+	{
+		++rounds;
+		moves += recorded.numOfMoves;
+		if (!replay)
+		{
+			continue;
+		}
+		Round round = recorded.createRound();
+		round.firstMiniRound(recorded.startCardTaken());
+		const uint8_t* in = recorded.moves;
+		for (int i = 0; i < recorded.numOfMoves; ++i)
+		{
+			if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0 && round.getDeckSize() > 0)
+			{
+				round.giveCardsToPlayers();
+			}
+			Move move;
+			if (!RoundRecord::decodeMove(in, recorded.moves + recorded.moveBytes, round.getBoard().getMask(), move) ||
+				!MoveGen::isLegal(round.getHand(round.getTurn()), round.getBoard(), move))
+			{
+				++illegal;
+				break;
+			}
+			round.makeMove(move);
+		}
+		if (round.isRoundOver())
+		{
+			round.collectBoard();
+			RoundScore score = round.scoreCategories();
+			pointsDiff += score.total(P1) - score.total(P2);
+		}
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("%llu rounds, %llu moves, %zu bytes (%.2f bytes per move)\n", (unsigned long long)rounds, (unsigned long long)moves,
+		reader.getSize(), moves ? double(reader.getSize()) / moves : 0.0);
+	std::printf("%s in %.3fs (%.1fM moves/s)\n", replay ? "replayed" : "scanned", seconds, moves / seconds / 1e6);
+	if (replay)
+	{
+		std::printf("illegal or corrupt moves: %llu, first player minus second player points: %lld\n", (unsigned long long)illegal, (long long)pointsDiff);
+	}
+	return illegal == 0 ? 0 : 1;
+}
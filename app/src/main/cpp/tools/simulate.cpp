@@ -0,0 +1,133 @@
+// headless self-play: plays N complete matches between two bots on all cores and prints the totals.
+// usage: shkuba_sim [--bots A B] [--matches N] [--threads T] [--seed S] [--target P] [--record FILE] [--trace FILE]
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "botRegistry.h"
+#include "simulator.h"
+#include "trace.h"
+
+namespace
+{
+	const char* CATEGORY_NAMES[NUM_OF_SCORE_CATEGORIES] = { "cards", "diamonds", "sevens", "7 of diamonds", "sweeps" };
+
+	void printUsage()
+	{
+		std::printf("usage: shkuba_sim [--bots A B] [--matches N] [--threads T] [--seed S] [--target P] [--record FILE] [--trace FILE]\nbots:");
+		std::vector<std::string> usages = BotRegistry::getUsages();
+		for (std::size_t i = 0; i < usages.size(); ++i)
+		{
+			std::printf(" %s", usages[i].c_str());
+		}
+		std::printf("\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	SimulationConfig config = { { "greedy", "random" }, 10000, 0, 1, WINNING_POINTS, "" };
+	const char* tracePath = nullptr;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+		{
+			config.bots[0] = argv[++i];
+			config.bots[1] = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--matches") == 0 && hasValue)
+		{
+			config.numOfMatches = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			config.numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			config.seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--target") == 0 && hasValue)
+		{
+			config.targetPoints = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--record") == 0 && hasValue)
+		{
+			config.recordPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--trace") == 0 && hasValue)
+		{
+			tracePath = argv[++i];
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	for (int bot = 0; bot < 2; ++bot)
+	{
+		if (!BotRegistry::create(config.bots[bot]))
+		{
+			std::printf("%s\n", BotRegistry::getError(config.bots[bot]).c_str());
+			printUsage();
+			return 1;
+		}
+	}
+
+	if (tracePath && !Trace::isCompiledIn())
+	{
+		std::printf("built without SHKUBA_TRACE, --trace records nothing\n");
+	}
+	Trace::setEnabled(tracePath != nullptr);
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	SimulationStats stats = Simulator::run(config);
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	if (stats.matches == 0)
+	{
+		std::printf("no matches played\n");
+		return 1;
+	}
+
+	double matches = static_cast<double>(stats.matches);
+	double rounds = static_cast<double>(stats.rounds);
+	std::printf("%llu matches, %llu rounds, %llu moves in %.2fs (%.0f matches/s)\n",
+		(unsigned long long)stats.matches, (unsigned long long)stats.rounds, (unsigned long long)stats.moves, seconds, matches / seconds);
+	std::printf("rounds per match: %.2f\n", rounds / matches);
+	for (int bot = 0; bot < 2; ++bot)
+	{
+		std::printf("\n%s: win rate %.2f%%, points per match %.2f\n", config.bots[bot].c_str(),
+			100.0 * stats.wins[bot] / matches, stats.matchPoints[bot] / matches);
+		for (int i = 0; i < NUM_OF_SCORE_CATEGORIES; ++i)
+		{
+			std::printf("  %-14s %.3f per round\n", CATEGORY_NAMES[i], stats.categoryPoints[bot][i] / rounds);
+		}
+	}
+
+	if (tracePath)
+	{
+		Trace::setEnabled(false);
+		std::printf("\n%-24s %12s %12s %12s %12s\n", "trace", "count", "total ms", "mean us", "max us");
+		for (const TraceStat& stat : Trace::summary())
+		{
+			if (stat.isCounter)
+			{
+				std::printf("%-24s %12llu %12lld %12.1f %12lld  (counter)\n", stat.name, (unsigned long long)stat.count,
+					(long long)stat.total, double(stat.total) / stat.count, (long long)stat.max);
+			}
+			else
+			{
+				std::printf("%-24s %12llu %12.1f %12.2f %12.1f\n", stat.name, (unsigned long long)stat.count,
+					stat.total / 1e6, stat.total / 1e3 / stat.count, stat.max / 1e3);
+			}
+		}
+		if (!Trace::writeChromeJson(tracePath))
+		{
+			std::printf("can't write %s\n", tracePath);
+			return 1;
+		}
+	}
+	return 0;
+}
@@ -0,0 +1,217 @@
+// simulates the first player's Round::firstMiniRound choice for every start card and writes logic/startCardTable.h,
+// the table StartCardPolicy answers from.
+// usage: shkuba_startcard [--bots FIRST OTHER] [--deals N] [--threads T] [--seed S] [--out FILE]
+// every deal is played twice from the same cards, once taking the start card and once leaving it on the board, so
+// the difference between the choices is measured without the noise of the deal. rebuild the library after --out.
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <vector>
+#include "botRegistry.h"
+#include "simulator.h"
+#include "startCardPolicy.h"
+#include "threadPool.h"
+
+namespace
+{
+	const int DEALS_PER_GRAB = 64;
+	const char SUIT_NAMES[NUM_OF_SUITS + 1] = "SHDC";
+
+	// integer sums, so the table doesn't depend on how the deals were split over the threads
+	struct CardTotals
+	{
+		int64_t take;
+		int64_t leave;
+		int64_t difference;
+		int64_t differenceSquares;
+	};
+
+	// the first player's round point difference (first - other) after the choice
+	int playDeal(Bot* bots[2], const uint8_t* drawOrder, bool take, uint64_t seed, uint64_t deal)
+	{
+		CounterRng botSeeds(seed, deal);
+		bots[P1]->setSeed(botSeeds.at(P1));
+		bots[P2]->setSeed(botSeeds.at(P2));
+		Round round(P1, drawOrder);
+		round.firstMiniRound(take);
+		Simulator::playRound(round, bots, nullptr);
+		RoundScore score = round.scoreCategories();
+		return score.total(P1) - score.total(P2);
+	}
+
+	// the start card, then the other cards shuffled, in the order Round deals them
+	void makeDrawOrder(int startCard, uint64_t seed, uint64_t deal, uint8_t* drawOrder)
+	{
+		drawOrder[0] = static_cast<uint8_t>(startCard);
+		int count = 1;
+		for (int card = 0; card < NUM_OF_CARDS; ++card)
+		{
+			if (card != startCard)
+			{
+				drawOrder[count++] = static_cast<uint8_t>(card);
+			}
+		}
+		CounterRng rng(seed, deal);
+		for (int i = NUM_OF_CARDS - 1; i > 1; --i)
+		{
+			std::swap(drawOrder[i], drawOrder[1 + rng.below(i)]);
+		}
+	}
+
+	bool writeTable(const std::string& path, const std::string& source, const StartCardValue* values)
+	{
+		std::FILE* file = std::fopen(path.c_str(), "w");
+		if (!file)
+		{
+			return false;
+		}
+		std::fprintf(file, "#pragma once\n#include \"startCardPolicy.h\"\n\n"
+			"// generated by tools/startCard.cpp, don't edit. by card index: take, leave, standard error of the difference\n"
+			"constexpr const char* START_CARD_TABLE_SOURCE = \"%s\";\n\n"
+			"constexpr StartCardValue START_CARD_TABLE[NUM_OF_CARDS] =\n{\n", source.c_str());
+		for (int card = 0; card < NUM_OF_CARDS; ++card)
+		{
+			std::fprintf(file, "\t{ %.4ff, %.4ff, %.4ff },\t//%d%c\n", values[card].take, values[card].leave, values[card].error,
+				rankOfIndex(card), SUIT_NAMES[suitOfIndex(card)]);
+		}
+		std::fprintf(file, "};\n");
+		return std::fclose(file) == 0;
+	}
+
+	void printUsage()
+	{
+		std::printf("usage: shkuba_startcard [--bots FIRST OTHER] [--deals N] [--threads T] [--seed S] [--out FILE]\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string botSpecs[2] = { "greedy", "greedy" };
+	int deals = 20000;
+	int numOfThreads = 0;
+	uint64_t seed = 1;
+	std::string outPath;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--bots") == 0 && i + 2 < argc)
+		{
+			botSpecs[0] = argv[++i];
+			botSpecs[1] = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--deals") == 0 && hasValue)
+		{
+			deals = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+		{
+			outPath = argv[++i];
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (deals <= 1)
+	{
+		printUsage();
+		return 1;
+	}
+
+	ThreadPool pool(numOfThreads);
+	std::vector<std::unique_ptr<Bot>> threadBots;
+	for (int i = 0; i < pool.getSize() * 2; ++i)
+	{
+		threadBots.push_back(BotRegistry::create(botSpecs[i % 2]));
+		if (!threadBots.back())
+		{
+			std::printf("%s\n", BotRegistry::getError(botSpecs[i % 2]).c_str());
+			return 1;
+		}
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	std::vector<CardTotals> threadTotals(pool.getSize() * NUM_OF_CARDS, CardTotals());
+	int64_t numOfDeals = static_cast<int64_t>(deals) * NUM_OF_CARDS;
+	std::atomic<int64_t> nextDeal(0);
+	pool.run(pool.getSize(), [&](int thread)
+	{
+		Bot* bots[2] = { threadBots[thread * 2].get(), threadBots[thread * 2 + 1].get() };
+		CardTotals* totals = &threadTotals[thread * NUM_OF_CARDS];
+		uint8_t drawOrder[NUM_OF_CARDS];
+		while (true)
+		{
+			int64_t first = nextDeal.fetch_add(DEALS_PER_GRAB);
+			if (first >= numOfDeals)
+			{
+				return;
+			}
+			for (int64_t deal = first; deal < std::min(first + DEALS_PER_GRAB, numOfDeals); ++deal)
+			{
+				int card = static_cast<int>(deal % NUM_OF_CARDS);
+				makeDrawOrder(card, seed, deal, drawOrder);
+				int take = playDeal(bots, drawOrder, true, seed, deal);
+				int leave = playDeal(bots, drawOrder, false, seed, deal);
+				totals[card].take += take;
+				totals[card].leave += leave;
+				totals[card].difference += take - leave;
+				totals[card].differenceSquares += (take - leave) * (take - leave);
+			}
+		}
+	});
+
+	StartCardValue values[NUM_OF_CARDS];
+	std::printf("card     take    leave  take-leave\n");
+	for (int card = 0; card < NUM_OF_CARDS; ++card)
+	{
+		CardTotals sum = {};
+		for (int thread = 0; thread < pool.getSize(); ++thread)
+		{
+			const CardTotals& totals = threadTotals[thread * NUM_OF_CARDS + card];
+			sum.take += totals.take;
+			sum.leave += totals.leave;
+			sum.difference += totals.difference;
+			sum.differenceSquares += totals.differenceSquares;
+		}
+		double mean = static_cast<double>(sum.difference) / deals;
+		double variance = (static_cast<double>(sum.differenceSquares) - deals * mean * mean) / (deals - 1);
+		values[card].take = static_cast<float>(static_cast<double>(sum.take) / deals);
+		values[card].leave = static_cast<float>(static_cast<double>(sum.leave) / deals);
+		values[card].error = static_cast<float>(std::sqrt(std::max(0.0, variance) / deals));
+		bool take = StartCardPolicy::isClear(values[card]) ? mean > 0 : StartCardPolicy::takeByRule(Card::fromIndex(card));
+		std::printf("%2d%c  %7.3f  %7.3f  %+7.3f +- %.3f  %s%s\n", rankOfIndex(card), SUIT_NAMES[suitOfIndex(card)], values[card].take,
+			values[card].leave, mean, 1.96 * values[card].error, take ? "take" : "leave",
+			StartCardPolicy::isClear(values[card]) ? "" : " (too close, fixed rule)");
+	}
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	std::printf("%lld rounds in %.1fs\n", (long long)(2 * numOfDeals), seconds);
+
+	if (!outPath.empty())
+	{
+		char source[256];
+		std::snprintf(source, sizeof(source), "shkuba_startcard --bots %s %s --deals %d --seed %llu", botSpecs[0].c_str(), botSpecs[1].c_str(),
+			deals, (unsigned long long)seed);
+		if (!writeTable(outPath, source, values))
+		{
+			std::printf("can't write %s\n", outPath.c_str());
+			return 1;
+		}
+		std::printf("table written to %s\n", outPath.c_str());
+	}
+	return 0;
+}
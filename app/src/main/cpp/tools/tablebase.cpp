@@ -0,0 +1,172 @@
+// writes and checks endgame tablebases (logic/endgameTablebase.h).
+// usage: shkuba_tablebase --out FILE [--hand-cards H] [--cards N] [--threads T]
+//        shkuba_tablebase --check FILE [--rounds R] [--seed S]
+// --check plays greedy rounds and compares every position the file covers with EndgameSolver, and the solver's
+// value of every last mini-round with and without the file.
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "endgameSolver.h"
+#include "gameBot.h"
+
+namespace
+{
+	void printUsage()
+	{
+		std::printf("usage: shkuba_tablebase --out FILE [--hand-cards H] [--cards N] [--threads T]\n"
+			"       shkuba_tablebase --check FILE [--rounds R] [--seed S]\n");
+	}
+
+	double secondsSince(std::chrono::steady_clock::time_point start)
+	{
+		return std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+	}
+
+	int check(const std::string& path, int rounds, uint64_t seed)
+	{
+		EndgameTablebase tablebase;
+		if (!tablebase.open(path))
+		{
+			std::printf("can't read %s as a tablebase\n", path.c_str());
+			return 1;
+		}
+		std::printf("%s: up to %d cards in hand and %d in play, %.1f MB mapped\n", path.c_str(), tablebase.getMaxHandCards(),
+			tablebase.getMaxCards(), tablebase.getSize() / 1e6);
+
+		GameBot bot(nullptr);
+		EndgameSolver solver;
+		EndgameSolver withTablebase;
+		withTablebase.setTablebase(&tablebase);
+		uint64_t probes = 0, wrongValues = 0, wrongMoves = 0, solves = 0, wrongSolves = 0;
+		uint64_t nodes = 0, nodesWithTablebase = 0;
+		double probeSeconds = 0, searchSeconds = 0;
+		for (int number = 0; number < rounds; ++number)
+		{
+			Round round(number % 2 == 0 ? P1 : P2, seed, number);
+			round.firstMiniRound(bot.takeStartCard(round));
+			while (!round.isRoundOver())
+			{
+				if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0)
+				{
+					round.giveCardsToPlayers();
+				}
+				if (EndgameSolver::canSolve(round))
+				{
+					int value, valueWithTablebase;
+					solver.solve(round, &value);
+					nodes += solver.getLastNodes();
+					withTablebase.solve(round, &valueWithTablebase);
+					nodesWithTablebase += withTablebase.getLastNodes();
+					++solves;
+					wrongSolves += value != valueWithTablebase ? 1 : 0;
+				}
+				if (tablebase.covers(round))
+				{
+					std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+					int probed = tablebase.probe(round);
+					int moveValue;
+					Move move = tablebase.bestMove(round, &moveValue);
+					probeSeconds += secondsSince(start);
+					start = std::chrono::steady_clock::now();
+					int searched;
+					solver.solve(round, &searched);
+					searchSeconds += secondsSince(start);
+					Round next = round;
+					next.makeMove(move);
+					int afterMove = next.isRoundOver() ? searched : 0;
+					if (!next.isRoundOver())
+					{
+						solver.solve(next, &afterMove);
+						afterMove = -afterMove;
+					}
+					++probes;
+					wrongValues += probed != searched || moveValue != searched ? 1 : 0;
+					wrongMoves += afterMove != searched ? 1 : 0;
+				}
+				round.makeMove(bot.chooseMove(round));
+			}
+		}
+		std::printf("%llu covered positions: %llu wrong values, %llu moves that lose points, %.2f us per probe and best move, %.2f us per solve\n",
+			(unsigned long long)probes, (unsigned long long)wrongValues, (unsigned long long)wrongMoves,
+			probes > 0 ? 1e6 * probeSeconds / probes : 0.0, probes > 0 ? 1e6 * searchSeconds / probes : 0.0);
+		std::printf("%llu last mini-round solves: %llu differ with the tablebase, %.1f nodes a solve without it, %.1f with it\n",
+			(unsigned long long)solves, (unsigned long long)wrongSolves, solves > 0 ? double(nodes) / solves : 0.0,
+			solves > 0 ? double(nodesWithTablebase) / solves : 0.0);
+		return wrongValues + wrongMoves + wrongSolves == 0 ? 0 : 1;
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string outPath;
+	std::string checkPath;
+	int handCards = 2;
+	int cards = 4;
+	int numOfThreads = 0;
+	int rounds = 2000;
+	uint64_t seed = 1;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+		{
+			outPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--check") == 0 && hasValue)
+		{
+			checkPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--hand-cards") == 0 && hasValue)
+		{
+			handCards = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--cards") == 0 && hasValue)
+		{
+			cards = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--rounds") == 0 && hasValue)
+		{
+			rounds = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (outPath.empty() == checkPath.empty())
+	{
+		printUsage();
+		return 1;
+	}
+	if (!checkPath.empty())
+	{
+		return check(checkPath, rounds, seed);
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	if (!EndgameTablebase::generate(outPath, handCards, cards, numOfThreads))
+	{
+		std::printf("can't write %s\n", outPath.c_str());
+		return 1;
+	}
+	EndgameTablebase written;
+	if (!written.open(outPath))
+	{
+		std::printf("can't read back %s\n", outPath.c_str());
+		return 1;
+	}
+	std::printf("%s: up to %d cards in hand and %d in play, %.1f MB in %.1fs\n", outPath.c_str(), written.getMaxHandCards(),
+		written.getMaxCards(), written.getSize() / 1e6, secondsSince(start));
+	return 0;
+}
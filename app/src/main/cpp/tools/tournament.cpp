@@ -0,0 +1,158 @@
+// round robin between bots on mirrored deals, with elo, confidence intervals and an optional SPRT per pairing.
+// usage: shkuba_tournament --bots A B [C ...] [--pairs N] [--batch N] [--threads T] [--seed S] [--target P]
+//                          [--sprt ELO0 ELO1] [--alpha A] [--beta B] [--quiet]
+// e.g. an A/B test that stops as soon as it is clear whether greedy:cached is 5 elo better than greedy:
+//   shkuba_tournament --bots greedy:cached greedy --pairs 1000000 --sprt 0 5
+// or whether weights from shkuba_tune beat the defaults: --bots weighted:tuned.txt greedy
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "botRegistry.h"
+#include "tournament.h"
+
+namespace
+{
+	const char* SPRT_NAMES[] = { "running", "H0 accepted", "H1 accepted" };
+
+	void printUsage()
+	{
+		std::printf("usage: shkuba_tournament --bots A B [C ...] [--pairs N] [--batch N] [--threads T] [--seed S] [--target P]\n"
+			"                         [--sprt ELO0 ELO1] [--alpha A] [--beta B] [--quiet]\nbots:");
+		std::vector<std::string> usages = BotRegistry::getUsages();
+		for (std::size_t i = 0; i < usages.size(); ++i)
+		{
+			std::printf(" %s", usages[i].c_str());
+		}
+		std::printf("\n");
+	}
+
+	void printPairings(const TournamentConfig& config, const TournamentResult& result)
+	{
+		for (const PairingResult& pairing : result.pairings)
+		{
+			double low, high;
+			pairing.getEloInterval(low, high);
+			std::printf("%-16s vs %-16s %9llu pairs  score %6.2f%%  elo %+7.1f [%+7.1f, %+7.1f]  pairs 2-0/1-1/0-2 %llu/%llu/%llu",
+				config.bots[pairing.bots[0]].c_str(), config.bots[pairing.bots[1]].c_str(), (unsigned long long)pairing.pairs,
+				100 * pairing.getScore(), pairing.getElo(), low, high, (unsigned long long)pairing.pairOutcomes[2],
+				(unsigned long long)pairing.pairOutcomes[1], (unsigned long long)pairing.pairOutcomes[0]);
+			if (config.useSprt)
+			{
+				std::printf("  llr %+.2f %s", pairing.llr, SPRT_NAMES[pairing.sprt]);
+			}
+			std::printf("\n");
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	TournamentConfig config = { {}, 10000, 1000, 0, 1, WINNING_POINTS, false, 0, 5, 0.05, 0.05 };
+	bool quiet = false;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--bots") == 0)
+		{
+			while (i + 1 < argc && std::strncmp(argv[i + 1], "--", 2) != 0)
+			{
+				config.bots.push_back(argv[++i]);
+			}
+		}
+		else if (std::strcmp(argv[i], "--pairs") == 0 && hasValue)
+		{
+			config.maxPairs = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--batch") == 0 && hasValue)
+		{
+			config.pairsPerBatch = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			config.numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			config.seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--target") == 0 && hasValue)
+		{
+			config.targetPoints = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--sprt") == 0 && i + 2 < argc)
+		{
+			config.useSprt = true;
+			config.elo0 = std::atof(argv[++i]);
+			config.elo1 = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--alpha") == 0 && hasValue)
+		{
+			config.alpha = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--beta") == 0 && hasValue)
+		{
+			config.beta = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--quiet") == 0)
+		{
+			quiet = true;
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (config.bots.size() < 2 || config.maxPairs <= 0 || (config.useSprt && (config.elo1 <= config.elo0 ||
+		config.alpha <= 0 || config.alpha >= 1 || config.beta <= 0 || config.beta >= 1)))
+	{
+		printUsage();
+		return 1;
+	}
+	for (std::size_t bot = 0; bot < config.bots.size(); ++bot)
+	{
+		if (!BotRegistry::create(config.bots[bot]))
+		{
+			std::printf("%s\n", BotRegistry::getError(config.bots[bot]).c_str());
+			printUsage();
+			return 1;
+		}
+	}
+
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	TournamentResult result = Tournament::run(config, [&](const TournamentResult& soFar)
+	{
+		if (!quiet)
+		{
+			double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+			std::printf("-- %llu matches, %.1fs\n", (unsigned long long)soFar.matches, seconds);
+			printPairings(config, soFar);
+		}
+	});
+	double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+	std::printf("\n%llu matches in %.2fs (%.0f matches/s)\n\n", (unsigned long long)result.matches, seconds, result.matches / seconds);
+	printPairings(config, result);
+	std::printf("\n%-16s %8s %8s %10s\n", "bot", "elo", "score", "matches");
+	for (int bot = 0; bot < static_cast<int>(config.bots.size()); ++bot)
+	{
+		uint64_t won = 0;
+		uint64_t played = 0;
+		for (const PairingResult& pairing : result.pairings)
+		{
+			for (int side = 0; side < 2; ++side)
+			{
+				if (pairing.bots[side] == bot)
+				{
+					won += pairing.stats.wins[side];
+					played += pairing.stats.matches;
+				}
+			}
+		}
+		std::printf("%-16s %+8.1f %7.2f%% %10llu\n", config.bots[bot].c_str(), result.ratings[bot],
+			played > 0 ? 100.0 * won / played : 0.0, (unsigned long long)played);
+	}
+	return 0;
+}
@@ -0,0 +1,300 @@
+// trains the learned evaluator (logic/learnedEval.h) on game records (logic/gameRecord.h).
+// usage: shkuba_train --out MODEL [--epochs E] [--rate R] [--seed S] RECORDS...
+// every move of every recorded round is a sample: the position right after it, seen by the player who made it,
+// and the round point difference that player finished with. a twentieth of the rounds is kept for validation.
+// records from stronger play teach more, e.g. shkuba_sim --bots ismcts:1000 ismcts:1000 --matches 20000 --record games.shkr
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "learnedEval.h"
+#include "moveGen.h"
+#include "recordReader.h"
+
+namespace
+{
+	const int VALIDATION_EVERY = 20;	//rounds, one of them goes to validation
+	const float INIT_FIRST_LAYER = 0.05f;
+	const float INIT_OUTPUT = 0.1f;
+	const float INIT_HIDDEN_BIAS = 0.5f;
+	const float FINAL_RATE_SHARE = 0.1f;	//the rate decays linearly to this share of itself
+	const float MAX_FIRST_LAYER = static_cast<float>(LEARNED_MAX_FIRST_LAYER) / LEARNED_ACTIVATION_ONE;
+
+	float clipFirstLayer(float weight)
+	{
+		return std::max(-MAX_FIRST_LAYER, std::min(MAX_FIRST_LAYER, weight));
+	}
+
+	float uniform(CounterRng& rng)	//in [-1, 1)
+	{
+		return static_cast<float>(rng() >> 40) / (1 << 23) - 1;
+	}
+
+	struct Samples
+	{
+		std::vector<uint16_t> active;
+		std::vector<uint32_t> starts;	//sample i is active[starts[i] .. starts[i + 1])
+		std::vector<float> targets;
+
+		Samples() : starts(1, 0) {}
+		std::size_t size() const { return targets.size(); }
+	};
+
+	struct FloatModel
+	{
+		std::vector<float> w1;
+		float b1[LEARNED_HIDDEN];
+		float w2[LEARNED_HIDDEN];
+		float b2;
+
+		float forward(const uint16_t* active, int count, float* hidden) const
+		{
+			float out = b2;
+			for (int j = 0; j < LEARNED_HIDDEN; ++j)
+			{
+				hidden[j] = b1[j];
+			}
+			for (int i = 0; i < count; ++i)
+			{
+				const float* row = w1.data() + active[i] * LEARNED_HIDDEN;
+				for (int j = 0; j < LEARNED_HIDDEN; ++j)
+				{
+					hidden[j] += row[j];
+				}
+			}
+			for (int j = 0; j < LEARNED_HIDDEN; ++j)
+			{
+				out += std::max(0.0f, std::min(1.0f, hidden[j])) * w2[j];
+			}
+			return out;
+		}
+
+		// one SGD step on the squared error, hidden holds the pre-activations of forward(). the first layer stays
+		// within what the quantized model holds
+		void backward(const uint16_t* active, int count, const float* hidden, float error, float rate)
+		{
+			float gradient[LEARNED_HIDDEN];
+			for (int j = 0; j < LEARNED_HIDDEN; ++j)
+			{
+				bool open = hidden[j] > 0 && hidden[j] < 1;
+				gradient[j] = open ? error * w2[j] : 0;
+				w2[j] -= rate * error * std::max(0.0f, std::min(1.0f, hidden[j]));
+				b1[j] = clipFirstLayer(b1[j] - rate * gradient[j]);
+			}
+			b2 -= rate * error;
+			for (int i = 0; i < count; ++i)
+			{
+				float* row = w1.data() + active[i] * LEARNED_HIDDEN;
+				for (int j = 0; j < LEARNED_HIDDEN; ++j)
+				{
+					row[j] = clipFirstLayer(row[j] - rate * gradient[j]);
+				}
+			}
+		}
+	};
+
+	// replays every round of the file, false if it isn't a record file or holds an illegal or corrupt move
+	bool readSamples(const char* path, Samples& training, Samples& validation, uint64_t& rounds)
+	{
+		RecordReader reader;
+		if (!reader.open(path))
+		{
+			return false;
+		}
+		RecordedRound recorded;
+		std::vector<players> movers;
+		while (reader.next(recorded))
+		{
+			Samples& into = rounds++ % VALIDATION_EVERY == 0 ? validation : training;
+			std::size_t first = into.size();
+			movers.clear();
+			Round round = recorded.createRound();
+			round.firstMiniRound(recorded.startCardTaken());
+			const uint8_t* in = recorded.moves;
+			for (int i = 0; i < recorded.numOfMoves; ++i)
+			{
+				if (round.getHand(P1).getHandSize() == 0 && round.getHand(P2).getHandSize() == 0 && round.getDeckSize() > 0)
+				{
+					round.giveCardsToPlayers();
+				}
+				Move move;
+				if (!RoundRecord::decodeMove(in, recorded.moves + recorded.moveBytes, round.getBoard().getMask(), move) ||
+					!MoveGen::isLegal(round.getHand(round.getTurn()), round.getBoard(), move))
+				{
+					return false;
+				}
+				players mover = round.getTurn();
+				round.makeMove(move);
+				uint16_t active[LEARNED_MAX_ACTIVE];
+				int count = LearnedEval::encode(round, mover, active);
+				into.active.insert(into.active.end(), active, active + count);
+				into.starts.push_back(static_cast<uint32_t>(into.active.size()));
+				into.targets.push_back(0);
+				movers.push_back(mover);
+			}
+			round.collectBoard();
+			RoundScore score = round.scoreCategories();
+			for (std::size_t i = 0; i < movers.size(); ++i)
+			{
+				players mover = movers[i];
+				into.targets[first + i] = static_cast<float>(score.total(mover) - score.total(mover == P1 ? P2 : P1));
+			}
+		}
+		return true;
+	}
+
+	double meanSquaredError(const FloatModel& model, const Samples& samples)
+	{
+		double sum = 0;
+		float hidden[LEARNED_HIDDEN];
+		for (std::size_t i = 0; i < samples.size(); ++i)
+		{
+			float error = model.forward(&samples.active[samples.starts[i]], samples.starts[i + 1] - samples.starts[i], hidden) - samples.targets[i];
+			sum += error * error;
+		}
+		return samples.size() > 0 ? sum / samples.size() : 0;
+	}
+
+	double meanSquaredError(const LearnedEval& model, const Samples& samples)
+	{
+		double sum = 0;
+		for (std::size_t i = 0; i < samples.size(); ++i)
+		{
+			float error = model.evaluate(&samples.active[samples.starts[i]], samples.starts[i + 1] - samples.starts[i]) - samples.targets[i];
+			sum += error * error;
+		}
+		return samples.size() > 0 ? sum / samples.size() : 0;
+	}
+
+	void printUsage()
+	{
+		std::printf("usage: shkuba_train --out MODEL [--epochs E] [--rate R] [--seed S] RECORDS...\n");
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string outPath;
+	int epochs = 10;
+	float rate = 0.005f;
+	uint64_t seed = 1;
+	std::vector<const char*> recordPaths;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+		{
+			outPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--epochs") == 0 && hasValue)
+		{
+			epochs = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--rate") == 0 && hasValue)
+		{
+			rate = static_cast<float>(std::atof(argv[++i]));
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (argv[i][0] != '-')
+		{
+			recordPaths.push_back(argv[i]);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (outPath.empty() || recordPaths.empty() || epochs <= 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	Samples training;
+	Samples validation;
+	uint64_t rounds = 0;
+	for (const char* path : recordPaths)
+	{
+		if (!readSamples(path, training, validation, rounds))
+		{
+			std::printf("can't replay %s as a record file\n", path);
+			return 1;
+		}
+	}
+	if (training.size() == 0)
+	{
+		std::printf("no moves in the records\n");
+		return 1;
+	}
+	double mean = 0;
+	for (float target : training.targets)
+	{
+		mean += target;
+	}
+	mean /= training.size();
+	double baseline = 0;
+	for (float target : validation.targets)
+	{
+		baseline += (target - mean) * (target - mean);
+	}
+	baseline = validation.size() > 0 ? baseline / validation.size() : 0;
+	std::printf("%llu rounds: %zu training and %zu validation positions, %d inputs, %d hidden, %s inference\n",
+		(unsigned long long)rounds, training.size(), validation.size(), LEARNED_INPUTS, LEARNED_HIDDEN, LearnedEval::getInstructionSet());
+	std::printf("validation error of always guessing the mean %.4f\n", baseline);
+
+	CounterRng rng(seed);
+	FloatModel model;
+	model.w1.resize(LEARNED_INPUTS * LEARNED_HIDDEN);
+	for (float& weight : model.w1)
+	{
+		weight = INIT_FIRST_LAYER * uniform(rng);
+	}
+	for (int j = 0; j < LEARNED_HIDDEN; ++j)
+	{
+		model.b1[j] = INIT_HIDDEN_BIAS;
+		model.w2[j] = INIT_OUTPUT * uniform(rng);
+	}
+	model.b2 = static_cast<float>(mean);
+
+	std::vector<uint32_t> order(training.size());
+	for (uint32_t i = 0; i < order.size(); ++i)
+	{
+		order[i] = i;
+	}
+	LearnedEval quantized;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int epoch = 0; epoch < epochs; ++epoch)
+	{
+		std::shuffle(order.begin(), order.end(), rng);
+		float epochRate = rate * (1 - (1 - FINAL_RATE_SHARE) * epoch / epochs);
+		float hidden[LEARNED_HIDDEN];
+		double trainingError = 0;
+		for (uint32_t sample : order)
+		{
+			const uint16_t* active = &training.active[training.starts[sample]];
+			int count = training.starts[sample + 1] - training.starts[sample];
+			float error = model.forward(active, count, hidden) - training.targets[sample];
+			trainingError += error * error;
+			model.backward(active, count, hidden, error, epochRate);
+		}
+		quantized.setWeights(model.w1.data(), model.b1, model.w2, model.b2);
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("epoch %d: training %.4f, validation %.4f (quantized %.4f), %.0fs\n", epoch + 1, trainingError / training.size(),
+			meanSquaredError(model, validation), meanSquaredError(quantized, validation), seconds);
+	}
+
+	if (!quantized.save(outPath))
+	{
+		std::printf("can't write %s\n", outPath.c_str());
+		return 1;
+	}
+	std::printf("model written to %s, play it with learned:%s\n", outPath.c_str(), outPath.c_str());
+	return 0;
+}
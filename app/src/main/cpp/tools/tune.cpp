@@ -0,0 +1,159 @@
+// SPSA self-play tuning of GameBot's evaluation weights (logic/evalWeights.h).
+// usage: shkuba_tune [--params FILE] [--out FILE] [--iterations K] [--pairs N] [--threads T] [--seed S]
+//                    [--rate R] [--step C] [--target P]
+// every iteration perturbs all the weights at once by +-step (relative to their starting size), plays the two
+// perturbed bots against each other on N mirrored deal pairs (Tournament) and moves the weights towards the
+// winner. --out is rewritten after every iteration, so an overnight run can be stopped at any point; check the
+// result with shkuba_tournament --bots weighted:FILE greedy.
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include "botRegistry.h"
+#include "gameBot.h"
+#include "tournament.h"
+
+namespace
+{
+	const double RATE_DECAY = 0.602;	//the usual SPSA gain exponents
+	const double STEP_DECAY = 0.101;
+	const double STABILITY_SHARE = 0.1;	//of the iterations, delays the rate decay
+
+	// the two perturbed weight sets of the current iteration, read by the bots Tournament creates
+	EvalWeights perturbed[2];
+
+	void printUsage()
+	{
+		std::printf("usage: shkuba_tune [--params FILE] [--out FILE] [--iterations K] [--pairs N] [--threads T] [--seed S]\n"
+			"                   [--rate R] [--step C] [--target P]\n");
+	}
+
+	void printWeights(const EvalWeights& weights)
+	{
+		for (int i = 0; i < NUM_OF_FEATURES; ++i)
+		{
+			std::printf("  %-18s %9.3f\n", EvalWeights::featureName(i), weights.weights[i]);
+		}
+	}
+}
+
+int main(int argc, char** argv)
+{
+	std::string paramsPath;
+	std::string outPath = "tuned.txt";
+	int iterations = 1000;
+	TournamentConfig config = { { "spsa:plus", "spsa:minus" }, 500, 500, 0, 1, WINNING_POINTS, false, 0, 0, 0.05, 0.05 };
+	double rate = 4;
+	double step = 0.2;
+	for (int i = 1; i < argc; ++i)
+	{
+		bool hasValue = i + 1 < argc;
+		if (std::strcmp(argv[i], "--params") == 0 && hasValue)
+		{
+			paramsPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--out") == 0 && hasValue)
+		{
+			outPath = argv[++i];
+		}
+		else if (std::strcmp(argv[i], "--iterations") == 0 && hasValue)
+		{
+			iterations = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--pairs") == 0 && hasValue)
+		{
+			config.maxPairs = config.pairsPerBatch = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--threads") == 0 && hasValue)
+		{
+			config.numOfThreads = std::atoi(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--seed") == 0 && hasValue)
+		{
+			config.seed = std::strtoull(argv[++i], nullptr, 10);
+		}
+		else if (std::strcmp(argv[i], "--rate") == 0 && hasValue)
+		{
+			rate = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--step") == 0 && hasValue)
+		{
+			step = std::atof(argv[++i]);
+		}
+		else if (std::strcmp(argv[i], "--target") == 0 && hasValue)
+		{
+			config.targetPoints = std::atoi(argv[++i]);
+		}
+		else
+		{
+			printUsage();
+			return 1;
+		}
+	}
+	if (iterations <= 0 || config.maxPairs <= 0)
+	{
+		printUsage();
+		return 1;
+	}
+
+	EvalWeights weights = EvalWeights::defaults();
+	if (!paramsPath.empty() && !weights.load(paramsPath))
+	{
+		std::printf("can't read %s\n", paramsPath.c_str());
+		return 1;
+	}
+	double steps[NUM_OF_FEATURES];	//per weight, so a sweep bonus of 200 and a drop penalty of 1 both move
+	for (int i = 0; i < NUM_OF_FEATURES; ++i)
+	{
+		steps[i] = step * std::max(std::fabs(weights.weights[i]), 1.0);
+	}
+	BotRegistry::add("spsa", [](const std::string& argument)
+	{
+		return std::unique_ptr<Bot>(new GameBot(nullptr, perturbed[argument == "minus" ? 1 : 0]));
+	}, "spsa[:minus]");
+
+	std::printf("start:\n");
+	printWeights(weights);
+	uint64_t seed = config.seed;
+	double stability = STABILITY_SHARE * iterations;
+	std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+	for (int k = 0; k < iterations; ++k)
+	{
+		double rateK = rate * std::pow((stability + 1) / (stability + k + 1), RATE_DECAY);
+		double stepK = std::pow(k + 1.0, -STEP_DECAY);
+		CounterRng rng(seed, k);
+		int signs[NUM_OF_FEATURES];
+		for (int i = 0; i < NUM_OF_FEATURES; ++i)
+		{
+			signs[i] = (rng() & 1) ? 1 : -1;
+			perturbed[0].weights[i] = weights.weights[i] + stepK * steps[i] * signs[i];
+			perturbed[1].weights[i] = weights.weights[i] - stepK * steps[i] * signs[i];
+		}
+
+		config.seed = mixSeed(seed + k);	//fresh deals every iteration
+		TournamentResult result = Tournament::run(config);
+		double advantage = 2 * result.pairings[0].getScore() - 1;	//of plus over minus, -1..1
+		for (int i = 0; i < NUM_OF_FEATURES; ++i)
+		{
+			weights.weights[i] += rateK * steps[i] * advantage * signs[i];
+		}
+		if (!weights.save(outPath))
+		{
+			std::printf("can't write %s\n", outPath.c_str());
+			return 1;
+		}
+
+		double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		std::printf("iteration %d/%d: plus scored %.2f%% over %llu matches, %.0fs\n", k + 1, iterations,
+			100 * result.pairings[0].getScore(), (unsigned long long)result.matches, seconds);
+		if ((k + 1) % 10 == 0 || k + 1 == iterations)
+		{
+			printWeights(weights);
+		}
+	}
+	std::printf("weights written to %s\n", outPath.c_str());
+	return 0;
+}
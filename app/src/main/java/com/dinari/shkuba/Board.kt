@@ -19,6 +19,9 @@ class Board {
     private external fun nativeCreate(): Long
     private external fun nativeDestroy(handle: Long)
     private external fun getBoardSizeNative(): Int
+    external fun addToBoard(suit: Int, rank: Int)
+    // Suit and rank of every card on the board, flattened: [suit0, rank0, suit1, rank1, ...]
+    external fun getBoard(): IntArray
 
     companion object {
         init {
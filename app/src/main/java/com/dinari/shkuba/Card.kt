@@ -1,30 +1,12 @@
 package com.dinari.shkuba
 
-class NativeCard(suit: Int, rank: Int) {
-    // Native pointer to the C++ Card instance
-    private var nativeHandle: Long = 0
+// A card is one of 40 shared instances identified by its card id (the C++ card index,
+// (rank - 1) * 4 + suit). Suit and rank come from a table read once from the native side,
+// so there is no native object, JNI call or finalizer per card.
+class NativeCard private constructor(val id: Int) {
 
-    init {
-        nativeHandle = nativeCreate(suit, rank)
-    }
-
-    // Secondary constructor for convenience
-    constructor(suit: Suit, rank: Int) : this(suit.ordinal, rank)
-
-    // JNI: Create C++ Card instance
-    private external fun nativeCreate(suit: Int, rank: Int): Long
-
-    // JNI: Clean up C++ Card instance
-    private external fun nativeDestroy(handle: Long)
-
-    // JNI: Get card suit
-    private external fun nativeGetSuit(): Int
-
-    // JNI: Get card rank
-    private external fun nativeGetRank(): Int
-
-    fun getSuit(): Int = nativeGetSuit()
-    fun getRank(): Int = nativeGetRank()
+    fun getSuit(): Int = cardTable[id * 2]
+    fun getRank(): Int = cardTable[id * 2 + 1]
 
     // Helper functions for Kotlin convenience
     fun getSuitEnum(): Suit = Suit.entries[getSuit()]
@@ -34,17 +16,10 @@ class NativeCard(suit: Int, rank: Int) {
     override fun equals(other: Any?): Boolean {
         if (this === other) return true
         if (other !is NativeCard) return false
-        return this.getSuit() == other.getSuit() && this.getRank() == other.getRank()
+        return this.id == other.id
     }
 
-    override fun hashCode(): Int = getSuit() * 31 + getRank()
-
-    protected fun finalize() {
-        if (nativeHandle != 0L) {
-            nativeDestroy(nativeHandle)
-            nativeHandle = 0L
-        }
-    }
+    override fun hashCode(): Int = id
 
     enum class Suit {
         SPADES,   // S = 0
@@ -57,5 +32,21 @@ class NativeCard(suit: Int, rank: Int) {
         init {
             System.loadLibrary("shkuba")
         }
+
+        // JNI: [suit0, rank0, suit1, rank1, ...] for every card id
+        @JvmStatic
+        private external fun nativeCardTable(): IntArray
+
+        private val cardTable: IntArray = nativeCardTable()
+        private val cards: Array<NativeCard> = Array(cardTable.size / 2) { NativeCard(it) }
+
+        val count: Int get() = cards.size
+
+        fun fromId(id: Int): NativeCard = cards[id]
+
+        fun of(suit: Int, rank: Int): NativeCard =
+            cards.first { it.getSuit() == suit && it.getRank() == rank }
+
+        fun of(suit: Suit, rank: Int): NativeCard = of(suit.ordinal, rank)
     }
 }
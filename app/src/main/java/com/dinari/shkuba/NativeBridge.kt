@@ -0,0 +1,249 @@
+package com.dinari.shkuba
+
+import java.nio.ByteBuffer
+import java.nio.ByteOrder
+
+// Receives the bot's move when it finishes thinking. Called on a native worker thread:
+// post to the main thread (e.g. Handler / coroutine dispatcher) before touching UI state or the game.
+fun interface BotMoveListener {
+    fun onBotMove(cardIndex: Int, capturedMask: Long)
+}
+
+// One match held by the native engine (score so far + the round in progress).
+// readState() copies everything the UI needs in a single JNI call into a reused direct buffer,
+// instead of one native call per hand / board / pile getter.
+class NativeGame {
+    // Native pointer to the C++ game instance
+    private var nativeHandle: Long = 0
+
+    private val stateBuffer: ByteBuffer =
+        ByteBuffer.allocateDirect(EngineState.SIZE_BYTES).order(ByteOrder.LITTLE_ENDIAN)
+    private val deltaBuffer: ByteBuffer = ByteBuffer.allocateDirect(StateSync.MAX_DELTA_BYTES)
+
+    init {
+        nativeHandle = nativeCreate()
+    }
+
+    // Deals a new round up to the start card, which readState().startCard then shows. The round starts
+    // once the first player takes it or puts it on the board with chooseStartCard
+    fun dealRound() = nativeDealRound()
+
+    // false unless a dealt round is waiting for the choice
+    fun chooseStartCard(take: Boolean): Boolean = nativeChooseStartCard(take)
+
+    // The bot's choice for the dealt start card, for rounds the bot plays first: chooseStartCard(botTakesStartCard())
+    fun botTakesStartCard(): Boolean = nativeBotTakesStartCard()
+
+    // Plays a card for the player whose turn it is. capturedMask is a card mask of the board cards to take (0 = drop)
+    fun playMove(cardIndex: Int, capturedMask: Long): Boolean = nativePlayMove(cardIndex, capturedMask)
+
+    // Starts the bot thinking for the player whose turn it is, on native threads; returns at once.
+    // timeMs / iterations bound the search (0 = no limit, not both). Starting again, playMove and
+    // dealRound cancel the previous thinking. Either pass a listener or poll pollBotMove().
+    fun startBotThinking(timeMs: Int, iterations: Int = 0, listener: BotMoveListener? = null): Boolean =
+        nativeStartThinking(timeMs, iterations, listener)
+
+    // The finished move (see moveCard / moveCaptured) or NO_MOVE while the bot is still thinking
+    fun pollBotMove(): Long = nativePollBotMove()
+
+    // Stops the search now and returns the best move found so far (NO_MOVE if nothing was started).
+    // Blocks only until the search notices, well under a frame.
+    fun bestBotMoveNow(): Long = nativeBestBotMoveNow()
+
+    // Throws the thinking away, e.g. when the user leaves the screen. The listener is not called.
+    fun cancelBotThinking() = nativeCancelThinking()
+
+    // Appends every round played from now on to a game record file (logic/gameRecord.h), e.g. in filesDir
+    fun recordTo(path: String): Boolean = nativeRecordTo(path)
+
+    // What changed since the last call for viewer's device (0 = P1, 1 = P2), as a few bytes for its StateSync
+    // (logic/stateDelta.h). Only what that player may see: the other hand is always empty in it (its size is the
+    // cards neither placed nor in the deck). The first delta for a viewer, and the first after
+    // resetStateDelta(viewer) (that side lost track), is a full keyframe
+    fun nextStateDelta(viewer: Int): ByteArray? {
+        val size = nativeGetStateDelta(deltaBuffer, viewer)
+        if (size == 0) {
+            return null
+        }
+        val delta = ByteArray(size)
+        deltaBuffer.clear()
+        deltaBuffer.get(delta)
+        return delta
+    }
+
+    fun resetStateDelta(viewer: Int) = nativeResetStateDelta(viewer)
+
+    fun readState(): EngineState? {
+        if (nativeGetGameState(stateBuffer) < EngineState.SIZE_BYTES) {
+            return null
+        }
+        return EngineState.fromBuffer(stateBuffer)
+    }
+
+    // JNI: Create C++ game instance
+    private external fun nativeCreate(): Long
+
+    // JNI: Clean up C++ game instance
+    private external fun nativeDestroy(handle: Long)
+
+    private external fun nativeDealRound()
+    private external fun nativeChooseStartCard(take: Boolean): Boolean
+    private external fun nativeBotTakesStartCard(): Boolean
+    private external fun nativePlayMove(cardIndex: Int, capturedMask: Long): Boolean
+
+    // JNI: Fill the buffer with a GameSnapshot (logic/gameSnapshot.h), returns the bytes written
+    private external fun nativeGetGameState(buffer: ByteBuffer): Int
+
+    private external fun nativeRecordTo(path: String): Boolean
+
+    // JNI: BotThinker (logic/botThinker.h). moves are packed as cardIndex shl 40 or capturedMask
+    private external fun nativeStartThinking(timeMs: Int, iterations: Int, listener: BotMoveListener?): Boolean
+    private external fun nativePollBotMove(): Long
+    private external fun nativeBestBotMoveNow(): Long
+    private external fun nativeCancelThinking()
+
+    // JNI: StateDelta::encode from the viewer's last delta state to now as the viewer sees it, returns the bytes written
+    private external fun nativeGetStateDelta(buffer: ByteBuffer, viewer: Int): Int
+    private external fun nativeResetStateDelta(viewer: Int)
+
+    protected fun finalize() {
+        if (nativeHandle != 0L) {
+            nativeDestroy(nativeHandle)
+            nativeHandle = 0L
+        }
+    }
+
+    companion object {
+        const val NO_MOVE = -1L
+        private const val CARD_SHIFT = 40
+        private const val CAPTURED_MASK = (1L shl CARD_SHIFT) - 1
+
+        fun moveCard(move: Long): Int = (move ushr CARD_SHIFT).toInt()
+        fun moveCaptured(move: Long): Long = move and CAPTURED_MASK
+
+        init {
+            System.loadLibrary("shkuba")
+        }
+    }
+}
+
+// Kotlin view of GameSnapshot. Cards are card masks: bit (rank - 1) * 4 + suit.
+class EngineState(
+    val turn: Int,
+    val firstPlayer: Int,
+    val deckSize: Int,
+    val startCard: Int, // -1 once it was dealt
+    val hands: LongArray,
+    val board: Long,
+    val piles: LongArray,
+    val gamePoints: IntArray,
+    val roundPoints: Array<IntArray> // [player][cards, diamonds, sevens, 7 of diamonds, sweeps]
+) {
+    companion object {
+        const val SIZE_BYTES = 96
+        private const val SCORE_CATEGORIES = 5
+
+        fun fromBuffer(buffer: ByteBuffer): EngineState {
+            val startCard = buffer.get(7).toInt() and 0xFF
+            return EngineState(
+                turn = buffer.get(4).toInt(),
+                firstPlayer = buffer.get(5).toInt(),
+                deckSize = buffer.get(6).toInt(),
+                startCard = if (startCard == 0xFF) -1 else startCard,
+                hands = longArrayOf(buffer.getLong(8), buffer.getLong(16)),
+                board = buffer.getLong(24),
+                piles = longArrayOf(buffer.getLong(32), buffer.getLong(40)),
+                gamePoints = intArrayOf(buffer.getInt(48), buffer.getInt(52)),
+                roundPoints = Array(2) { player ->
+                    IntArray(SCORE_CATEGORIES) { i -> buffer.getInt(56 + (player * SCORE_CATEGORIES + i) * 4) }
+                }
+            )
+        }
+    }
+}
+
+// The receiving side of NativeGame.nextStateDelta(player of this device): the other device's state as this player
+// sees it, kept up to date by applying its deltas in order. apply() returns false and changes nothing if a delta
+// doesn't fit the state it holds (one was lost or corrupted): reset() and ask the sender for a keyframe.
+class StateSync {
+    private val stateBuffer: ByteBuffer =
+        ByteBuffer.allocateDirect(EngineState.SIZE_BYTES).order(ByteOrder.LITTLE_ENDIAN)
+    private val deltaBuffer: ByteBuffer = ByteBuffer.allocateDirect(MAX_DELTA_BYTES)
+
+    init {
+        nativeResetState(stateBuffer)
+    }
+
+    fun apply(delta: ByteArray): Boolean {
+        if (delta.size > MAX_DELTA_BYTES) {
+            return false
+        }
+        deltaBuffer.clear()
+        deltaBuffer.put(delta)
+        return nativeApplyDelta(stateBuffer, deltaBuffer, delta.size)
+    }
+
+    fun reset() = nativeResetState(stateBuffer)
+
+    fun state(): EngineState = EngineState.fromBuffer(stateBuffer)
+
+    companion object {
+        const val MAX_DELTA_BYTES = 160
+
+        init {
+            System.loadLibrary("shkuba")
+        }
+
+        // JNI: StateDelta::apply on the GameSnapshot bytes in state
+        @JvmStatic
+        private external fun nativeApplyDelta(state: ByteBuffer, delta: ByteBuffer, size: Int): Boolean
+
+        @JvmStatic
+        private external fun nativeResetState(state: ByteBuffer)
+    }
+}
+
+// Totals of one traced name since the last clear. Timers are in nanoseconds; for a counter
+// total is the sum of the values it was given and max the largest one
+data class TraceStat(val name: String, val isCounter: Boolean, val count: Long, val total: Long, val max: Long)
+
+// The engine's built-in timers and counters (logic/trace.h): bot decisions, search sizes, shuffles and
+// the JNI entry points. Off until enabled; cheap enough to switch on for a user reporting slow turns.
+object EngineTrace {
+    init {
+        System.loadLibrary("shkuba")
+    }
+
+    // false when the library was built without SHKUBA_TRACE, nothing is recorded then
+    val isAvailable: Boolean
+        get() = nativeIsCompiledIn()
+
+    fun setEnabled(enabled: Boolean) = nativeSetEnabled(enabled)
+
+    fun clear() = nativeClear()
+
+    // Per name over all threads, timers by total time first
+    fun summary(): List<TraceStat> =
+        nativeSummary().lineSequence().filter { it.isNotEmpty() }.map { line ->
+            val fields = line.split('\t')
+            TraceStat(fields[0], fields[1] == "C", fields[2].toLong(), fields[3].toLong(), fields[4].toLong())
+        }.toList()
+
+    // The last events of every thread as Chrome trace JSON, open in ui.perfetto.dev or chrome://tracing
+    fun writeChromeTrace(path: String): Boolean = nativeWriteChromeTrace(path)
+
+    @JvmStatic
+    private external fun nativeIsCompiledIn(): Boolean
+
+    @JvmStatic
+    private external fun nativeSetEnabled(enabled: Boolean)
+
+    @JvmStatic
+    private external fun nativeClear()
+
+    @JvmStatic
+    private external fun nativeSummary(): String
+
+    @JvmStatic
+    private external fun nativeWriteChromeTrace(path: String): Boolean
+}
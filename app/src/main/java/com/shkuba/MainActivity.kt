@@ -47,7 +47,7 @@ class MainActivity : ComponentActivity() {
         enableEdgeToEdge()
         setContent {
             val isDarkMode = remember { mutableStateOf(false) }
-            val board = Board()
+            val board = remember { Board() }
             val localeState = remember { mutableStateOf(Locale.getDefault()) }
             val context = LocalContext.current
             val config = Configuration(context.resources.configuration)